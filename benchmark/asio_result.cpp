@@ -0,0 +1,128 @@
+/* Benchmark of the as_result ASIO completion token against the exception throwing use_awaitable token
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/>
+File Created: Mar 2019
+
+Build with something like:
+
+  g++ -std=c++20 -O2 -I../include -o asio_result asio_result.cpp -lpthread
+
+Usage: asio_result [round trips=100000]
+
+Runs a coroutine client and server over a loopback TCP socket. Each round trip writes a small message
+and reads the echo, once with use_awaitable and once with as_result(use_awaitable). The error path then
+repeatedly reads from the closed client socket, which completes with bad_descriptor, so use_awaitable
+must throw and catch an exception each time where as_result returns a result. Outputs a CSV of path,
+token, operations per second and nanoseconds per operation.
+*/
+
+#include <utility>  // some Boost.ASIO awaitable.hpp use std::exchange without including this
+
+#include <boost/asio.hpp>
+
+#include "../include/outcome/asio_result.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+namespace asio = boost::asio;
+namespace outcome = OUTCOME_V2_NAMESPACE;
+using asio::ip::tcp;
+
+static size_t sink;
+
+struct use_exceptions
+{
+  static constexpr const char *name = "use_awaitable";
+  template <class AsyncOp> static asio::awaitable<size_t> io(AsyncOp op)
+  {
+    try
+    {
+      co_return co_await op(asio::use_awaitable);
+    }
+    catch(const boost::system::system_error &)
+    {
+      co_return 0;
+    }
+  }
+};
+struct use_result
+{
+  static constexpr const char *name = "as_result(use_awaitable)";
+  template <class AsyncOp> static asio::awaitable<size_t> io(AsyncOp op)
+  {
+    outcome::asio_result<size_t> r = co_await op(outcome::as_result(asio::use_awaitable));
+    co_return r ? r.value() : 0;
+  }
+};
+
+template <class Token> asio::awaitable<void> echo(tcp::socket s)
+{
+  char buffer[64];
+  for(;;)
+  {
+    size_t bytes = co_await Token::io([&](auto &&token) { return s.async_read_some(asio::buffer(buffer), token); });
+    if(bytes == 0)
+    {
+      co_return;
+    }
+    co_await Token::io([&](auto &&token) { return asio::async_write(s, asio::buffer(buffer, bytes), token); });
+  }
+}
+
+template <class Token> asio::awaitable<void> client(tcp::socket s, size_t iterations, double &success_ns, double &failure_ns)
+{
+  char buffer[64] = "hello world";
+  auto begin = std::chrono::high_resolution_clock::now();
+  for(size_t n = 0; n < iterations; n++)
+  {
+    co_await Token::io([&](auto &&token) { return asio::async_write(s, asio::buffer(buffer, 16), token); });
+    sink += co_await Token::io([&](auto &&token) { return asio::async_read(s, asio::buffer(buffer, 16), token); });
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  success_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) / iterations;
+  // Closing our socket ends the echo, after which every read fails with bad_descriptor
+  s.close();
+  begin = std::chrono::high_resolution_clock::now();
+  for(size_t n = 0; n < iterations; n++)
+  {
+    sink += co_await Token::io([&](auto &&token) { return s.async_read_some(asio::buffer(buffer), token); });
+  }
+  end = std::chrono::high_resolution_clock::now();
+  failure_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) / iterations;
+}
+
+template <class Token> static void benchmark(size_t iterations)
+{
+  asio::io_context ctx(1);
+  tcp::acceptor acceptor(ctx, tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+  tcp::socket a(ctx), b(ctx);
+  b.connect(acceptor.local_endpoint());
+  acceptor.accept(a);
+  a.set_option(tcp::no_delay(true));
+  b.set_option(tcp::no_delay(true));
+  double success_ns = 0, failure_ns = 0;
+  asio::co_spawn(ctx, echo<Token>(std::move(a)), asio::detached);
+  asio::co_spawn(ctx, client<Token>(std::move(b), iterations, success_ns, failure_ns), asio::detached);
+  ctx.run();
+  printf("\"success\",\"%s\",%f,%f\n", Token::name, 1000000000.0 / success_ns, success_ns);
+  printf("\"failure\",\"%s\",%f,%f\n", Token::name, 1000000000.0 / failure_ns, failure_ns);
+  fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+  const size_t iterations = (argc > 1) ? static_cast<size_t>(atoll(argv[1])) : 100000;
+  printf("\"Path\",\"Token\",\"Operations/sec\",\"ns/operation\"\n");
+  benchmark<use_exceptions>(iterations);
+  benchmark<use_result>(iterations);
+  return 0;
+}
+#else
+int main()
+{
+  fprintf(stderr, "This benchmark requires an ASIO with C++ Coroutines support\n");
+  return 1;
+}
+#endif
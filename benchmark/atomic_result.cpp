@@ -0,0 +1,131 @@
+/* Benchmark of atomic_result against the usual ways of publishing a result to many readers
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/>
+File Created: Mar 2019
+
+Build with something like:
+
+  g++ -std=c++17 -O2 -I../include -o atomic_result atomic_result.cpp -lpthread
+
+Usage: atomic_result [loads=10000000] [readers=2]
+
+Reader threads repeatedly load a published result<int, errc> while a writer thread replaces it
+every few microseconds, as a cached health probe outcome is. The result is published behind a
+mutex, through std::atomic_load() of a std::shared_ptr, through a lock free atomic_result, and
+through an atomic_result<int, error_code>, which is too big to be lock free and so uses a sequence
+lock. Outputs a CSV of method, readers, and nanoseconds per load.
+*/
+
+#include "../include/outcome/atomic_result.hpp"
+#include "../include/outcome/result.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+using result_type = outcome::result<int, std::errc>;
+
+volatile int sink;
+
+class mutex_published
+{
+  mutable std::mutex _lock;
+  result_type _r{0};
+
+public:
+  result_type load() const
+  {
+    std::lock_guard<std::mutex> g(_lock);
+    return _r;
+  }
+  void store(result_type r)
+  {
+    std::lock_guard<std::mutex> g(_lock);
+    _r = r;
+  }
+};
+
+class shared_ptr_published
+{
+  std::shared_ptr<const result_type> _r{std::make_shared<const result_type>(0)};
+
+public:
+  result_type load() const { return *std::atomic_load(&_r); }
+  void store(result_type r) { std::atomic_store(&_r, std::make_shared<const result_type>(r)); }
+};
+
+template <class R> class atomic_published
+{
+  outcome::atomic_result<int, R> _r{0};
+
+public:
+  result_type load() const
+  {
+    auto r = _r.load();
+    return r ? result_type(r.value()) : result_type(std::errc::io_error);
+  }
+  void store(result_type r) { _r.store(r ? outcome::result<int, R>(r.value()) : outcome::result<int, R>(std::make_error_code(r.error()))); }
+};
+template <> class atomic_published<std::errc>
+{
+  outcome::atomic_result<int, std::errc> _r{result_type(0)};
+
+public:
+  result_type load() const { return _r.load(); }
+  void store(result_type r) { _r.store(r); }
+};
+
+template <class Published> static void benchmark(const char *method, size_t loads, unsigned readers)
+{
+  Published p;
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    for(int n = 0; !done.load(std::memory_order_relaxed); n++)
+    {
+      p.store((n % 7 == 0) ? result_type(std::errc::io_error) : result_type(n));
+      std::this_thread::sleep_for(std::chrono::microseconds(5));
+    }
+  });
+  std::vector<std::thread> threads;
+  const auto begin = std::chrono::steady_clock::now();
+  for(unsigned n = 0; n < readers; n++)
+  {
+    threads.emplace_back([&] {
+      int total = 0;
+      for(size_t i = 0; i < loads / readers; i++)
+      {
+        auto r = p.load();
+        total += r ? r.value() : 1;
+      }
+      sink = sink + total;
+    });
+  }
+  for(auto &t : threads)
+  {
+    t.join();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  done = true;
+  writer.join();
+  const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+  printf("\"%s\",%u,%f\n", method, readers, ns / static_cast<double>(loads));
+  fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+  const size_t loads = (argc > 1) ? static_cast<size_t>(atoll(argv[1])) : 10000000;
+  const unsigned readers = (argc > 2) ? static_cast<unsigned>(atoi(argv[2])) : 2;
+  printf("\"Method\",\"Readers\",\"ns/load\"\n");
+  benchmark<mutex_published>("std::mutex", loads, readers);
+  benchmark<shared_ptr_published>("std::atomic_load(std::shared_ptr)", loads, readers);
+  benchmark<atomic_published<std::errc>>("atomic_result<int, errc>", loads, readers);
+  benchmark<atomic_published<std::error_code>>("atomic_result<int, error_code>", loads, readers);
+  return 0;
+}
@@ -8,6 +8,8 @@ import sys, os, subprocess, shlex, time
 
 class ErrorHandlingSystem(object):
     "Base class for an error handling system"
+    # The failure ratios to run the generated executable with
+    failure_ratios = [0]
 
     def __init__(self):
         pass
@@ -50,12 +52,26 @@ struct RAII { RAII() { ++counter; } ~RAII() { --counter; } };
             oh.write("#define FUNCTION funct%04d\n" % (no-1))
             oh.write("#define NESTING %d\n" % (no))
 
+# The -mixed strategies fail in the innermost function for the given ratio of calls, at random positions
+FAILURE_RATIOS = [0.001, 0.01, 0.05]
+
+class IntegerMixed(ErrorHandlingSystem):
+    failure_ratios = FAILURE_RATIOS
+    def function_final(self):
+        return r'''{ return par < 0 ? -1 : 0; }'''
+
 class ExceptionThrow(ErrorHandlingSystem):
+    failure_ratios = [1]
     def preamble(self, idx):
         return '#include <exception>\n' if idx == 0 else ''
     def function_final(self):
         return r'''{ throw std::exception(); }'''
 
+class ExceptionMixed(ExceptionThrow):
+    failure_ratios = FAILURE_RATIOS
+    def function_final(self):
+        return r'''{ if(par < 0) throw std::exception(); return 0; }'''
+
 class ResultErrorValue(ErrorHandlingSystem):
     def preamble(self, idx):
         return '#include "../include/outcome/result.hpp"\n'
@@ -65,9 +81,15 @@ class ResultErrorValue(ErrorHandlingSystem):
         return r'''{ return par; }'''
 
 class ResultErrorError(ResultErrorValue):
+    failure_ratios = [1]
     def function_final(self):
         return r'''{ return std::error_code(5, std::generic_category()); }'''
 
+class ResultErrorMixed(ResultErrorValue):
+    failure_ratios = FAILURE_RATIOS
+    def function_final(self):
+        return r'''{ if(par < 0) return std::error_code(5, std::generic_category()); return par; }'''
+
 class ResultExceptionValue(ResultErrorValue):
     def function_cont(self, name):
         return 'extern OUTCOME_V2_NAMESPACE::result<int, std::exception_ptr> %s(int par)' % name
@@ -75,10 +97,16 @@ class ResultExceptionValue(ResultErrorValue):
         return r'''{ return par; }'''
         
 class ResultExceptionError(ResultExceptionValue):
+    failure_ratios = [1]
     def function_cont(self, name):
         return 'extern OUTCOME_V2_NAMESPACE::result<int, std::exception_ptr> %s(int par)' % name
     def function_final(self):
         return r'''{ return std::make_exception_ptr(std::exception()); }'''
+
+class ResultExceptionMixed(ResultExceptionValue):
+    failure_ratios = FAILURE_RATIOS
+    def function_final(self):
+        return r'''{ if(par < 0) return std::make_exception_ptr(std::exception()); return par; }'''
         
 class ResultExperimentalValue(ErrorHandlingSystem):
     def preamble(self, idx):
@@ -89,20 +117,62 @@ class ResultExperimentalValue(ErrorHandlingSystem):
         return r'''{ return par; }'''
 
 class ResultExperimentalError(ResultExperimentalValue):
+    failure_ratios = [1]
     def function_final(self):
         return r'''{ return OUTCOME_V2_NAMESPACE::experimental::errc::io_error; }'''
 
+class ResultExperimentalMixed(ResultExperimentalValue):
+    failure_ratios = FAILURE_RATIOS
+    def function_final(self):
+        return r'''{ if(par < 0) return OUTCOME_V2_NAMESPACE::experimental::errc::io_error; return par; }'''
+
 matrix = [
     ('integer-returns', ErrorHandlingSystem),
+    ('integer-mixed', IntegerMixed),
     ('exception-throw', ExceptionThrow),
+    ('exception-mixed', ExceptionMixed),
     ('result-error-value', ResultErrorValue),
     ('result-error-error', ResultErrorError),
+    ('result-error-mixed', ResultErrorMixed),
     ('result-excpt-value', ResultExceptionValue),
     ('result-excpt-error', ResultExceptionError),
+    ('result-excpt-mixed', ResultExceptionMixed),
     ('result-exper-value', ResultExperimentalValue),
     ('result-exper-error', ResultExperimentalError),
+    ('result-exper-mixed', ResultExperimentalMixed),
 ]
 
+def which(program):
+    "Returns the path of program if it is on the PATH"
+    for path in os.environ.get('PATH', '').split(os.pathsep):
+        candidate = os.path.join(path, program)
+        if os.path.isfile(candidate) and os.access(candidate, os.X_OK):
+            return candidate
+    return None
+
+def installed_linux_compilers():
+    "Returns a (name, command) for every distinct GCC and Clang installed"
+    ret = []
+    seen = set()
+    for family, driver, flavour in [('gcc', 'g++', 'gcc'), ('clang', 'clang++', 'clang')]:
+        for suffix in [''] + ['-%d' % v for v in range(20, 6, -1)]:
+            path = which(driver + suffix)
+            if path is None:
+                continue
+            try:
+                version = subprocess.check_output([path, '-dumpfullversion', '-dumpversion']).decode('utf-8').strip()
+            except subprocess.CalledProcessError:
+                continue
+            if (family, version) in seen:
+                continue
+            seen.add((family, version))
+            name = flavour + ''.join(version.split('.')[0:2])
+            base = driver + suffix + ' -std=c++17 -O3 -g -o %s -I../..'
+            ret.append((name + '-noexcept', base.replace('-O3', '-fno-exceptions -O3')))
+            ret.append((name, base))
+            ret.append((name + '-lto', base.replace('-O3', '-O3 -flto')))
+    return ret
+
 if sys.platform == 'win32':
     compilers = [
         ('msvc1916-noexcept', r'cl /nologo /std:c++17 /O2 /Gy /MD /Fe%s /I..\\..'),
@@ -114,67 +184,79 @@ elif sys.platform == 'darwin':
         ('xcode82', r'clang++ -std=c++14 -O3 -g -o %s'),
     ]
 else:
-    compilers = [
-        ('gcc74-noexcept', r'g++-7 -std=c++17 -fno-exceptions -O3 -g -o %s -I../..'),
-        ('gcc74', r'g++-7 -std=c++17 -O3 -g -o %s -I../..'),
-        ('gcc74-lto', r'g++-7 -std=c++17 -O3 -g -flto -o %s -I../..'),
-        ('clang80', r'clang++-8 -std=c++17 -O3 -g -o %s -I../..'),
-        #('clang80-lto', r'clang++-8 -std=c++17 -O3 -g -flto -o %s'),  not working yet
-    ]
+    compilers = installed_linux_compilers()
+
+# Each command line argument is a nesting depth to benchmark
+NESTINGS = [int(arg) for arg in sys.argv[1:]] or [10]
+
+# Sections whose size is reported for each executable, where the toolchain can tell us
+SECTIONS = ['.text', '.eh_frame', '.gcc_except_table']
 
-SOURCES=10
-if len(sys.argv)>1:
-    SOURCES = int(sys.argv[1])
+def section_sizes(exename):
+    "Returns the size in bytes of each of SECTIONS in exename, or None if unknown"
+    sizes = dict((section, 0) for section in SECTIONS)
+    try:
+        output = subprocess.check_output(['size', '-A', '-d', exename]).decode('utf-8')
+    except (OSError, subprocess.CalledProcessError):
+        return dict((section, None) for section in SECTIONS)
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0] in sizes:
+            sizes[fields[0]] = int(fields[1])
+    return sizes
+
+timer = getattr(time, 'perf_counter', time.time)
 
 with open('results-'+sys.platform+'.csv', 'wt') as resultsh:
-    resultsh.write('"Compiler"')
-    for m in matrix:
-        resultsh.write(',"'+m[0]+'"')
+    resultsh.write('"Compiler","Strategy","Nesting","Failure ratio","Mean ticks","p50 ticks","p99 ticks","p99.9 ticks"')
+    for section in SECTIONS:
+        resultsh.write(',"%s bytes"' % section)
     resultsh.write('\n')
-    for compiler in compilers:
-        resultsh.write('"'+compiler[0]+'"')
-        for m in matrix:
-            if 'noexcept' in compiler[0] and m[0] == 'exception-throw':
-                resultsh.write(',')
-                continue
-            instance = m[1]()
-            try:
-                exename = m[0]+'_'+compiler[0]
-                print("\nGenerating sources for", exename, "...")
-                instance.generate_sources(SOURCES)
-                args = shlex.split(compiler[1] % exename)
-                args.append("runner.cpp")
-                for n in range(0, SOURCES):
-                    args.append("source%04d.cpp" % n)
-                if sys.platform == 'win32':
-                    args.append("/link")
-                    args.append("/OPT:REF,ICF")
-                #print(' '.join(args))
+    for SOURCES in NESTINGS:
+        for compiler in compilers:
+            for m in matrix:
+                if 'noexcept' in compiler[0] and m[0].startswith('exception-'):
+                    continue
+                instance = m[1]()
                 try:
-                    print("Compiling", exename, "...")
-                    compile_begin = time.clock()
-                    print(subprocess.check_output(args))
-                    compile_end = time.clock()
-                    print("Compile took", compile_end-compile_begin, "secs. Running executable ...")
-                except subprocess.CalledProcessError as e:
-                    print(e.output)
-                    raise
-            finally:
-                for n in range(0, SOURCES):
-                    if os.path.exists("source%04d.cpp" % n):
-                        os.remove("source%04d.cpp" % n)
-                    if os.path.exists("source%04d.obj" % n):
-                        os.remove("source%04d.obj" % n)
-                os.remove("function.h")
-                #if os.path.exists(exename):
-                #    os.remove(exename)
-                #if os.path.exists(exename+'.exe'):
-                #    os.remove(exename+'.exe')
-                if os.path.exists("runner.obj"):
-                    os.remove("runner.obj")
-            if sys.platform != 'win32':
-                exename = './' + exename
-            result = subprocess.check_output([exename])
-            resultsh.write(',' + result.rstrip())
-            resultsh.flush()
-        resultsh.write('\n')
+                    exename = m[0]+'_'+compiler[0]
+                    print("\nGenerating sources for", exename, "...")
+                    instance.generate_sources(SOURCES)
+                    args = shlex.split(compiler[1] % exename)
+                    args.append("runner.cpp")
+                    for n in range(0, SOURCES):
+                        args.append("source%04d.cpp" % n)
+                    if sys.platform == 'win32':
+                        args.append("/link")
+                        args.append("/OPT:REF,ICF")
+                    #print(' '.join(args))
+                    try:
+                        print("Compiling", exename, "...")
+                        compile_begin = timer()
+                        print(subprocess.check_output(args).decode('utf-8'))
+                        compile_end = timer()
+                        print("Compile took", compile_end-compile_begin, "secs. Running executable ...")
+                    except subprocess.CalledProcessError as e:
+                        print(e.output)
+                        raise
+                finally:
+                    for n in range(0, SOURCES):
+                        if os.path.exists("source%04d.cpp" % n):
+                            os.remove("source%04d.cpp" % n)
+                        if os.path.exists("source%04d.obj" % n):
+                            os.remove("source%04d.obj" % n)
+                    os.remove("function.h")
+                    #if os.path.exists(exename):
+                    #    os.remove(exename)
+                    #if os.path.exists(exename+'.exe'):
+                    #    os.remove(exename+'.exe')
+                    if os.path.exists("runner.obj"):
+                        os.remove("runner.obj")
+                if sys.platform != 'win32':
+                    exename = './' + exename
+                sizes = section_sizes(exename)
+                sizes = ''.join(',' + ('' if sizes[section] is None else str(sizes[section])) for section in SECTIONS)
+                for ratio in instance.failure_ratios:
+                    result = subprocess.check_output([exename, str(ratio)]).decode('utf-8')
+                    resultsh.write('"%s","%s",%d,%s,%s%s\n' % (compiler[0], m[0], SOURCES, ratio, result.rstrip(), sizes))
+                    resultsh.flush()
@@ -0,0 +1,110 @@
+#!/usr/bin/python
+# Benchmark build time and peak memory of #include "outcome.hpp" against import outcome_v2_0
+# (C) 2019 Niall Douglas http://www.nedproductions.biz/
+# Created: Mar 2019
+#
+# Usage: compile_time.py [compiler=g++] [translation units=100]
+# Needs GCC 14 or later, or clang 16 or later for the import mode.
+
+from __future__ import print_function
+import sys, os, subprocess, shutil, time
+
+INCLUDE_DIR = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', 'include'))
+MODULE_NAME = 'outcome_v2_0'
+SCRATCH = 'compile_time'
+
+def source(idx):
+    "A translation unit of the kind which typically uses Outcome"
+    return r'''#include "outcome.hpp"
+#include <string>
+namespace outcome = OUTCOME_V2_NAMESPACE;
+outcome::result<int> parse%(idx)04d(const std::string &s)
+{
+  if(s.empty())
+    return std::errc::invalid_argument;
+  return (int) s.size();
+}
+outcome::result<std::string> twice%(idx)04d(const std::string &s)
+{
+  OUTCOME_TRY(n, parse%(idx)04d(s));
+  return std::string(2 * n, 'x');
+}
+''' % {'idx': idx}
+
+class Mode(object):
+    "Base class for a way of consuming Outcome"
+    name = ''
+    def __init__(self, compiler):
+        self.compiler = compiler
+        self.is_clang = 'clang' in os.path.basename(compiler)
+    def flags(self):
+        return ['-std=c++20', '-O2', '-I', INCLUDE_DIR]
+    def prepare(self):
+        "Commands run once before compiling the translation units"
+        return []
+
+class Include(Mode):
+    name = 'include'
+
+class Import(Mode):
+    name = 'import'
+    def bmi(self):
+        return os.path.abspath(MODULE_NAME + ('.pcm' if self.is_clang else '.gcm'))
+    def flags(self):
+        if self.is_clang:
+            return Mode.flags(self) + ['-DOUTCOME_ENABLE_CXX_MODULES=1', '-fmodule-file=%s=%s' % (MODULE_NAME, self.bmi())]
+        return Mode.flags(self) + ['-DOUTCOME_ENABLE_CXX_MODULES=1', '-fmodules-ts', '-fmodule-mapper=' + os.path.abspath('mapper.txt')]
+    def prepare(self):
+        interface = os.path.join(INCLUDE_DIR, 'outcome.ixx')
+        base = ['-std=c++20', '-O2', '-I', INCLUDE_DIR]
+        if self.is_clang:
+            return [[self.compiler] + base + ['--precompile', '-x', 'c++-module', interface, '-o', self.bmi()],
+                    [self.compiler, '-O2', '-c', self.bmi(), '-o', MODULE_NAME + '.o']]
+        with open('mapper.txt', 'wt') as oh:
+            oh.write('%s %s\n' % (MODULE_NAME, self.bmi()))
+        return [[self.compiler] + self.flags() + ['-x', 'c++', '-c', interface, '-o', MODULE_NAME + '.o']]
+
+def run(command):
+    "Runs a command, returning its peak resident set size in bytes"
+    child = subprocess.Popen(command)
+    pid, status, rusage = os.wait4(child.pid, 0)
+    if status != 0:
+        raise Exception('Command failed: ' + ' '.join(command))
+    # ru_maxrss is in kilobytes on Linux
+    return rusage.ru_maxrss * 1024
+
+def benchmark(mode, units):
+    "Returns total build seconds and peak resident set size for building units translation units"
+    peak = 0
+    begin = time.time()
+    for command in mode.prepare():
+        peak = max(peak, run(command))
+    for n in range(0, units):
+        peak = max(peak, run([mode.compiler] + mode.flags() + ['-c', 'source%04d.cpp' % n, '-o', 'source%04d.o' % n]))
+    return time.time() - begin, peak
+
+if __name__ == "__main__":
+    compiler = sys.argv[1] if len(sys.argv) > 1 else 'g++'
+    units = int(sys.argv[2]) if len(sys.argv) > 2 else 100
+    if os.path.exists(SCRATCH):
+        shutil.rmtree(SCRATCH)
+    os.mkdir(SCRATCH)
+    os.chdir(SCRATCH)
+    for n in range(0, units):
+        with open('source%04d.cpp' % n, 'wt') as oh:
+            oh.write(source(n))
+    results = []
+    for mode in [Include(compiler), Import(compiler)]:
+        print('Building %d translation units with %s in %s mode ...' % (units, compiler, mode.name))
+        try:
+            seconds, peak = benchmark(mode, units)
+        except Exception as e:
+            print('   ', e)
+            continue
+        print('   ', '%.2f secs, peak %.1f Mb' % (seconds, peak / 1048576.0))
+        results.append((mode.name, seconds, peak))
+    os.chdir('..')
+    with open('compile_time.csv', 'wt') as oh:
+        oh.write('Compiler,Mode,Translation units,Total seconds,Seconds per unit,Peak Mb\n')
+        for name, seconds, peak in results:
+            oh.write('%s,%s,%d,%f,%f,%f\n' % (compiler, name, units, seconds, seconds / units, peak / 1048576.0))
@@ -0,0 +1,115 @@
+/* Benchmark of failure path throughput and latency as the injected failure rate sweeps from 0% to 100%
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/>
+File Created: Mar 2019
+
+Build with something like:
+
+  g++ -std=c++17 -O3 -DOUTCOME_ENABLE_ERROR_INJECTION -I../include -o error_injection error_injection.cpp
+
+Usage: error_injection [nesting depth=10] [iterations=1000000] [throw]
+
+If "throw" is specified, failures are translated into exceptions at the top of the call chain.
+Outputs a CSV of failure rate, throughput and per call latency percentiles in CPU ticks.
+*/
+
+#ifndef OUTCOME_ENABLE_ERROR_INJECTION
+#define OUTCOME_ENABLE_ERROR_INJECTION 1
+#endif
+
+#include "../include/outcome/outcome.hpp"
+#include "../include/outcome/try.hpp"
+#include "timing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+volatile int sink;
+
+// Failures are only injected into the innermost function's result<unsigned>
+QUICKCPPLIB_NOINLINE outcome::result<unsigned> leaf(int par)
+{
+  return static_cast<unsigned>(par);
+}
+
+QUICKCPPLIB_NOINLINE outcome::result<int> chain(int par, int depth)
+{
+  if(depth == 0)
+  {
+    OUTCOME_TRY(v, leaf(par));
+    return static_cast<int>(v);
+  }
+  OUTCOME_TRY(v, chain(par + 1, depth - 1));
+  return v;
+}
+
+static std::error_code injected_error() noexcept
+{
+  return std::make_error_code(std::errc::resource_unavailable_try_again);
+}
+
+int main(int argc, char *argv[])
+{
+  const int depth = (argc > 1) ? atoi(argv[1]) : 10;
+  const size_t iterations = (argc > 2) ? static_cast<size_t>(atoll(argv[2])) : 1000000;
+  const bool use_exceptions = (argc > 3) && strcmp(argv[3], "throw") == 0;
+#ifndef __cpp_exceptions
+  if(use_exceptions)
+  {
+    fprintf(stderr, "FATAL: Exceptions are disabled in this build\n");
+    return 1;
+  }
+#endif
+  static const double rates[] = {0.0, 0.001, 0.01, 0.05, 0.1, 0.25, 0.5, 0.75, 1.0};
+  std::vector<uint64_t> ticks(iterations);
+  printf("\"Failure rate\",\"Mcalls/sec\",\"p50 ticks\",\"p99 ticks\",\"p99.9 ticks\"\n");
+  for(double rate : rates)
+  {
+    outcome::error_injection::inject<outcome::result<unsigned>>(rate, injected_error);
+    // Warm up
+    for(size_t n = 0; n < iterations / 10; n++)
+    {
+      sink = sink + chain(static_cast<int>(n), depth).has_value();
+    }
+    auto begin = std::chrono::steady_clock::now();
+    for(size_t n = 0; n < iterations; n++)
+    {
+      auto start = ticksclock();
+      outcome::outcome<int> o(chain(static_cast<int>(n), depth));
+      if(use_exceptions)
+      {
+#ifdef __cpp_exceptions
+        try
+        {
+          sink = sink + o.value();
+        }
+        catch(const std::system_error & /*unused*/)
+        {
+        }
+#endif
+      }
+      else
+      {
+        sink = sink + (o.has_value() ? o.assume_value() : 0);
+      }
+      ticks[n] = ticksclock() - start;
+    }
+    auto end = std::chrono::steady_clock::now();
+    const double secs = std::chrono::duration<double>(end - begin).count();
+    auto percentile = [&](double p) {
+      auto it = ticks.begin() + static_cast<ptrdiff_t>(p * static_cast<double>(iterations - 1));
+      std::nth_element(ticks.begin(), it, ticks.end());
+      return *it;
+    };
+    const uint64_t p50 = percentile(0.5), p99 = percentile(0.99), p999 = percentile(0.999);
+    printf("%f,%f,%llu,%llu,%llu\n", rate, static_cast<double>(iterations) / secs / 1000000.0, (unsigned long long) p50, (unsigned long long) p99, (unsigned long long) p999);
+    fflush(stdout);
+  }
+  outcome::error_injection::stop<outcome::result<unsigned>>();
+  return 0;
+}
@@ -0,0 +1,139 @@
+/* Benchmark of monadic pipelines against the equivalent hand written OUTCOME_TRY code
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/>
+File Created: Mar 2019
+
+Build with something like:
+
+  g++ -std=c++17 -O2 -I../include -o monadic monadic.cpp
+
+Usage: monadic [iterations=1000000]
+
+Runs an eight step pipeline of fallible steps over a small and a large payload, written once with
+map() and and_then(), and once with OUTCOME_TRY. Outputs a CSV of payload, style, payload moves and
+copies per pipeline, and per pipeline latency percentiles in CPU ticks. Moves and copies should be
+identical between the two styles, and latencies should be within noise of one another.
+*/
+
+#include "../include/outcome/result.hpp"
+#include "../include/outcome/try.hpp"
+#include "timing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+volatile int sink;
+static unsigned long long moves, copies;
+
+// A payload large enough that an extra move would show up in the latencies
+struct large
+{
+  int value{0};
+  char padding[1020]{};
+  large() = default;
+  explicit large(int v)
+      : value(v)
+  {
+  }
+  large(const large &o)
+      : value(o.value)
+  {
+    memcpy(padding, o.padding, sizeof(padding));
+    ++copies;
+  }
+  large(large &&o) noexcept : value(o.value)
+  {
+    memcpy(padding, o.padding, sizeof(padding));
+    ++moves;
+  }
+  large &operator=(const large &) = default;
+  large &operator=(large &&) = default;
+};
+inline int value_of(int v)
+{
+  return v;
+}
+inline int value_of(const large &v)
+{
+  return v.value;
+}
+
+// Each step fails if its input reaches a threshold which is never reached during the benchmark
+template <class T> QUICKCPPLIB_NOINLINE outcome::result<T> step(T v)
+{
+  if(value_of(v) < 0)
+  {
+    return std::errc::result_out_of_range;
+  }
+  return v;
+}
+template <class T> inline T increment(T v)
+{
+  return T(value_of(v) + 1);
+}
+
+template <class T> QUICKCPPLIB_NOINLINE outcome::result<T> pipeline_monadic(int par)
+{
+  return step(T(par))                 //
+  .and_then(step<T>)                  //
+  .map(increment<T>)                  //
+  .and_then(step<T>)                  //
+  .map(increment<T>)                  //
+  .and_then(step<T>)                  //
+  .map(increment<T>)                  //
+  .and_then(step<T>);
+}
+
+template <class T> QUICKCPPLIB_NOINLINE outcome::result<T> pipeline_try(int par)
+{
+  OUTCOME_TRY(v1, step(T(par)));
+  OUTCOME_TRY(v2, step(std::move(v1)));
+  T v3 = increment(std::move(v2));
+  OUTCOME_TRY(v4, step(std::move(v3)));
+  T v5 = increment(std::move(v4));
+  OUTCOME_TRY(v6, step(std::move(v5)));
+  T v7 = increment(std::move(v6));
+  return step(std::move(v7));
+}
+
+template <class T> static void benchmark(const char *payload, const char *style, outcome::result<T> (*pipeline)(int), size_t iterations)
+{
+  std::vector<uint64_t> ticks(iterations);
+  // Warm up
+  for(size_t n = 0; n < iterations / 10; n++)
+  {
+    sink = sink + pipeline(static_cast<int>(n & 0xffff)).has_value();
+  }
+  moves = copies = 0;
+  for(size_t n = 0; n < iterations; n++)
+  {
+    auto start = ticksclock();
+    auto r = pipeline(static_cast<int>(n & 0xffff));
+    sink = sink + value_of(r.assume_value());
+    ticks[n] = ticksclock() - start;
+  }
+  auto percentile = [&](double p) {
+    auto it = ticks.begin() + static_cast<ptrdiff_t>(p * static_cast<double>(iterations - 1));
+    std::nth_element(ticks.begin(), it, ticks.end());
+    return *it;
+  };
+  const uint64_t p50 = percentile(0.5), p99 = percentile(0.99), p999 = percentile(0.999);
+  printf("\"%s\",\"%s\",%f,%f,%llu,%llu,%llu\n", payload, style, static_cast<double>(moves) / iterations, static_cast<double>(copies) / iterations, (unsigned long long) p50, (unsigned long long) p99, (unsigned long long) p999);
+  fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+  const size_t iterations = (argc > 1) ? static_cast<size_t>(atoll(argv[1])) : 1000000;
+  printf("\"Payload\",\"Style\",\"Moves\",\"Copies\",\"p50 ticks\",\"p99 ticks\",\"p99.9 ticks\"\n");
+  benchmark<int>("int", "OUTCOME_TRY", pipeline_try<int>, iterations);
+  benchmark<int>("int", "monadic", pipeline_monadic<int>, iterations);
+  benchmark<large>("large", "OUTCOME_TRY", pipeline_try<large>, iterations);
+  benchmark<large>("large", "monadic", pipeline_monadic<large>, iterations);
+  return 0;
+}
@@ -0,0 +1,216 @@
+/* Benchmark of result_channel against a mutex protected queue of results
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/>
+File Created: Mar 2019
+
+Build with something like:
+
+  g++ -std=c++17 -O2 -I../include -o result_channel result_channel.cpp -lpthread
+
+Usage: result_channel [items=4000000]
+
+Passes items from producer threads to consumer threads, through a std::deque protected by a mutex
+and condition variables as pipeline stages traditionally do, and through a result_channel with each
+wait strategy and with single and batched pushes and pops. The last producer to finish ends the
+stream with an error, which exactly one consumer must see. Outputs a CSV of queue, producers,
+consumers, items per second and nanoseconds per item.
+*/
+
+#include "../include/outcome/result.hpp"
+#include "../include/outcome/result_channel.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+static constexpr size_t capacity = 1024;
+static constexpr size_t batch = 32;
+
+// The traditional design: a bounded queue of results behind a mutex, with a side flag for the end
+class mutex_queue
+{
+  std::mutex _lock;
+  std::condition_variable _not_empty, _not_full;
+  std::deque<outcome::result<int>> _items;
+  bool _closed{false};
+
+public:
+  void push(outcome::result<int> &&r)
+  {
+    std::unique_lock<std::mutex> g(_lock);
+    _not_full.wait(g, [&] { return _items.size() < capacity; });
+    if(r.has_error())
+    {
+      _closed = true;
+    }
+    _items.push_back(std::move(r));
+    _not_empty.notify_one();
+  }
+  template <class F> bool pop(F &&f)
+  {
+    std::unique_lock<std::mutex> g(_lock);
+    _not_empty.wait(g, [&] { return !_items.empty() || _closed; });
+    if(_items.empty())
+    {
+      return false;
+    }
+    auto r = std::move(_items.front());
+    _items.pop_front();
+    _not_full.notify_one();
+    if(r.has_error())
+    {
+      // Let the other consumers see that the stream has ended
+      _not_empty.notify_all();
+    }
+    g.unlock();
+    f(std::move(r));
+    return true;
+  }
+};
+
+struct consumed
+{
+  std::atomic<long long> values{0};
+  std::atomic<int> errors{0};
+  void operator()(outcome::result<int> &&r)
+  {
+    if(r)
+    {
+      values.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+      errors.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+};
+
+template <class Producer, class Consumer> static void run(const char *queue, unsigned producers, unsigned consumers, size_t items, Producer &&produce, Consumer &&consume, consumed &c)
+{
+  std::vector<std::thread> threads;
+  const size_t per_producer = items / producers;
+  auto begin = std::chrono::steady_clock::now();
+  for(unsigned n = 0; n < consumers; n++)
+  {
+    threads.emplace_back([&] { consume(); });
+  }
+  for(unsigned n = 0; n < producers; n++)
+  {
+    threads.emplace_back([&] { produce(per_producer); });
+  }
+  for(auto &t : threads)
+  {
+    t.join();
+  }
+  auto end = std::chrono::steady_clock::now();
+  if(c.values != static_cast<long long>(per_producer * producers) || c.errors != 1)
+  {
+    fprintf(stderr, "FATAL: %s consumed %lld values and %d errors\n", queue, c.values.load(), c.errors.load());
+    abort();
+  }
+  const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) / static_cast<double>(per_producer * producers);
+  printf("\"%s\",%u,%u,%f,%f\n", queue, producers, consumers, 1000000000.0 / ns, ns);
+  fflush(stdout);
+}
+
+static void benchmark_mutex(unsigned producers, unsigned consumers, size_t items)
+{
+  mutex_queue q;
+  consumed c;
+  std::atomic<unsigned> finished{0};
+  run("mutex queue", producers, consumers, items,
+      [&](size_t count) {
+        for(size_t n = 0; n < count; n++)
+        {
+          q.push(static_cast<int>(n));
+        }
+        // The last producer to finish ends the stream
+        if(finished.fetch_add(1) + 1 == producers)
+        {
+          q.push(std::errc::operation_canceled);
+        }
+      },
+      [&] {
+        while(q.pop(c))
+        {
+        }
+      },
+      c);
+}
+
+static void benchmark_channel(const char *queue, outcome::result_channel_wait strategy, bool batched, unsigned producers, unsigned consumers, size_t items)
+{
+  outcome::result_channel<int> ch(capacity, strategy);
+  consumed c;
+  std::atomic<unsigned> finished{0};
+  run(queue, producers, consumers, items,
+      [&](size_t count) {
+        if(batched)
+        {
+          int values[batch];
+          for(size_t n = 0; n < count; n += batch)
+          {
+            const size_t todo = (count - n < batch) ? count - n : batch;
+            for(size_t i = 0; i < todo; i++)
+            {
+              values[i] = static_cast<int>(n + i);
+            }
+            ch.push_batch(values, todo);
+          }
+        }
+        else
+        {
+          for(size_t n = 0; n < count; n++)
+          {
+            ch.push(static_cast<int>(n));
+          }
+        }
+        if(finished.fetch_add(1) + 1 == producers)
+        {
+          ch.push(std::errc::operation_canceled);
+        }
+      },
+      [&] {
+        if(batched)
+        {
+          while(ch.pop_batch(batch, c) > 0)
+          {
+          }
+        }
+        else
+        {
+          while(ch.pop(c))
+          {
+          }
+        }
+      },
+      c);
+}
+
+int main(int argc, char *argv[])
+{
+  const size_t items = (argc > 1) ? static_cast<size_t>(atoll(argv[1])) : 4000000;
+  const unsigned cpus = (std::thread::hardware_concurrency() > 1) ? std::thread::hardware_concurrency() : 1;
+  printf("\"Queue\",\"Producers\",\"Consumers\",\"Items/sec\",\"ns/item\"\n");
+  const unsigned configurations[][2] = {{1, 1}, {2, 2}, {4, 4}};
+  for(auto &config : configurations)
+  {
+    const unsigned producers = config[0], consumers = config[1];
+    benchmark_mutex(producers, consumers, items);
+    if(producers + consumers <= cpus)
+    {
+      // Spinning threads which have no core of their own spin away their time slice
+      benchmark_channel("result_channel spin", outcome::result_channel_wait::spin, false, producers, consumers, items);
+    }
+    benchmark_channel("result_channel yield", outcome::result_channel_wait::yield, false, producers, consumers, items);
+    benchmark_channel("result_channel block", outcome::result_channel_wait::block, false, producers, consumers, items);
+    benchmark_channel("result_channel block batched", outcome::result_channel_wait::block, true, producers, consumers, items);
+  }
+  return 0;
+}
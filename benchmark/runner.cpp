@@ -1,5 +1,6 @@
 #include "timing.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include "function.h"
 #if defined(_CPPUNWIND) || defined(__EXCEPTIONS)
 #include <exception>
@@ -7,36 +8,95 @@
 
 #define ITERATIONS 100000
 
+// Timings below this many ticks are recorded exactly, above into sixteen buckets per power of two
+#define HISTOGRAM_LINEAR 4096
+#define HISTOGRAM_BUCKETS (HISTOGRAM_LINEAR + 52 * 16)
+
 extern volatile int counter;
 volatile int counter, forcereturn;
 
-int main(void)
+// A negative parameter makes the innermost function of the -mixed strategies fail
+static int pars[ITERATIONS];
+static unsigned histogram[HISTOGRAM_BUCKETS];
+
+static unsigned bucket_of(uint64_t ticks)
+{
+  if(ticks < HISTOGRAM_LINEAR)
+    return (unsigned) ticks;
+  unsigned log2 = 12;
+  while(log2 < 63 && (ticks >> (log2 + 1)) != 0)
+    log2++;
+  return HISTOGRAM_LINEAR + (log2 - 12) * 16 + (unsigned) ((ticks >> (log2 - 4)) & 15);
+}
+
+// Returns the lowest tick count recorded in a bucket
+static uint64_t bucket_ticks(unsigned bucket)
+{
+  if(bucket < HISTOGRAM_LINEAR)
+    return bucket;
+  unsigned log2 = (bucket - HISTOGRAM_LINEAR) / 16 + 12, sub = (bucket - HISTOGRAM_LINEAR) % 16;
+  return (1ULL << log2) + ((uint64_t) sub << (log2 - 4));
+}
+
+static uint64_t percentile(double p)
+{
+  unsigned long long want = (unsigned long long) (p * ITERATIONS), seen = 0;
+  for(unsigned n = 0; n < HISTOGRAM_BUCKETS; n++)
+  {
+    seen += histogram[n];
+    if(seen > want)
+      return bucket_ticks(n);
+  }
+  return bucket_ticks(HISTOGRAM_BUCKETS - 1);
+}
+
+// Usage: runner [failure ratio=0]
+// Prints mean, p50, p99 and p99.9 ticks per call
+int main(int argc, char *argv[])
 {
 #ifdef _WIN32
   SetThreadAffinityMask(GetCurrentThread(), 2ULL);
 #endif
+  // Exactly ratio * ITERATIONS failures at random positions, reproducibly
+  {
+    double ratio = (argc > 1) ? atof(argv[1]) : 0;
+    int failures = (int) (ratio * ITERATIONS + 0.5);
+    for(int n = 0; n < ITERATIONS; n++)
+      pars[n] = (n < failures) ? -1000000000 : n;
+    uint32_t seed = 0x9e3779b9;
+    for(int n = ITERATIONS - 1; n > 0; n--)
+    {
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+      int m = (int) (seed % (uint32_t)(n + 1)), t = pars[n];
+      pars[n] = pars[m];
+      pars[m] = t;
+    }
+  }
   {
     usCount start=GetUsCount();
     while(GetUsCount()-start<1*1000000000000LL);
   }
-  auto start = ticksclock();
+  double total = 0;
   for(int n=0; n<ITERATIONS; n++)
   {
+    auto start = ticksclock();
 #if !defined(_CPPUNWIND) && !defined(__EXCEPTIONS)
-    forcereturn += !FUNCTION(n);
+    forcereturn += !FUNCTION(pars[n]);
 #else
     try
     {
-      forcereturn += !FUNCTION(n);
+      forcereturn += !FUNCTION(pars[n]);
     }
     catch(const std::exception &)
     {
     }
 #endif
+    auto end = ticksclock();
+    total += (double) (end - start);
+    histogram[bucket_of(end - start)]++;
   }
-  auto end = ticksclock();
-  double ticks=end-start;
-  ticks/=ITERATIONS;
-  printf("%f\n", ticks);
+  printf("%f,%llu,%llu,%llu\n", total / ITERATIONS, (unsigned long long) percentile(0.5), (unsigned long long) percentile(0.99), (unsigned long long) percentile(0.999));
   return 0;
 }
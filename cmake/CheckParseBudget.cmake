@@ -0,0 +1,39 @@
+# Fails if preprocessing and parsing a translation unit exceeds a token or time budget
+#
+# Usage: cmake -DCOMPILER=<c++ compiler> -DSOURCE=<file> -DTOKEN_BUDGET=<tokens>
+#              -DSECONDS_BUDGET=<seconds> [-DFLAGS=<;-list of flags>] -P CheckParseBudget.cmake
+cmake_minimum_required(VERSION 3.1 FATAL_ERROR)
+foreach(var COMPILER SOURCE TOKEN_BUDGET SECONDS_BUDGET)
+  if(NOT DEFINED ${var})
+    message(FATAL_ERROR "FATAL: ${var} must be defined")
+  endif()
+endforeach()
+get_filename_component(name "${SOURCE}" NAME_WE)
+set(preprocessed "${CMAKE_CURRENT_BINARY_DIR}/${name}.i")
+
+execute_process(COMMAND "${COMPILER}" ${FLAGS} -E -P "${SOURCE}" -o "${preprocessed}"
+  RESULT_VARIABLE result
+  ERROR_VARIABLE errors
+)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "FATAL: Preprocessing ${SOURCE} failed with ${result}:\n${errors}")
+endif()
+# Identifiers and numbers count as one token, everything else as one token per character,
+# which overcounts multi-character operators but is stable between compilers
+file(READ "${preprocessed}" contents)
+string(REPLACE ";" "," contents "${contents}")
+string(REGEX MATCHALL "[A-Za-z_0-9]+|[^A-Za-z_0-9 \t\r\n]" tokens "${contents}")
+list(LENGTH tokens token_count)
+message(STATUS "${SOURCE} preprocesses into ${token_count} tokens (budget ${TOKEN_BUDGET})")
+if(token_count GREATER TOKEN_BUDGET)
+  message(FATAL_ERROR "FATAL: ${SOURCE} preprocesses into ${token_count} tokens, over the budget of ${TOKEN_BUDGET}")
+endif()
+
+execute_process(COMMAND "${COMPILER}" ${FLAGS} -fsyntax-only "${SOURCE}"
+  RESULT_VARIABLE result
+  ERROR_VARIABLE errors
+  TIMEOUT ${SECONDS_BUDGET}
+)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "FATAL: Parsing ${SOURCE} did not complete within ${SECONDS_BUDGET} seconds (${result}):\n${errors}")
+endif()
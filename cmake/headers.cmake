@@ -2,11 +2,15 @@
 set(outcome_HEADERS
   "include/outcome/experimental/result.h"
   "include/outcome.hpp"
+  "include/outcome/asio_result.hpp"
+  "include/outcome/atomic_result.hpp"
   "include/outcome/bad_access.hpp"
   "include/outcome/basic_outcome.hpp"
   "include/outcome/basic_result.hpp"
   "include/outcome/boost_outcome.hpp"
   "include/outcome/boost_result.hpp"
+  "include/outcome/boxed_payload.hpp"
+  "include/outcome/breadcrumbs.hpp"
   "include/outcome/config.hpp"
   "include/outcome/convert.hpp"
   "include/outcome/detail/basic_outcome_exception_observers.hpp"
@@ -16,13 +20,27 @@ set(outcome_HEADERS
   "include/outcome/detail/basic_result_final.hpp"
   "include/outcome/detail/basic_result_storage.hpp"
   "include/outcome/detail/basic_result_value_observers.hpp"
+  "include/outcome/detail/error_wrapper.hpp"
+  "include/outcome/detail/expected_fwd.hpp"
+  "include/outcome/detail/import_module.hpp"
+  "include/outcome/detail/instrumentation.hpp"
+  "include/outcome/detail/monadic.hpp"
+  "include/outcome/detail/namespace_macros.hpp"
   "include/outcome/detail/trait_std_error_code.hpp"
   "include/outcome/detail/trait_std_exception.hpp"
+  "include/outcome/detail/try_macros.hpp"
   "include/outcome/detail/value_storage.hpp"
+  "include/outcome/error_context.hpp"
+  "include/outcome/error_injection.hpp"
+  "include/outcome/error_list.hpp"
+  "include/outcome/experimental/c_result.hpp"
+  "include/outcome/experimental/posix.hpp"
+  "include/outcome/experimental/status_code_table.hpp"
   "include/outcome/experimental/status_outcome.hpp"
   "include/outcome/experimental/status_result.hpp"
   "include/outcome/iostream_support.hpp"
   "include/outcome/outcome.hpp"
+  "include/outcome/pmr.hpp"
   "include/outcome/policy/all_narrow.hpp"
   "include/outcome/policy/base.hpp"
   "include/outcome/policy/fail_to_compile_observers.hpp"
@@ -30,15 +48,20 @@ set(outcome_HEADERS
   "include/outcome/policy/outcome_exception_ptr_rethrow.hpp"
   "include/outcome/policy/result_error_code_throw_as_system_error.hpp"
   "include/outcome/policy/result_exception_ptr_rethrow.hpp"
+  "include/outcome/policy/sampled_narrow.hpp"
   "include/outcome/policy/terminate.hpp"
   "include/outcome/policy/throw_bad_result_access.hpp"
   "include/outcome/result.hpp"
+  "include/outcome/result_channel.hpp"
   "include/outcome/revision.hpp"
+  "include/outcome/std_expected.hpp"
   "include/outcome/std_outcome.hpp"
   "include/outcome/std_result.hpp"
   "include/outcome/success_failure.hpp"
+  "include/outcome/telemetry.hpp"
   "include/outcome/trait.hpp"
   "include/outcome/try.hpp"
+  "include/outcome/usdt.hpp"
   "include/outcome/utils.hpp"
   "include/outcome/version.hpp"
   "include/outcome/outcome.natvis"
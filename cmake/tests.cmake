@@ -2,15 +2,26 @@
 set(outcome_TESTS
   "test/expected-pass.cpp"
   "test/single-header-test.cpp"
+  "test/tests/asio-result.cpp"
+  "test/tests/atomic-result.cpp"
+  "test/tests/boxed-payload.cpp"
+  "test/tests/breadcrumbs.cpp"
+  "test/tests/c-result-layout.cpp"
   "test/tests/comparison.cpp"
   "test/tests/constexpr.cpp"
   "test/tests/containers.cpp"
   "test/tests/core-outcome.cpp"
   "test/tests/core-result.cpp"
   "test/tests/default-construction.cpp"
+  "test/tests/error-classification.cpp"
+  "test/tests/error-context.cpp"
+  "test/tests/error-injection.cpp"
+  "test/tests/error-list.cpp"
   "test/tests/experimental-core-outcome-status.cpp"
   "test/tests/experimental-core-result-status.cpp"
   "test/tests/experimental-p0709a.cpp"
+  "test/tests/experimental-posix.cpp"
+  "test/tests/experimental-status-code-table.cpp"
   "test/tests/fileopen.cpp"
   "test/tests/hooks.cpp"
   "test/tests/issue0007.cpp"
@@ -27,12 +38,20 @@ set(outcome_TESTS
   "test/tests/issue0115.cpp"
   "test/tests/issue0116.cpp"
   "test/tests/issue0140.cpp"
+  "test/tests/lazy-error.cpp"
+  "test/tests/monadic.cpp"
   "test/tests/noexcept-propagation.cpp"
   "test/tests/propagate.cpp"
+  "test/tests/result-channel.cpp"
+  "test/tests/sampled-narrow.cpp"
   "test/tests/serialisation.cpp"
+  "test/tests/std-expected.cpp"
   "test/tests/success-failure.cpp"
   "test/tests/swap.cpp"
+  "test/tests/telemetry.cpp"
   "test/tests/udts.cpp"
+  "test/tests/usdt.cpp"
+  "test/tests/uses-allocator.cpp"
   "test/tests/value-or-error.cpp"
 )
 # DO NOT EDIT, GENERATED BY SCRIPT
@@ -40,6 +59,7 @@ set(outcome_COMPILE_TESTS
 )
 # DO NOT EDIT, GENERATED BY SCRIPT
 set(outcome_COMPILE_FAIL_TESTS
+  "test/compile-fail/c-result-layout-mismatch.cpp"
   "test/compile-fail/issue0071-fail.cpp"
   "test/compile-fail/outcome-int-int-1.cpp"
   "test/compile-fail/result-int-int-1.cpp"
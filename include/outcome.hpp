@@ -22,10 +22,11 @@ Distributed under the Boost Software License, Version 1.0.
 http://www.boost.org/LICENSE_1_0.txt)
 */
 
-#if defined(__cpp_modules) && !defined(GENERATING_OUTCOME_MODULE_INTERFACE)
-import outcome_v2_0;
+#if defined(OUTCOME_ENABLE_CXX_MODULES) && !defined(GENERATING_OUTCOME_MODULE_INTERFACE)
+#include "outcome/detail/import_module.hpp"
 #else
 #include "outcome/iostream_support.hpp"
+#include "outcome/std_expected.hpp"
 #include "outcome/try.hpp"
 #include "outcome/utils.hpp"
 #endif
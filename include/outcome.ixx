@@ -1,4 +1,37 @@
+// Everything Outcome includes which is not itself part of Outcome must be in the global module fragment
+module;
+#include "outcome/version.hpp"
+#include "outcome/quickcpplib/include/config.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <initializer_list>
+#include <iosfwd>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__has_include) && __has_include(<version>)
+#include <version>
+#endif
+#if defined(__has_include) && __has_include(<expected>)
+#include <expected>
+#endif
+
+#include "outcome/detail/expected_fwd.hpp"
+
+export module outcome_v2_0;  // OUTCOME_MODULE_NAME
+
 // Tell the headers we are generating the interface for the library
 #define GENERATING_OUTCOME_MODULE_INTERFACE
-export module outcome_v2_0;  // OUTCOME_MODULE_NAME
 #include "outcome.hpp"
@@ -0,0 +1,248 @@
+/* ASIO completion token adaptor completing with a result
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_ASIO_RESULT_HPP
+#define OUTCOME_ASIO_RESULT_HPP
+
+/* Use Boost.ASIO if it has already been included, or standalone ASIO if it has
+already been included, or whichever can be found, preferring standalone ASIO.
+*/
+#ifndef OUTCOME_USE_BOOST_ASIO
+#if defined(BOOST_ASIO_VERSION)
+#define OUTCOME_USE_BOOST_ASIO 1
+#elif defined(ASIO_VERSION)
+#define OUTCOME_USE_BOOST_ASIO 0
+#elif defined(__has_include)
+#if __has_include(<asio/async_result.hpp>)
+#define OUTCOME_USE_BOOST_ASIO 0
+#else
+#define OUTCOME_USE_BOOST_ASIO 1
+#endif
+#else
+#define OUTCOME_USE_BOOST_ASIO 1
+#endif
+#endif
+
+#if OUTCOME_USE_BOOST_ASIO
+#include "boost_result.hpp"
+
+#include <boost/asio/associated_allocator.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
+#define OUTCOME_ASIO_NAMESPACE ::boost::asio
+#define OUTCOME_ASIO_NAMESPACE_BEGIN namespace boost { namespace asio {
+#define OUTCOME_ASIO_NAMESPACE_END } }
+#define OUTCOME_ASIO_VERSION BOOST_ASIO_VERSION
+#else
+#include "std_result.hpp"
+
+#include <asio/associated_allocator.hpp>
+#include <asio/associated_executor.hpp>
+#include <asio/async_result.hpp>
+#define OUTCOME_ASIO_NAMESPACE ::asio
+#define OUTCOME_ASIO_NAMESPACE_BEGIN namespace asio {
+#define OUTCOME_ASIO_NAMESPACE_END }
+#define OUTCOME_ASIO_VERSION ASIO_VERSION
+#endif
+#if OUTCOME_ASIO_VERSION >= 102400
+#if OUTCOME_USE_BOOST_ASIO
+#include <boost/asio/associator.hpp>
+#else
+#include <asio/associator.hpp>
+#endif
+#endif
+
+#include <tuple>
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+#if OUTCOME_USE_BOOST_ASIO
+using asio_error_code = boost::system::error_code;
+template <class R> using asio_result = boost_result<R, asio_error_code>;
+#else
+using asio_error_code = OUTCOME_ASIO_NAMESPACE::error_code;
+template <class R> using asio_result = std_result<R, asio_error_code>;
+#endif
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class CompletionToken> struct as_result_t
+{
+  CompletionToken token;
+
+  OUTCOME_TEMPLATE(class T)
+  OUTCOME_TREQUIRES(OUTCOME_TPRED(std::is_constructible<CompletionToken, T>::value))
+  constexpr explicit as_result_t(T &&t)
+      : token(static_cast<T &&>(t))
+  {
+  }
+};
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class CompletionToken> constexpr inline as_result_t<std::decay_t<CompletionToken>> as_result(CompletionToken &&token)
+{
+  return as_result_t<std::decay_t<CompletionToken>>(static_cast<CompletionToken &&>(token));
+}
+
+namespace detail
+{
+  // The value type of the result replacing the error code and arguments of a completion signature
+  template <class... Args> struct asio_result_value
+  {
+    using type = std::tuple<std::decay_t<Args>...>;
+  };
+  template <> struct asio_result_value<>
+  {
+    using type = void;
+  };
+  template <class T> struct asio_result_value<T>
+  {
+    using type = std::decay_t<T>;
+  };
+
+  // Completion signatures beginning with an error code complete with a result instead, all others are untouched
+  template <class Signature> struct asio_result_signature
+  {
+    using type = Signature;
+    using result_type = void;
+  };
+  template <class R, class... Args> struct asio_result_signature<R(asio_error_code, Args...)>
+  {
+    using result_type = asio_result<typename asio_result_value<Args...>::type>;
+    using type = R(result_type);
+  };
+  template <class R, class... Args> struct asio_result_signature<R(const asio_error_code &, Args...)> : asio_result_signature<R(asio_error_code, Args...)>
+  {
+  };
+
+  /* Adapts the handler of the wrapped completion token, holding it by value without type erasure so the
+  handler is never allocated. Its associated executor and allocator are those of the wrapped handler, so
+  ASIO's recycling allocator and any strand continue to apply.
+  */
+  template <class Handler, class Result> struct asio_result_handler
+  {
+    Handler handler;
+
+    template <class... Args> void operator()(const asio_error_code &ec, Args &&... args)
+    {
+      if(ec)
+      {
+        static_cast<Handler &&>(handler)(Result(in_place_type<typename Result::error_type>, ec));
+        return;
+      }
+      _complete(std::is_void<typename Result::value_type>(), static_cast<Args &&>(args)...);
+    }
+
+  private:
+    void _complete(std::true_type /*void value*/) { static_cast<Handler &&>(handler)(Result(in_place_type<typename Result::value_type>)); }
+    template <class... Args> void _complete(std::false_type /*void value*/, Args &&... args) { static_cast<Handler &&>(handler)(Result(in_place_type<typename Result::value_type>, static_cast<Args &&>(args)...)); }
+  };
+  // Signatures not beginning with an error code pass straight through
+  template <class Handler> struct asio_result_handler<Handler, void>
+  {
+    Handler handler;
+
+    template <class... Args> void operator()(Args &&... args) { static_cast<Handler &&>(handler)(static_cast<Args &&>(args)...); }
+  };
+
+  // Exposes the return_type of an async_result if it has one, which ASIO 1.22 onwards no longer requires
+  template <class T> struct asio_make_void
+  {
+    using type = void;
+  };
+  template <class AsyncResult, class = void> struct asio_async_result_return_type
+  {
+  };
+  template <class AsyncResult> struct asio_async_result_return_type<AsyncResult, typename asio_make_void<typename AsyncResult::return_type>::type>
+  {
+    using return_type = typename AsyncResult::return_type;
+  };
+
+  // Wraps the handler passed to an initiation
+  template <class Initiation, class Result> struct asio_result_initiation
+  {
+    Initiation initiation;
+
+    template <class Handler, class... Args> void operator()(Handler &&handler, Args &&... args)
+    {
+      static_cast<Initiation &&>(initiation)(asio_result_handler<std::decay_t<Handler>, Result>{static_cast<Handler &&>(handler)}, static_cast<Args &&>(args)...);
+    }
+  };
+}  // namespace detail
+
+OUTCOME_V2_NAMESPACE_END
+
+// Tell ASIO about the as_result_t completion token, and make the adapted handler expose the associations of the wrapped handler
+OUTCOME_ASIO_NAMESPACE_BEGIN
+  template <class CompletionToken, class Signature>
+  struct async_result<OUTCOME_V2_NAMESPACE::as_result_t<CompletionToken>, Signature>  //
+      : OUTCOME_V2_NAMESPACE::detail::asio_async_result_return_type<async_result<CompletionToken, typename OUTCOME_V2_NAMESPACE::detail::asio_result_signature<Signature>::type>>
+  {
+    using _signature = OUTCOME_V2_NAMESPACE::detail::asio_result_signature<Signature>;
+
+    template <class Initiation, class RawCompletionToken, class... Args>
+    static decltype(auto) initiate(Initiation &&initiation, RawCompletionToken &&token, Args &&... args)
+    {
+      using initiation_type = OUTCOME_V2_NAMESPACE::detail::asio_result_initiation<std::decay_t<Initiation>, typename _signature::result_type>;
+      // async_initiate() takes the token by lvalue and forwards it as its explicit CompletionToken
+      // template argument, so the value category of the wrapped token is carried by that argument
+      using token_type = std::conditional_t<std::is_const<std::remove_reference_t<RawCompletionToken>>::value, const CompletionToken, CompletionToken>;
+      using forwarded_token_type = std::conditional_t<std::is_lvalue_reference<RawCompletionToken>::value, token_type &, token_type>;
+      return async_initiate<forwarded_token_type, typename _signature::type>(initiation_type{static_cast<Initiation &&>(initiation)}, token.token, static_cast<Args &&>(args)...);
+    }
+  };
+
+#if OUTCOME_ASIO_VERSION >= 102400
+  // ASIO 1.24 onwards forwards every association, including cancellation slots, through associator
+  template <template <class, class> class Associator, class Handler, class Result, class DefaultCandidate> struct associator<Associator, OUTCOME_V2_NAMESPACE::detail::asio_result_handler<Handler, Result>, DefaultCandidate>
+  {
+    using type = typename Associator<Handler, DefaultCandidate>::type;
+    static type get(const OUTCOME_V2_NAMESPACE::detail::asio_result_handler<Handler, Result> &h, const DefaultCandidate &c = DefaultCandidate()) noexcept { return Associator<Handler, DefaultCandidate>::get(h.handler, c); }
+  };
+#else
+  template <class Handler, class Result, class Executor> struct associated_executor<OUTCOME_V2_NAMESPACE::detail::asio_result_handler<Handler, Result>, Executor>
+  {
+    using type = typename associated_executor<Handler, Executor>::type;
+    static type get(const OUTCOME_V2_NAMESPACE::detail::asio_result_handler<Handler, Result> &h, const Executor &ex = Executor()) noexcept { return associated_executor<Handler, Executor>::get(h.handler, ex); }
+  };
+  template <class Handler, class Result, class Allocator> struct associated_allocator<OUTCOME_V2_NAMESPACE::detail::asio_result_handler<Handler, Result>, Allocator>
+  {
+    using type = typename associated_allocator<Handler, Allocator>::type;
+    static type get(const OUTCOME_V2_NAMESPACE::detail::asio_result_handler<Handler, Result> &h, const Allocator &a = Allocator()) noexcept { return associated_allocator<Handler, Allocator>::get(h.handler, a); }
+  };
+#endif
+OUTCOME_ASIO_NAMESPACE_END
+
+#undef OUTCOME_ASIO_NAMESPACE
+#undef OUTCOME_ASIO_NAMESPACE_BEGIN
+#undef OUTCOME_ASIO_NAMESPACE_END
+#undef OUTCOME_ASIO_VERSION
+
+#endif
@@ -0,0 +1,416 @@
+/* An atomic result, lock free when small enough
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_ATOMIC_RESULT_HPP
+#define OUTCOME_ATOMIC_RESULT_HPP
+
+#include "result_channel.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <thread>
+
+// Whether sixteen byte results are published with a double width compare and swap. On x86-64 this
+// requires cmpxchg16b, which every x86-64 processor since 2006 has. Loads are then compare and
+// swaps too, so concurrent readers serialise on the cache line. Define this to 0 in every
+// translation unit to use the sequence lock instead, whose readers share the cache line, when
+// results are read far more often than they are replaced.
+#ifndef OUTCOME_ATOMIC_RESULT_USE_CAS16
+#if(defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16))
+#define OUTCOME_ATOMIC_RESULT_USE_CAS16 1
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define OUTCOME_ATOMIC_RESULT_USE_CAS16 1
+#else
+#define OUTCOME_ATOMIC_RESULT_USE_CAS16 0
+#endif
+#endif
+#if OUTCOME_ATOMIC_RESULT_USE_CAS16 && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+namespace detail
+{
+  // A result is published as up to Words 64 bit words, which hold the value or the error, then the
+  // status, with every unused byte zeroed so equal results have equal words
+  template <size_t Words> struct atomic_result_words
+  {
+    uint64_t w[Words];
+  };
+  template <size_t Words> inline bool operator==(const atomic_result_words<Words> &a, const atomic_result_words<Words> &b) noexcept { return 0 == memcmp(a.w, b.w, sizeof(a.w)); }
+  template <size_t Words> inline bool operator!=(const atomic_result_words<Words> &a, const atomic_result_words<Words> &b) noexcept { return 0 != memcmp(a.w, b.w, sizeof(a.w)); }
+
+  enum class atomic_result_strategy
+  {
+    word,     // a single 64 bit atomic
+    cas16,    // a double width compare and swap
+    seqlock   // a sequence lock, where readers retry and writers exclude one another
+  };
+  template <size_t Words> struct atomic_result_strategy_for : std::integral_constant<atomic_result_strategy, (Words == 1) ? atomic_result_strategy::word : (Words == 2 && OUTCOME_ATOMIC_RESULT_USE_CAS16) ? atomic_result_strategy::cas16 : atomic_result_strategy::seqlock>
+  {
+  };
+
+  template <size_t Words, atomic_result_strategy Strategy = atomic_result_strategy_for<Words>::value> class atomic_result_cell;
+
+  template <> class atomic_result_cell<1, atomic_result_strategy::word>
+  {
+    std::atomic<uint64_t> _v;
+
+  public:
+    using words = atomic_result_words<1>;
+    static constexpr bool is_always_lock_free = true;
+
+    explicit atomic_result_cell(const words &v) noexcept
+        : _v(v.w[0])
+    {
+    }
+    words load(std::memory_order order) const noexcept { return {{_v.load(order)}}; }
+    void store(const words &v, std::memory_order order) noexcept { _v.store(v.w[0], order); }
+    words exchange(const words &v, std::memory_order order) noexcept { return {{_v.exchange(v.w[0], order)}}; }
+    bool compare_exchange(words &expected, const words &desired, std::memory_order success, std::memory_order failure) noexcept { return _v.compare_exchange_strong(expected.w[0], desired.w[0], success, failure); }
+  };
+
+#if OUTCOME_ATOMIC_RESULT_USE_CAS16
+  // Every operation is a full barrier, whatever ordering was asked for
+  template <> class atomic_result_cell<2, atomic_result_strategy::cas16>
+  {
+  public:
+    using words = atomic_result_words<2>;
+
+  private:
+    struct alignas(16) _pair
+    {
+      uint64_t w[2];
+    };
+    mutable _pair _v;
+
+    bool _cas(words &expected, const words &desired) const noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+      return 0 != _InterlockedCompareExchange128(reinterpret_cast<volatile long long *>(_v.w), static_cast<long long>(desired.w[1]), static_cast<long long>(desired.w[0]), reinterpret_cast<long long *>(expected.w));  // NOLINT
+#elif defined(__x86_64__)
+      // Inline, as compilers only inline their own double width builtins when told the processor has cmpxchg16b
+      bool ret;
+      __asm__ __volatile__("lock cmpxchg16b %1\n\tsete %0" : "=q"(ret), "+m"(_v), "+a"(expected.w[0]), "+d"(expected.w[1]) : "b"(desired.w[0]), "c"(desired.w[1]) : "memory", "cc");
+      return ret;
+#else
+      unsigned __int128 e, d;
+      memcpy(&e, expected.w, sizeof(e));
+      memcpy(&d, desired.w, sizeof(d));
+      const unsigned __int128 old = __sync_val_compare_and_swap(reinterpret_cast<unsigned __int128 *>(_v.w), e, d);  // NOLINT
+      memcpy(expected.w, &old, sizeof(old));
+      return old == e;
+#endif
+    }
+
+  public:
+    static constexpr bool is_always_lock_free = true;
+
+    explicit atomic_result_cell(const words &v) noexcept
+        : _v{{v.w[0], v.w[1]}}
+    {
+    }
+    words load(std::memory_order /*unused*/) const noexcept
+    {
+      // Swaps zero for zero, which fetches the current words whatever they are. This is a locked
+      // read-modify-write, so readers take the cache line exclusively and serialise on one another
+      words ret{{0, 0}};
+      _cas(ret, ret);
+      return ret;
+    }
+    void store(const words &v, std::memory_order order) noexcept { exchange(v, order); }
+    words exchange(const words &v, std::memory_order order) noexcept
+    {
+      words ret = load(order);
+      while(!_cas(ret, v))
+      {
+      }
+      return ret;
+    }
+    bool compare_exchange(words &expected, const words &desired, std::memory_order /*unused*/, std::memory_order /*unused*/) noexcept { return _cas(expected, desired); }
+  };
+#endif
+
+  // Loads are at least acquire, and every modification is sequentially consistent
+  template <size_t Words> class atomic_result_cell<Words, atomic_result_strategy::seqlock>
+  {
+  public:
+    using words = atomic_result_words<Words>;
+
+  private:
+    std::atomic<uint32_t> _seq{0};  // odd while a writer is modifying the words
+    std::atomic<uint64_t> _v[Words];
+
+    uint32_t _lock() noexcept
+    {
+      unsigned spins = 0;
+      for(;;)
+      {
+        uint32_t seq = _seq.load(std::memory_order_relaxed);
+        if((seq & 1) == 0 && _seq.compare_exchange_weak(seq, seq + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+          std::atomic_thread_fence(std::memory_order_release);
+          return seq + 1;
+        }
+        _pause(spins);
+      }
+    }
+    void _unlock(uint32_t seq) noexcept { _seq.store(seq + 1, std::memory_order_release); }
+    words _read() const noexcept
+    {
+      words ret;
+      for(size_t n = 0; n < Words; n++)
+      {
+        ret.w[n] = _v[n].load(std::memory_order_relaxed);
+      }
+      return ret;
+    }
+    void _write(const words &v) noexcept
+    {
+      for(size_t n = 0; n < Words; n++)
+      {
+        _v[n].store(v.w[n], std::memory_order_relaxed);
+      }
+    }
+    static void _pause(unsigned &spins) noexcept
+    {
+      if(++spins < 64)
+      {
+        result_channel_pause();
+      }
+      else
+      {
+        std::this_thread::yield();
+      }
+    }
+
+  public:
+    static constexpr bool is_always_lock_free = false;
+
+    explicit atomic_result_cell(const words &v) noexcept { _write(v); }
+    words load(std::memory_order /*unused*/) const noexcept
+    {
+      unsigned spins = 0;
+      for(;;)
+      {
+        const uint32_t seq = _seq.load(std::memory_order_acquire);
+        if((seq & 1) == 0)
+        {
+          words ret = _read();
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if(_seq.load(std::memory_order_relaxed) == seq)
+          {
+            return ret;
+          }
+        }
+        _pause(spins);
+      }
+    }
+    void store(const words &v, std::memory_order /*unused*/) noexcept
+    {
+      const uint32_t seq = _lock();
+      _write(v);
+      _unlock(seq);
+    }
+    words exchange(const words &v, std::memory_order /*unused*/) noexcept
+    {
+      const uint32_t seq = _lock();
+      words ret = _read();
+      _write(v);
+      _unlock(seq);
+      return ret;
+    }
+    bool compare_exchange(words &expected, const words &desired, std::memory_order /*unused*/, std::memory_order /*unused*/) noexcept
+    {
+      const uint32_t seq = _lock();
+      const words current = _read();
+      const bool ret = (current == expected);
+      if(ret)
+      {
+        _write(desired);
+      }
+      _unlock(seq);
+      expected = current;
+      return ret;
+    }
+  };
+  template <size_t Words> constexpr bool atomic_result_cell<Words, atomic_result_strategy::seqlock>::is_always_lock_free;
+  constexpr bool atomic_result_cell<1, atomic_result_strategy::word>::is_always_lock_free;
+#if OUTCOME_ATOMIC_RESULT_USE_CAS16
+  constexpr bool atomic_result_cell<2, atomic_result_strategy::cas16>::is_always_lock_free;
+#endif
+}  // namespace detail
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class T, class E = std::error_code, class NoValuePolicy = policy::default_policy<T, E, void>> class atomic_result
+{
+public:
+  using value_type = T;
+  using error_type = E;
+  using result_type = basic_result<T, E, NoValuePolicy>;
+
+private:
+  static_assert(std::is_trivially_copyable<result_type>::value, "atomic_result requires value and error types which are trivially copyable");
+
+  // Where the value, error and status live in a result
+  using _layout = detail::basic_result_storage_layout<T, E, NoValuePolicy>;
+  static_assert(sizeof(typename _layout::storage_type) == sizeof(result_type), "basic_result must add nothing to its storage");
+  static constexpr size_t _value_size = std::is_void<T>::value ? 0 : sizeof(std::conditional_t<std::is_void<T>::value, char, T>);
+  static constexpr size_t _status_offset = (_value_size > sizeof(E)) ? _value_size : sizeof(E);
+  static constexpr size_t _words = (_status_offset + _layout::status_size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  using _cell_type = detail::atomic_result_cell<_words>;
+  using _words_type = detail::atomic_result_words<_words>;
+
+  _cell_type _cell;
+  detail::result_channel_event _changed;
+
+  /* The value or the error, whichever is present, is kept at the start of the words and the whole
+  status after them. Results are rebuilt by copying those bytes back into place rather than by
+  construction, so that loads do not rerun the construction hooks, nor recalculate status bits
+  such as the error class.
+  */
+  static _words_type _encode(const result_type &r) noexcept
+  {
+    _words_type ret{};
+    auto *out = reinterpret_cast<unsigned char *>(ret.w);           // NOLINT
+    const auto *in = reinterpret_cast<const unsigned char *>(&r);  // NOLINT
+    detail::status_bitfield_type status;
+    memcpy(&status, in + _layout::status_offset, sizeof(status));
+    if((status & detail::status_have_value) != 0)
+    {
+      memcpy(out, in + _layout::value_offset, _value_size);
+    }
+    else if((status & detail::status_have_error) != 0)
+    {
+      memcpy(out, in + _layout::error_offset, sizeof(E));
+    }
+    memcpy(out + _status_offset, &status, sizeof(status));
+    return ret;
+  }
+  static result_type _decode(const _words_type &v) noexcept
+  {
+    const auto *in = reinterpret_cast<const unsigned char *>(v.w);  // NOLINT
+    alignas(result_type) unsigned char out[sizeof(result_type)] = {};
+    detail::status_bitfield_type status;
+    memcpy(&status, in + _status_offset, sizeof(status));
+    if((status & detail::status_have_value) != 0)
+    {
+      memcpy(out + _layout::value_offset, in, _value_size);
+    }
+    else if((status & detail::status_have_error) != 0)
+    {
+      memcpy(out + _layout::error_offset, in, sizeof(E));
+    }
+    memcpy(out + _layout::status_offset, &status, sizeof(status));
+    return *reinterpret_cast<const result_type *>(out);  // NOLINT
+  }
+
+public:
+  //! True if every atomic_result of this type is lock free, which requires the larger of the value and the error, and four more bytes, to fit a lock free compare and swap.
+  static constexpr bool is_always_lock_free = _cell_type::is_always_lock_free;
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  explicit atomic_result(const result_type &r) noexcept
+      : _cell(_encode(r))
+  {
+  }
+  atomic_result(const atomic_result &) = delete;
+  atomic_result(atomic_result &&) = delete;
+  atomic_result &operator=(const atomic_result &) = delete;
+  atomic_result &operator=(atomic_result &&) = delete;
+  ~atomic_result() = default;
+
+  //! True if this atomic_result is lock free.
+  bool is_lock_free() const noexcept { return is_always_lock_free; }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  result_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept { return _decode(_cell.load(order)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  void store(const result_type &r, std::memory_order order = std::memory_order_seq_cst) noexcept { _cell.store(_encode(r), order); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  result_type exchange(const result_type &r, std::memory_order order = std::memory_order_seq_cst) noexcept { return _decode(_cell.exchange(_encode(r), order)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  bool compare_exchange_strong(result_type &expected, const result_type &desired, std::memory_order success, std::memory_order failure) noexcept
+  {
+    _words_type e = _encode(expected);
+    if(_cell.compare_exchange(e, _encode(desired), success, failure))
+    {
+      return true;
+    }
+    expected = _decode(e);
+    return false;
+  }
+  //! Compares and exchanges, using `order` for both success and failure.
+  bool compare_exchange_strong(result_type &expected, const result_type &desired, std::memory_order order = std::memory_order_seq_cst) noexcept { return compare_exchange_strong(expected, desired, order, (order == std::memory_order_acq_rel) ? std::memory_order_acquire : (order == std::memory_order_release) ? std::memory_order_relaxed : order); }
+  //! As `compare_exchange_strong()`, which never fails spuriously.
+  bool compare_exchange_weak(result_type &expected, const result_type &desired, std::memory_order success, std::memory_order failure) noexcept { return compare_exchange_strong(expected, desired, success, failure); }
+  //! As `compare_exchange_strong()`, which never fails spuriously.
+  bool compare_exchange_weak(result_type &expected, const result_type &desired, std::memory_order order = std::memory_order_seq_cst) noexcept { return compare_exchange_strong(expected, desired, order); }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  void wait(const result_type &old, std::memory_order order = std::memory_order_seq_cst) const noexcept
+  {
+    const _words_type o = _encode(old);
+    for(unsigned spins = 0; _cell.load(order) == o; spins++)
+    {
+      if(spins < 64)
+      {
+        detail::result_channel_pause();
+        continue;
+      }
+      auto &changed = const_cast<detail::result_channel_event &>(_changed);  // NOLINT
+      const uint32_t epoch = changed.prepare_wait();
+      if(_cell.load(order) == o)
+      {
+        changed.wait(epoch);
+      }
+      changed.cancel_wait();
+    }
+  }
+  //! Wakes every thread blocked in `wait()`, as threads are not woken individually.
+  void notify_one() noexcept { _changed.notify_all(); }
+  //! Wakes every thread blocked in `wait()`.
+  void notify_all() noexcept { _changed.notify_all(); }
+};
+template <class T, class E, class NoValuePolicy> constexpr bool atomic_result<T, E, NoValuePolicy>::is_always_lock_free;
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
@@ -147,26 +147,38 @@ template <class T> using is_basic_outcome = detail::is_basic_outcome<std::decay_
 /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
 */
-template <class T> static constexpr bool is_basic_outcome_v = detail::is_basic_outcome<std::decay_t<T>>::value;
+template <class T> OUTCOME_INLINE_CONSTEXPR bool is_basic_outcome_v = detail::is_basic_outcome<std::decay_t<T>>::value;
 
 namespace hooks
 {
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
 */
-  template <class T, class... U> constexpr inline void hook_outcome_construction(T * /*unused*/, U &&... /*unused*/) noexcept {}
+  template <class T, class... U> constexpr inline void hook_outcome_construction(T *r, U &&... /*unused*/) noexcept
+  {
+    detail::instrument_construction(r);
+  }
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
 */
-  template <class T, class U> constexpr inline void hook_outcome_copy_construction(T * /*unused*/, U && /*unused*/) noexcept {}
+  template <class T, class U> constexpr inline void hook_outcome_copy_construction(T *r, U &&o) noexcept
+  {
+    detail::instrument_copy_or_move_construction(r, o);
+  }
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
 */
-  template <class T, class U> constexpr inline void hook_outcome_move_construction(T * /*unused*/, U && /*unused*/) noexcept {}
+  template <class T, class U> constexpr inline void hook_outcome_move_construction(T *r, U &&o) noexcept
+  {
+    detail::instrument_copy_or_move_construction(r, o);
+  }
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
 */
-  template <class T, class U, class... Args> constexpr inline void hook_outcome_in_place_construction(T * /*unused*/, in_place_type_t<U> /*unused*/, Args &&... /*unused*/) noexcept {}
+  template <class T, class U, class... Args> constexpr inline void hook_outcome_in_place_construction(T *r, in_place_type_t<U> /*unused*/, Args &&... /*unused*/) noexcept
+  {
+    detail::instrument_construction(r);
+  }
 
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
@@ -193,6 +205,8 @@ class OUTCOME_NODISCARD basic_outcome
   using base = detail::select_basic_outcome_failure_observers<detail::basic_outcome_exception_observers<detail::basic_result_final<R, S, NoValuePolicy>, R, S, P, NoValuePolicy>, R, S, P, NoValuePolicy>;
   friend struct policy::base;
   template <class T, class U, class V, class W> friend class basic_outcome;
+  template <class T, class U, class V, class... W> friend struct detail::uses_allocator_constructor;
+  template <class T, class U> friend struct detail::uses_allocator_construction;
   template <class T, class U, class V, class W, class X> friend constexpr inline void hooks::override_outcome_exception(basic_outcome<T, U, V, W> *o, X &&v) noexcept;  // NOLINT
 
   struct implicit_constructors_disabled_tag
@@ -498,6 +512,16 @@ SIGNATURE NOT RECOGNISED
     using namespace hooks;
     hook_outcome_in_place_construction(this, in_place_type<value_type>, il, static_cast<Args &&>(args)...);
   }
+  // Used by the monadic operations to construct the value from what a callable returns without moving it
+  template <class F, class... Args>
+  constexpr basic_outcome(detail::in_place_invoke_tag _, F &&f, Args &&... args)
+      : base{_, static_cast<F &&>(f), static_cast<Args &&>(args)...}
+      , _ptr()
+  {
+    using namespace hooks;
+    hook_outcome_in_place_construction(this, in_place_type<value_type>);
+  }
+
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
 */
@@ -684,6 +708,16 @@ SIGNATURE NOT RECOGNISED
 
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
+*/
+  OUTCOME_TEMPLATE(class Tag, class Alloc, class... Args)
+  OUTCOME_TREQUIRES(OUTCOME_TPRED(detail::uses_allocator_constructor<basic_outcome, Tag, Alloc, Args...>::value))
+  constexpr basic_outcome(Tag _, const Alloc &a, Args &&... args)
+      : basic_outcome(detail::uses_allocator_constructor<basic_outcome, Tag, Alloc, Args...>::construct(_, a, static_cast<Args &&>(args)...))
+  {
+  }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
 */
   using base::operator==;
   using base::operator!=;
@@ -818,18 +852,18 @@ SIGNATURE NOT RECOGNISED
     if((value_throws && !error_throws && !exception_throws) || (!value_throws && !error_throws && !exception_throws))
     {
       this->_state.swap(o._state);
-      swap(this->_error, o._error);
+      this->_msvc_nonpermissive_swap_error(o, true);
       swap(this->_ptr, o._ptr);
     }
     else if(!value_throws && !error_throws && exception_throws)
     {
       swap(this->_ptr, o._ptr);
       this->_state.swap(o._state);
-      swap(this->_error, o._error);
+      this->_msvc_nonpermissive_swap_error(o, true);
     }
     else if(!value_throws && error_throws && !exception_throws)
     {
-      swap(this->_error, o._error);
+      this->_msvc_nonpermissive_swap_error(o, false);
       this->_state.swap(o._state);
       swap(this->_ptr, o._ptr);
     }
@@ -840,7 +874,7 @@ SIGNATURE NOT RECOGNISED
       bool exception_threw = false;
       try
       {
-        swap(this->_error, o._error);
+        this->_msvc_nonpermissive_swap_error(o, true);
         exception_threw = true;
         swap(this->_ptr, o._ptr);
       }
@@ -852,7 +886,7 @@ SIGNATURE NOT RECOGNISED
         {
           if(exception_threw)
           {
-            swap(this->_error, o._error);
+            this->_msvc_nonpermissive_swap_error(o, false);
             error_is_mine = true;
           }
           this->_state.swap(o._state);
@@ -864,7 +898,7 @@ SIGNATURE NOT RECOGNISED
           {
             try
             {
-              swap(this->_error, o._error);
+              this->_msvc_nonpermissive_swap_error(o, true);
               error_is_mine = false;
             }
             catch(...)
@@ -904,7 +938,7 @@ SIGNATURE NOT RECOGNISED
 #endif
 #else
     this->_state.swap(o._state);
-    swap(this->_error, o._error);
+    this->_msvc_nonpermissive_swap_error(o, true);
     swap(this->_ptr, o._ptr);
 #endif
   }
@@ -940,6 +974,170 @@ SIGNATURE NOT RECOGNISED
     }
     return failure_type<error_type, exception_type>(in_place_type<error_type>, static_cast<S &&>(this->assume_error()));
   }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class U> constexpr value_type value_or(U &&v) const &
+  {
+    if(this->has_value())
+    {
+      return this->assume_value();
+    }
+    return static_cast<value_type>(static_cast<U &&>(v));
+  }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class U> constexpr value_type value_or(U &&v) &&
+  {
+    if(this->has_value())
+    {
+      return static_cast<basic_outcome &&>(*this).assume_value();
+    }
+    return static_cast<value_type>(static_cast<U &&>(v));
+  }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map(F &&f) & { return _map(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map(F &&f) const & { return _map(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map(F &&f) && { return _map(static_cast<basic_outcome &&>(*this), static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map(F &&f) const && { return _map(static_cast<const basic_outcome &&>(*this), static_cast<F &&>(f)); }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto and_then(F &&f) & { return _and_then(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto and_then(F &&f) const & { return _and_then(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto and_then(F &&f) && { return _and_then(static_cast<basic_outcome &&>(*this), static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto and_then(F &&f) const && { return _and_then(static_cast<const basic_outcome &&>(*this), static_cast<F &&>(f)); }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto or_else(F &&f) & { return _or_else(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto or_else(F &&f) const & { return _or_else(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto or_else(F &&f) && { return _or_else(static_cast<basic_outcome &&>(*this), static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto or_else(F &&f) const && { return _or_else(static_cast<const basic_outcome &&>(*this), static_cast<F &&>(f)); }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map_error(F &&f) & { return _map_error(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map_error(F &&f) const & { return _map_error(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map_error(F &&f) && { return _map_error(static_cast<basic_outcome &&>(*this), static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map_error(F &&f) const && { return _map_error(static_cast<const basic_outcome &&>(*this), static_cast<F &&>(f)); }
+
+protected:
+  // The monadic operations construct their returned outcome in place, moving the payload of an rvalue input.
+  // Failures are propagated with any exception, and or_else() and map_error() only see the error.
+  template <class U> using _monadic_rebind_value = rebind<U, S, P, detail::rebind_policy_t<NoValuePolicy, U, S>>;
+  template <class G> using _monadic_rebind_error = rebind<R, G, P, detail::rebind_policy_t<NoValuePolicy, R, G>>;
+  template <class Self, class F> static constexpr auto _map(Self &&self, F &&f)
+  {
+    using mapped_type = std::remove_cv_t<std::remove_reference_t<detail::invoke_with_value_t<F, Self>>>;
+    using result_type = _monadic_rebind_value<mapped_type>;
+    if(self.has_value())
+    {
+      return detail::monadic_mapped_value<result_type>(static_cast<F &&>(f), static_cast<Self &&>(self), std::is_void<mapped_type>());
+    }
+    return result_type(static_cast<Self &&>(self).as_failure());
+  }
+  template <class Self, class F> static constexpr auto _and_then(Self &&self, F &&f)
+  {
+    using result_type = std::decay_t<detail::invoke_with_value_t<F, Self>>;
+    if(self.has_value())
+    {
+      return result_type(detail::invoke_with_value(static_cast<F &&>(f), static_cast<Self &&>(self), std::is_void<value_type>()));
+    }
+    return result_type(static_cast<Self &&>(self).as_failure());
+  }
+  template <class Self, class F> static constexpr auto _or_else(Self &&self, F &&f)
+  {
+    using result_type = std::decay_t<detail::invoke_with_error_t<F, Self>>;
+    if(self.has_value())
+    {
+      return detail::monadic_value<result_type>(static_cast<Self &&>(self), std::is_void<value_type>());
+    }
+    return _or_else_failure<result_type>(static_cast<Self &&>(self), static_cast<F &&>(f), std::is_void<exception_type>());
+  }
+  template <class Result, class Self, class F> static constexpr Result _or_else_failure(Self &&self, F &&f, std::true_type /*void exception*/)
+  {
+    return Result(detail::invoke_with_error(static_cast<F &&>(f), static_cast<Self &&>(self), std::is_void<error_type>()));
+  }
+  template <class Result, class Self, class F> static constexpr Result _or_else_failure(Self &&self, F &&f, std::false_type /*void exception*/)
+  {
+    if(self.has_error())
+    {
+      return Result(detail::invoke_with_error(static_cast<F &&>(f), static_cast<Self &&>(self), std::is_void<error_type>()));
+    }
+    return Result{in_place_type<typename Result::exception_type>, static_cast<Self &&>(self).assume_exception()};
+  }
+  template <class Self, class F> static constexpr auto _map_error(Self &&self, F &&f)
+  {
+    using mapped_type = std::remove_cv_t<std::remove_reference_t<detail::invoke_with_error_t<F, Self>>>;
+    using result_type = _monadic_rebind_error<mapped_type>;
+    if(self.has_value())
+    {
+      return detail::monadic_value<result_type>(static_cast<Self &&>(self), std::is_void<value_type>());
+    }
+    return _map_error_failure<result_type>(static_cast<Self &&>(self), static_cast<F &&>(f), std::is_void<exception_type>());
+  }
+  template <class Result, class Self, class F> static constexpr Result _map_error_failure(Self &&self, F &&f, std::true_type /*void exception*/)
+  {
+    return detail::monadic_mapped_error<Result>(static_cast<F &&>(f), static_cast<Self &&>(self), std::is_void<typename Result::error_type>());
+  }
+  template <class Result, class Self, class F> static constexpr Result _map_error_failure(Self &&self, F &&f, std::false_type /*void exception*/)
+  {
+    if(!self.has_exception())
+    {
+      return detail::monadic_mapped_error<Result>(static_cast<F &&>(f), static_cast<Self &&>(self), std::is_void<typename Result::error_type>());
+    }
+    if(!self.has_error())
+    {
+      return Result{in_place_type<exception_type>, static_cast<Self &&>(self).assume_exception()};
+    }
+    // Invoking f cannot move the exception, only the error
+    return Result{failure_type<typename Result::error_type, exception_type>(detail::invoke_with_error(static_cast<F &&>(f), static_cast<Self &&>(self), std::is_void<error_type>()), static_cast<Self &&>(self).assume_exception())};
+  }
 };
 
 /*! AWAITING HUGO JSON CONVERSION TOOL
@@ -984,8 +1182,107 @@ SIGNATURE NOT RECOGNISED
   }
 }  // namespace hooks
 
+namespace detail
+{
+  // The allocator extended constructors of basic_outcome. Only the value or error is ever given the allocator, and
+  // constructions of just the exception are forwarded unchanged.
+  template <class T, class E, class P, class NoValuePolicy, class Alloc, class... Args>
+  struct uses_allocator_constructor<basic_outcome<T, E, P, NoValuePolicy>, std::allocator_arg_t, Alloc, Args...> : uses_allocator_construction<basic_outcome<T, E, P, NoValuePolicy>, Alloc>
+  {
+    using _base = uses_allocator_construction<basic_outcome<T, E, P, NoValuePolicy>, Alloc>;
+    using R = basic_outcome<T, E, P, NoValuePolicy>;
+    using exception_type = typename R::exception_type;
+    using error_type_if_enabled = typename R::error_type_if_enabled;
+    using predicate = typename _base::predicate;
+    using _base::construct;
+
+    struct outcome_copy_tag
+    {
+    };
+    struct outcome_failure_tag
+    {
+    };
+    struct exception_tag
+    {
+    };
+
+    // Predicate for the allocator extended construction of C, which is value_type, error_type or exception_type, to be available.
+    template <class C, class... Xs> static constexpr bool enable_inplace_constructor = std::is_same<C, exception_type>::value || _base::template enable_inplace_constructor<C, Xs...>;
+
+    OUTCOME_TEMPLATE(class Self)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(_base::template enable_copy_constructor<Self, is_basic_outcome<std::decay_t<Self>>::value>::value))
+    static R construct(const std::allocator_arg_t &_, const Alloc &a, Self &&o, outcome_copy_tag /*unused*/ = outcome_copy_tag())
+    {
+      if(o.has_value() || !o.has_error())
+      {
+        // Anything without an error is copied by the base overload for results, or has nothing to give the allocator
+        R ret(o.has_value() ? _base::_from_value(_, a, static_cast<Self &&>(o), std::is_void<typename R::value_type>()) : R(static_cast<Self &&>(o)));
+        hooks::set_spare_storage(&ret, hooks::spare_storage(&o));
+        return ret;
+      }
+      R ret(_base::_from_error(_, a, static_cast<Self &&>(o), std::is_void<typename R::error_type>()));
+      if(o.has_exception())
+      {
+        hooks::override_outcome_exception(&ret, static_cast<Self &&>(o).assume_exception());
+      }
+      hooks::set_spare_storage(&ret, hooks::spare_storage(&o));
+      return ret;
+    }
+    OUTCOME_TEMPLATE(class X)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(is_failure_type<std::decay_t<X>>::value && !std::is_void<typename std::decay_t<X>::exception_type>::value &&_base::template enable_failure_constructor<X>::value))
+    static R construct(const std::allocator_arg_t &_, const Alloc &a, X &&x, outcome_failure_tag /*unused*/ = outcome_failure_tag())
+    {
+      if(!x.has_error())
+      {
+        return R(static_cast<X &&>(x));
+      }
+      R ret(construct(_, a, in_place_type<error_type_if_enabled>, static_cast<X &&>(x).error()));
+      if(x.has_exception())
+      {
+        hooks::override_outcome_exception(&ret, static_cast<X &&>(x).exception());
+      }
+      return ret;
+    }
+    OUTCOME_TEMPLATE(class X)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(predicate::template enable_exception_converting_constructor<X> || (is_failure_type<std::decay_t<X>>::value && std::is_constructible<R, X>::value && !_base::template enable_failure_constructor<X>::value)))
+    static constexpr R construct(const std::allocator_arg_t & /*unused*/, const Alloc & /*unused*/, X &&x, exception_tag /*unused*/ = exception_tag()) { return R(static_cast<X &&>(x)); }
+    OUTCOME_TEMPLATE(class X, class Y)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(predicate::template enable_error_exception_converting_constructor<X, Y> &&_base::template enable_error_constructor<X>))
+    static R construct(const std::allocator_arg_t &_, const Alloc &a, X &&x, Y &&y)
+    {
+      R ret(construct(_, a, in_place_type<error_type_if_enabled>, static_cast<X &&>(x)));
+      hooks::override_outcome_exception(&ret, static_cast<Y &&>(y));
+      return ret;
+    }
+    OUTCOME_TEMPLATE(class A1, class A2, class... Xs)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(predicate::template enable_inplace_value_error_exception_constructor<A1, A2, Xs...> && !(sizeof...(Xs) == 0 && predicate::template enable_error_exception_converting_constructor<A1, A2>)  //
+                                    && enable_inplace_constructor<typename predicate::template choose_inplace_value_error_exception_constructor<A1, A2, Xs...>, A1, A2, Xs...>))
+    static constexpr R construct(const std::allocator_arg_t &_, const Alloc &a, A1 &&a1, A2 &&a2, Xs &&... xs)
+    {
+      using choice = typename predicate::template choose_inplace_value_error_exception_constructor<A1, A2, Xs...>;
+      return _inplace<choice>(std::is_same<choice, exception_type>(), _, a, static_cast<A1 &&>(a1), static_cast<A2 &&>(a2), static_cast<Xs &&>(xs)...);
+    }
+
+    template <class C, class... Xs> static constexpr R _inplace(std::false_type /*exception*/, const std::allocator_arg_t &_, const Alloc &a, Xs &&... xs) { return construct(_, a, in_place_type<C>, static_cast<Xs &&>(xs)...); }
+    template <class C, class... Xs> static constexpr R _inplace(std::true_type /*exception*/, const std::allocator_arg_t & /*unused*/, const Alloc & /*unused*/, Xs &&... xs) { return R(in_place_type<C>, static_cast<Xs &&>(xs)...); }
+
+    template <class... Xs> static constexpr std::true_type _enabled(decltype(construct(std::declval<Xs>()...)) * /*unused*/) { return {}; }
+    template <class... Xs> static constexpr std::false_type _enabled(...) { return {}; }
+    static constexpr bool value = decltype(_enabled<std::allocator_arg_t, const Alloc &, Args...>(nullptr))::value;
+  };
+}  // namespace detail
+
 OUTCOME_V2_NAMESPACE_END
 
+namespace std
+{
+  //! A basic_outcome uses an allocator if its value or its error does. Its exception is never given the allocator.
+  template <class R, class S, class P, class NoValuePolicy, class Alloc>
+  struct uses_allocator<OUTCOME_V2_NAMESPACE::basic_outcome<R, S, P, NoValuePolicy>, Alloc> : integral_constant<bool, uses_allocator<R, Alloc>::value || uses_allocator<S, Alloc>::value>
+  {
+  };
+}  // namespace std
+
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
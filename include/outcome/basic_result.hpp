@@ -28,10 +28,32 @@ http://www.boost.org/LICENSE_1_0.txt)
 #include "config.hpp"
 #include "convert.hpp"
 #include "detail/basic_result_final.hpp"
+#include "detail/monadic.hpp"
 
 #include "policy/all_narrow.hpp"
 #include "policy/terminate.hpp"
 
+#include "detail/instrumentation.hpp"
+
+// Uses-allocator construction needs only std::allocator_arg_t and std::uses_allocator, not all of <memory>.
+// Where the standard library's namespace is known they are forward declared, keeping this header light.
+#if defined(__GLIBCXX__)
+namespace std
+{
+  _GLIBCXX_BEGIN_NAMESPACE_VERSION
+  struct allocator_arg_t;
+  template <class T, class Alloc> struct uses_allocator;
+  _GLIBCXX_END_NAMESPACE_VERSION
+}  // namespace std
+#elif defined(_LIBCPP_VERSION)
+_LIBCPP_BEGIN_NAMESPACE_STD
+struct allocator_arg_t;
+template <class T, class Alloc> struct uses_allocator;
+_LIBCPP_END_NAMESPACE_STD
+#else
+#include <memory>  // for std::allocator_arg_t and std::uses_allocator
+#endif
+
 #ifdef __clang__
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wdocumentation"  // Standardese markup confuses clang
@@ -119,6 +141,14 @@ namespace detail
   template <class T, class U, class V> constexpr inline U &&extract_error_from_failure(failure_type<U, V> &&v) { return static_cast<failure_type<U, V> &&>(v).error(); }
   template <class T, class V> constexpr inline T extract_error_from_failure(const failure_type<void, V> & /*unused*/) { return T{}; }
 
+  // Allocator extended construction of a result or outcome R, for which basic_result and basic_outcome specialise
+  // this with Tag = std::allocator_arg_t.
+  template <class R, class Tag, class Alloc, class... Args> struct uses_allocator_constructor
+  {
+    static constexpr bool value = false;
+  };
+  template <class R, class Alloc> struct uses_allocator_construction;
+
   template <class T> struct is_basic_result
   {
     static constexpr bool value = false;
@@ -136,7 +166,7 @@ template <class T> using is_basic_result = detail::is_basic_result<std::decay_t<
 /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
 */
-template <class T> static constexpr bool is_basic_result_v = detail::is_basic_result<std::decay_t<T>>::value;
+template <class T> OUTCOME_INLINE_CONSTEXPR bool is_basic_result_v = detail::is_basic_result<std::decay_t<T>>::value;
 
 /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
@@ -146,19 +176,31 @@ namespace hooks
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
 */
-  template <class T, class U> constexpr inline void hook_result_construction(T * /*unused*/, U && /*unused*/) noexcept {}
+  template <class T, class U> constexpr inline void hook_result_construction(T *r, U && /*unused*/) noexcept
+  {
+    detail::instrument_construction(r);
+  }
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
 */
-  template <class T, class U> constexpr inline void hook_result_copy_construction(T * /*unused*/, U && /*unused*/) noexcept {}
+  template <class T, class U> constexpr inline void hook_result_copy_construction(T *r, U &&o) noexcept
+  {
+    detail::instrument_copy_or_move_construction(r, o);
+  }
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
 */
-  template <class T, class U> constexpr inline void hook_result_move_construction(T * /*unused*/, U && /*unused*/) noexcept {}
+  template <class T, class U> constexpr inline void hook_result_move_construction(T *r, U &&o) noexcept
+  {
+    detail::instrument_copy_or_move_construction(r, o);
+  }
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
 */
-  template <class T, class U, class... Args> constexpr inline void hook_result_in_place_construction(T * /*unused*/, in_place_type_t<U> /*unused*/, Args &&... /*unused*/) noexcept {}
+  template <class T, class U, class... Args> constexpr inline void hook_result_in_place_construction(T *r, in_place_type_t<U> /*unused*/, Args &&... /*unused*/) noexcept
+  {
+    detail::instrument_construction(r);
+  }
 
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
@@ -184,6 +226,8 @@ class OUTCOME_NODISCARD basic_result : public detail::basic_result_final<R, S, N
   static_assert(std::is_void<S>::value || std::is_default_constructible<S>::value, "The type S must be void or default constructible");
 
   using base = detail::basic_result_final<R, S, NoValuePolicy>;
+  template <class T, class U, class V, class... W> friend struct detail::uses_allocator_constructor;
+  template <class T, class U> friend struct detail::uses_allocator_construction;
 
   struct implicit_constructors_disabled_tag
   {
@@ -403,6 +447,15 @@ SIGNATURE NOT RECOGNISED
     using namespace hooks;
     hook_result_in_place_construction(this, in_place_type<value_type>, il, static_cast<Args &&>(args)...);
   }
+  // Used by the monadic operations to construct the value from what a callable returns without moving it
+  template <class F, class... Args>
+  constexpr basic_result(detail::in_place_invoke_tag _, F &&f, Args &&... args)
+      : base{_, static_cast<F &&>(f), static_cast<Args &&>(args)...}
+  {
+    using namespace hooks;
+    hook_result_in_place_construction(this, in_place_type<value_type>);
+  }
+
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
 */
@@ -496,6 +549,16 @@ SIGNATURE NOT RECOGNISED
 
   /*! AWAITING HUGO JSON CONVERSION TOOL
 SIGNATURE NOT RECOGNISED
+*/
+  OUTCOME_TEMPLATE(class Tag, class Alloc, class... Args)
+  OUTCOME_TREQUIRES(OUTCOME_TPRED(detail::uses_allocator_constructor<basic_result, Tag, Alloc, Args...>::value))
+  constexpr basic_result(Tag _, const Alloc &a, Args &&... args)
+      : basic_result(detail::uses_allocator_constructor<basic_result, Tag, Alloc, Args...>::construct(_, a, static_cast<Args &&>(args)...))
+  {
+  }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
 */
   constexpr void swap(basic_result &o) noexcept(detail::is_nothrow_swappable<value_type>::value &&std::is_nothrow_move_constructible<value_type>::value  //
                                                 &&detail::is_nothrow_swappable<error_type>::value &&std::is_nothrow_move_constructible<error_type>::value)
@@ -514,6 +577,140 @@ SIGNATURE NOT RECOGNISED
 SIGNATURE NOT RECOGNISED
 */
   auto as_failure() && { return failure(static_cast<basic_result &&>(*this).assume_error()); }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class U> constexpr value_type value_or(U &&v) const &
+  {
+    if(this->has_value())
+    {
+      return this->assume_value();
+    }
+    return static_cast<value_type>(static_cast<U &&>(v));
+  }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class U> constexpr value_type value_or(U &&v) &&
+  {
+    if(this->has_value())
+    {
+      return static_cast<basic_result &&>(*this).assume_value();
+    }
+    return static_cast<value_type>(static_cast<U &&>(v));
+  }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map(F &&f) & { return _map(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map(F &&f) const & { return _map(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map(F &&f) && { return _map(static_cast<basic_result &&>(*this), static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map(F &&f) const && { return _map(static_cast<const basic_result &&>(*this), static_cast<F &&>(f)); }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto and_then(F &&f) & { return _and_then(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto and_then(F &&f) const & { return _and_then(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto and_then(F &&f) && { return _and_then(static_cast<basic_result &&>(*this), static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto and_then(F &&f) const && { return _and_then(static_cast<const basic_result &&>(*this), static_cast<F &&>(f)); }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto or_else(F &&f) & { return _or_else(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto or_else(F &&f) const & { return _or_else(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto or_else(F &&f) && { return _or_else(static_cast<basic_result &&>(*this), static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto or_else(F &&f) const && { return _or_else(static_cast<const basic_result &&>(*this), static_cast<F &&>(f)); }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map_error(F &&f) & { return _map_error(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map_error(F &&f) const & { return _map_error(*this, static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map_error(F &&f) && { return _map_error(static_cast<basic_result &&>(*this), static_cast<F &&>(f)); }
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class F> constexpr auto map_error(F &&f) const && { return _map_error(static_cast<const basic_result &&>(*this), static_cast<F &&>(f)); }
+
+protected:
+  // The monadic operations construct their returned result in place, moving the payload of an rvalue input
+  template <class U> using _monadic_rebind_value = rebind<U, S, detail::rebind_policy_t<NoValuePolicy, U, S>>;
+  template <class G> using _monadic_rebind_error = rebind<R, G, detail::rebind_policy_t<NoValuePolicy, R, G>>;
+  template <class Self, class F> static constexpr auto _map(Self &&self, F &&f)
+  {
+    using mapped_type = std::remove_cv_t<std::remove_reference_t<detail::invoke_with_value_t<F, Self>>>;
+    using result_type = _monadic_rebind_value<mapped_type>;
+    if(self.has_value())
+    {
+      return detail::monadic_mapped_value<result_type>(static_cast<F &&>(f), static_cast<Self &&>(self), std::is_void<mapped_type>());
+    }
+    return detail::monadic_error<result_type>(static_cast<Self &&>(self), std::is_void<error_type>());
+  }
+  template <class Self, class F> static constexpr auto _and_then(Self &&self, F &&f)
+  {
+    using result_type = std::decay_t<detail::invoke_with_value_t<F, Self>>;
+    if(self.has_value())
+    {
+      return result_type(detail::invoke_with_value(static_cast<F &&>(f), static_cast<Self &&>(self), std::is_void<value_type>()));
+    }
+    return detail::monadic_error<result_type>(static_cast<Self &&>(self), std::is_void<error_type>());
+  }
+  template <class Self, class F> static constexpr auto _or_else(Self &&self, F &&f)
+  {
+    using result_type = std::decay_t<detail::invoke_with_error_t<F, Self>>;
+    if(self.has_value())
+    {
+      return detail::monadic_value<result_type>(static_cast<Self &&>(self), std::is_void<value_type>());
+    }
+    return result_type(detail::invoke_with_error(static_cast<F &&>(f), static_cast<Self &&>(self), std::is_void<error_type>()));
+  }
+  template <class Self, class F> static constexpr auto _map_error(Self &&self, F &&f)
+  {
+    using mapped_type = std::remove_cv_t<std::remove_reference_t<detail::invoke_with_error_t<F, Self>>>;
+    using result_type = _monadic_rebind_error<mapped_type>;
+    if(self.has_value())
+    {
+      return detail::monadic_value<result_type>(static_cast<Self &&>(self), std::is_void<value_type>());
+    }
+    return detail::monadic_mapped_error<result_type>(static_cast<F &&>(f), static_cast<Self &&>(self), std::is_void<mapped_type>());
+  }
 };
 
 /*! AWAITING HUGO JSON CONVERSION TOOL
@@ -539,8 +736,197 @@ static_assert(std::is_trivially_move_assignable<basic_result<int, long, policy::
 static_assert(std::is_standard_layout<basic_result<int, long, policy::all_narrow>>::value, "result<int> is not a standard layout type!");
 #endif
 
+namespace detail
+{
+  // How uses-allocator construction passes an Alloc when constructing a T from Args: not at all, first after
+  // std::allocator_arg, or last. Never if T cannot be constructed from Args.
+  enum class uses_allocator_form
+  {
+    none,
+    leading,
+    trailing,
+    never
+  };
+  template <class T, class Alloc, class... Args>
+  struct uses_allocator_form_of
+      : std::integral_constant<uses_allocator_form,                                                                                                                                      //
+                               std::is_void<T>::value ? (sizeof...(Args) == 0 ? uses_allocator_form::none : uses_allocator_form::never)                                                  //
+                               : !std::uses_allocator<T, Alloc>::value ? (std::is_constructible<T, Args...>::value ? uses_allocator_form::none : uses_allocator_form::never)              //
+                               : std::is_constructible<T, std::allocator_arg_t, const Alloc &, Args...>::value ? uses_allocator_form::leading                                             //
+                               : std::is_constructible<T, Args..., const Alloc &>::value ? uses_allocator_form::trailing : uses_allocator_form::never>
+  {
+  };
+  template <uses_allocator_form form> struct uses_allocator_tag
+  {
+  };
+
+  // The allocator extended constructors which basic_result and basic_outcome R share. Each constructs the value
+  // or error in place, passing it the allocator, so nothing is first constructed without the allocator.
+  template <class R, class Alloc> struct uses_allocator_construction
+  {
+    using value_type = typename R::value_type;
+    using error_type = typename R::error_type;
+    using value_type_if_enabled = typename R::value_type_if_enabled;
+    using error_type_if_enabled = typename R::error_type_if_enabled;
+    using predicate = typename R::predicate;
+
+    struct copy_tag
+    {
+    };
+    struct success_tag
+    {
+    };
+    struct failure_tag
+    {
+    };
+    struct value_converting_tag
+    {
+    };
+    struct error_converting_tag
+    {
+    };
+    struct error_condition_converting_tag
+    {
+    };
+
+    // Predicate for the allocator extended inplace construction of value to be available.
+    template <class... Xs>
+    static constexpr bool enable_value_constructor =  //
+    predicate::constructors_enabled                   //
+    && uses_allocator_form_of<value_type, Alloc, Xs...>::value != uses_allocator_form::never;
+
+    // Predicate for the allocator extended inplace construction of error to be available.
+    template <class... Xs>
+    static constexpr bool enable_error_constructor =  //
+    predicate::constructors_enabled                   //
+    && uses_allocator_form_of<error_type, Alloc, Xs...>::value != uses_allocator_form::never;
+
+    // Predicate for the allocator extended inplace construction of C, which is value_type or error_type, to be available.
+    template <class C, class... Xs> static constexpr bool enable_inplace_constructor = std::is_same<C, value_type>::value ? enable_value_constructor<Xs...> : enable_error_constructor<Xs...>;
+
+    // Predicate for the allocator extended construction from the value or error of Self, if IsResult, to be available.
+    template <class Self, bool IsResult> struct enable_copy_constructor
+    {
+      static constexpr bool value = false;
+    };
+    template <class Self> struct enable_copy_constructor<Self, true>
+    {
+      static constexpr bool value =                                                                                                                 //
+      std::is_constructible<R, Self>::value                                                                                                         //
+      && (std::is_void<value_type>::value ? enable_value_constructor<> : enable_value_constructor<decltype(std::declval<Self>().assume_value())>)  //
+      && (std::is_void<error_type>::value ? enable_error_constructor<> : enable_error_constructor<decltype(std::declval<Self>().assume_error())>);
+    };
+
+    // Whether the value of success_type X, or the error of failure_type X, can be given the allocator.
+    template <class X, bool IsVoid = std::is_void<typename std::decay_t<X>::value_type>::value> struct _enable_success_value
+    {
+      static constexpr bool value = enable_value_constructor<decltype(std::declval<X>().value())>;
+    };
+    template <class X> struct _enable_success_value<X, true>
+    {
+      static constexpr bool value = enable_value_constructor<>;
+    };
+    template <class X, bool IsVoid = std::is_void<typename std::decay_t<X>::error_type>::value> struct _enable_failure_error
+    {
+      static constexpr bool value = enable_error_constructor<decltype(std::declval<X>().error())>;
+    };
+    template <class X> struct _enable_failure_error<X, true>
+    {
+      static constexpr bool value = false;
+    };
+
+    // Predicate for the allocator extended construction of value from X, if a success_type, to be available.
+    template <class X, bool IsSuccess = is_success_type<std::decay_t<X>>::value> struct enable_success_constructor
+    {
+      static constexpr bool value = false;
+    };
+    template <class X> struct enable_success_constructor<X, true>
+    {
+      static constexpr bool value = std::is_constructible<R, X>::value && _enable_success_value<X>::value;
+    };
+
+    // Predicate for the allocator extended construction of error from X, if a failure_type, to be available.
+    template <class X, bool IsFailure = is_failure_type<std::decay_t<X>>::value> struct enable_failure_constructor
+    {
+      static constexpr bool value = false;
+    };
+    template <class X> struct enable_failure_constructor<X, true>
+    {
+      static constexpr bool value = std::is_constructible<R, X>::value && _enable_failure_error<X>::value;
+    };
+
+    OUTCOME_TEMPLATE(class... Xs)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(enable_value_constructor<Xs...>))
+    static constexpr R construct(const std::allocator_arg_t &t, const Alloc &a, in_place_type_t<value_type_if_enabled> _, Xs &&... xs) { return _make(uses_allocator_tag<uses_allocator_form_of<value_type, Alloc, Xs...>::value>(), t, a, _, static_cast<Xs &&>(xs)...); }
+    OUTCOME_TEMPLATE(class... Xs)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(enable_error_constructor<Xs...>))
+    static constexpr R construct(const std::allocator_arg_t &t, const Alloc &a, in_place_type_t<error_type_if_enabled> _, Xs &&... xs) { return _make(uses_allocator_tag<uses_allocator_form_of<error_type, Alloc, Xs...>::value>(), t, a, _, static_cast<Xs &&>(xs)...); }
+    OUTCOME_TEMPLATE(class Self)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(enable_copy_constructor<Self, is_basic_result<std::decay_t<Self>>::value>::value))
+    static constexpr R construct(const std::allocator_arg_t &_, const Alloc &a, Self &&o, copy_tag /*unused*/ = copy_tag())
+    {
+      R ret(o.has_value() ? _from_value(_, a, static_cast<Self &&>(o), std::is_void<value_type>()) : _from_error(_, a, static_cast<Self &&>(o), std::is_void<error_type>()));
+      hooks::set_spare_storage(&ret, hooks::spare_storage(&o));
+      return ret;
+    }
+    OUTCOME_TEMPLATE(class X)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(is_success_type<std::decay_t<X>>::value &&enable_success_constructor<X>::value))
+    static constexpr R construct(const std::allocator_arg_t &_, const Alloc &a, X &&x, success_tag /*unused*/ = success_tag()) { return _from_success(_, a, static_cast<X &&>(x), std::is_void<typename std::decay_t<X>::value_type>()); }
+    OUTCOME_TEMPLATE(class X)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(is_failure_type<std::decay_t<X>>::value &&std::is_void<typename std::decay_t<X>::exception_type>::value &&enable_failure_constructor<X>::value))
+    static constexpr R construct(const std::allocator_arg_t &_, const Alloc &a, X &&x, failure_tag /*unused*/ = failure_tag()) { return construct(_, a, in_place_type<error_type_if_enabled>, static_cast<X &&>(x).error()); }
+    OUTCOME_TEMPLATE(class T)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(predicate::template enable_value_converting_constructor<T> &&enable_value_constructor<T>))
+    static constexpr R construct(const std::allocator_arg_t &_, const Alloc &a, T &&t, value_converting_tag /*unused*/ = value_converting_tag()) { return construct(_, a, in_place_type<value_type_if_enabled>, static_cast<T &&>(t)); }
+    OUTCOME_TEMPLATE(class T)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(predicate::template enable_error_converting_constructor<T> &&enable_error_constructor<T>))
+    static constexpr R construct(const std::allocator_arg_t &_, const Alloc &a, T &&t, error_converting_tag /*unused*/ = error_converting_tag()) { return construct(_, a, in_place_type<error_type_if_enabled>, static_cast<T &&>(t)); }
+    OUTCOME_TEMPLATE(class ErrorCondEnum)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(predicate::template enable_error_condition_converting_constructor<ErrorCondEnum> &&enable_error_constructor<decltype(make_error_code(std::declval<ErrorCondEnum>()))>))
+    static constexpr R construct(const std::allocator_arg_t &_, const Alloc &a, ErrorCondEnum &&t, error_condition_converting_tag /*unused*/ = error_condition_converting_tag()) { return construct(_, a, in_place_type<error_type_if_enabled>, make_error_code(t)); }
+
+    template <class Tag, class... Xs> static constexpr R _make(uses_allocator_tag<uses_allocator_form::none> /*unused*/, const std::allocator_arg_t & /*unused*/, const Alloc & /*unused*/, Tag _, Xs &&... xs) { return R(_, static_cast<Xs &&>(xs)...); }
+    template <class Tag, class... Xs> static constexpr R _make(uses_allocator_tag<uses_allocator_form::leading> /*unused*/, const std::allocator_arg_t &t, const Alloc &a, Tag _, Xs &&... xs) { return R(_, t, a, static_cast<Xs &&>(xs)...); }
+    template <class Tag, class... Xs> static constexpr R _make(uses_allocator_tag<uses_allocator_form::trailing> /*unused*/, const std::allocator_arg_t & /*unused*/, const Alloc &a, Tag _, Xs &&... xs) { return R(_, static_cast<Xs &&>(xs)..., a); }
+
+    template <class Self> static constexpr R _from_value(const std::allocator_arg_t &_, const Alloc &a, Self &&o, std::false_type /*void value*/) { return construct(_, a, in_place_type<value_type_if_enabled>, static_cast<Self &&>(o).assume_value()); }
+    template <class Self> static constexpr R _from_value(const std::allocator_arg_t &_, const Alloc &a, Self && /*unused*/, std::true_type /*void value*/) { return construct(_, a, in_place_type<value_type_if_enabled>); }
+    template <class Self> static constexpr R _from_error(const std::allocator_arg_t &_, const Alloc &a, Self &&o, std::false_type /*void error*/) { return construct(_, a, in_place_type<error_type_if_enabled>, static_cast<Self &&>(o).assume_error()); }
+    template <class Self> static constexpr R _from_error(const std::allocator_arg_t &_, const Alloc &a, Self && /*unused*/, std::true_type /*void error*/) { return construct(_, a, in_place_type<error_type_if_enabled>); }
+    template <class X> static constexpr R _from_success(const std::allocator_arg_t &_, const Alloc &a, X &&x, std::false_type /*void value*/) { return construct(_, a, in_place_type<value_type_if_enabled>, static_cast<X &&>(x).value()); }
+    template <class X> static constexpr R _from_success(const std::allocator_arg_t &_, const Alloc &a, X && /*unused*/, std::true_type /*void value*/) { return construct(_, a, in_place_type<value_type_if_enabled>); }
+  };
+
+  // The allocator extended constructors of basic_result. Only the value or error is ever given the allocator.
+  template <class T, class E, class NoValuePolicy, class Alloc, class... Args>
+  struct uses_allocator_constructor<basic_result<T, E, NoValuePolicy>, std::allocator_arg_t, Alloc, Args...> : uses_allocator_construction<basic_result<T, E, NoValuePolicy>, Alloc>
+  {
+    using _base = uses_allocator_construction<basic_result<T, E, NoValuePolicy>, Alloc>;
+    using R = basic_result<T, E, NoValuePolicy>;
+    using predicate = typename _base::predicate;
+    using _base::construct;
+
+    OUTCOME_TEMPLATE(class A1, class A2, class... Xs)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(predicate::template enable_inplace_value_error_constructor<A1, A2, Xs...> &&_base::template enable_inplace_constructor<typename predicate::template choose_inplace_value_error_constructor<A1, A2, Xs...>, A1, A2, Xs...>))
+    static constexpr R construct(const std::allocator_arg_t &_, const Alloc &a, A1 &&a1, A2 &&a2, Xs &&... xs) { return construct(_, a, in_place_type<typename predicate::template choose_inplace_value_error_constructor<A1, A2, Xs...>>, static_cast<A1 &&>(a1), static_cast<A2 &&>(a2), static_cast<Xs &&>(xs)...); }
+
+    template <class... Xs> static constexpr std::true_type _enabled(decltype(construct(std::declval<Xs>()...)) * /*unused*/) { return {}; }
+    template <class... Xs> static constexpr std::false_type _enabled(...) { return {}; }
+    static constexpr bool value = decltype(_enabled<std::allocator_arg_t, const Alloc &, Args...>(nullptr))::value;
+  };
+}  // namespace detail
+
 OUTCOME_V2_NAMESPACE_END
 
+namespace std
+{
+  //! A basic_result uses an allocator if its value or its error does.
+  template <class R, class S, class NoValuePolicy, class Alloc>
+  struct uses_allocator<OUTCOME_V2_NAMESPACE::basic_result<R, S, NoValuePolicy>, Alloc> : integral_constant<bool, uses_allocator<R, Alloc>::value || uses_allocator<S, Alloc>::value>
+  {
+  };
+}  // namespace std
+
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
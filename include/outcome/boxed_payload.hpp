@@ -0,0 +1,268 @@
+/* An error code with a refcounted, pool allocated payload
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_BOXED_PAYLOAD_HPP
+#define OUTCOME_BOXED_PAYLOAD_HPP
+
+#include "detail/error_wrapper.hpp"
+
+#include <atomic>
+#include <new>
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+namespace detail
+{
+  // The side block holding the payload, shared between copies of a boxed_payload
+  template <class Payload> struct boxed_payload_block
+  {
+    std::atomic<unsigned> refcount{1};
+    Payload payload;
+
+    template <class... Args, std::enable_if_t<std::is_constructible<Payload, Args...>::value, bool> = true>
+    explicit boxed_payload_block(Args &&... args)
+        : payload(static_cast<Args &&>(args)...)
+    {
+    }
+    // Aggregate payloads are brace initialised
+    template <class... Args, std::enable_if_t<!std::is_constructible<Payload, Args...>::value, bool> = true>
+    explicit boxed_payload_block(Args &&... args)
+        : payload{static_cast<Args &&>(args)...}
+    {
+    }
+  };
+
+  /* A per thread cache of freed side blocks of one size, so failing in a loop does not keep calling
+  the allocator. Blocks freed by another thread join that thread's cache.
+  */
+  template <size_t Bytes> struct boxed_payload_pool
+  {
+    struct node
+    {
+      node *next;
+    };
+    static constexpr size_t max_cached = 64;
+    static constexpr size_t block_size = (Bytes > sizeof(node)) ? Bytes : sizeof(node);
+
+    node *head{nullptr};
+    size_t count{0};
+
+    boxed_payload_pool() = default;
+    boxed_payload_pool(const boxed_payload_pool &) = delete;
+    boxed_payload_pool &operator=(const boxed_payload_pool &) = delete;
+    ~boxed_payload_pool()
+    {
+      while(head != nullptr)
+      {
+        node *n = head;
+        head = n->next;
+        ::operator delete(n);
+      }
+      // Any block freed by a later thread local destructor goes straight back to the allocator
+      count = max_cached;
+    }
+
+    static boxed_payload_pool &local() noexcept
+    {
+      static thread_local boxed_payload_pool pool;
+      return pool;
+    }
+    void *allocate()
+    {
+      if(head != nullptr)
+      {
+        node *n = head;
+        head = n->next;
+        --count;
+        return n;
+      }
+      return ::operator new(block_size);
+    }
+    void deallocate(void *p) noexcept
+    {
+      if(count < max_cached)
+      {
+        head = new(p) node{head};
+        ++count;
+        return;
+      }
+      ::operator delete(p);
+    }
+  };
+}  // namespace detail
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class Payload, class EC = std::error_code> class boxed_payload
+{
+  using _block_type = detail::boxed_payload_block<Payload>;
+  using _pool_type = detail::boxed_payload_pool<sizeof(_block_type)>;
+  static_assert(alignof(_block_type) <= alignof(std::max_align_t), "boxed_payload does not support over aligned payloads");
+
+  EC _code;
+  _block_type *_block{nullptr};
+
+  // Anything but ourselves which the error code can be compared to
+  template <class T> using _is_comparable = std::conditional_t<std::is_same<T, boxed_payload>::value, std::false_type, detail::error_wrapper_is_comparable<EC, T>>;
+
+  void _release() noexcept
+  {
+    if(_block != nullptr && 1 == _block->refcount.fetch_sub(1, std::memory_order_acq_rel))
+    {
+      _block->~_block_type();
+      _pool_type::local().deallocate(_block);
+    }
+    _block = nullptr;
+  }
+
+public:
+  //! The error code type
+  using error_code_type = EC;
+  //! The payload type
+  using payload_type = Payload;
+
+  //! Default constructor, with a default constructed error code and no payload
+  boxed_payload() = default;
+  //! Implicit constructor from an error code, with no payload
+  boxed_payload(const EC &code) noexcept(std::is_nothrow_copy_constructible<EC>::value)  // NOLINT
+      : _code(code)
+  {
+  }
+  //! Constructs the error code, and the payload in a side block from the arguments
+  template <class Arg, class... Args>
+  boxed_payload(const EC &code, Arg &&arg, Args &&... args)
+      : _code(code)
+  {
+    void *p = _pool_type::local().allocate();
+#ifdef __cpp_exceptions
+    try
+    {
+      _block = new(p) _block_type(static_cast<Arg &&>(arg), static_cast<Args &&>(args)...);
+    }
+    catch(...)
+    {
+      _pool_type::local().deallocate(p);
+      throw;
+    }
+#else
+    _block = new(p) _block_type(static_cast<Arg &&>(arg), static_cast<Args &&>(args)...);
+#endif
+  }
+  //! Copies share the payload
+  boxed_payload(const boxed_payload &o) noexcept(std::is_nothrow_copy_constructible<EC>::value)
+      : _code(o._code)
+      , _block(o._block)
+  {
+    if(_block != nullptr)
+    {
+      _block->refcount.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  boxed_payload(boxed_payload &&o) noexcept(std::is_nothrow_move_constructible<EC>::value)
+      : _code(static_cast<EC &&>(o._code))
+      , _block(o._block)
+  {
+    o._block = nullptr;
+  }
+  boxed_payload &operator=(const boxed_payload &o) noexcept(std::is_nothrow_copy_assignable<EC>::value)
+  {
+    if(this != &o)
+    {
+      _release();
+      _code = o._code;
+      _block = o._block;
+      if(_block != nullptr)
+      {
+        _block->refcount.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    return *this;
+  }
+  boxed_payload &operator=(boxed_payload &&o) noexcept(std::is_nothrow_move_assignable<EC>::value)
+  {
+    if(this != &o)
+    {
+      _release();
+      _code = static_cast<EC &&>(o._code);
+      _block = o._block;
+      o._block = nullptr;
+    }
+    return *this;
+  }
+  ~boxed_payload() { _release(); }
+  void swap(boxed_payload &o) noexcept
+  {
+    using std::swap;
+    swap(_code, o._code);
+    swap(_block, o._block);
+  }
+
+  //! The error code, which is stored inline
+  const EC &code() const noexcept { return _code; }
+  //! True if there is a payload
+  bool has_payload() const noexcept { return _block != nullptr; }
+  //! The payload, which is shared between copies and so is immutable. Requires `has_payload()`.
+  const Payload &payload() const noexcept { return _block->payload; }
+
+  //! Compares the error codes only
+  friend bool operator==(const boxed_payload &a, const boxed_payload &b) noexcept { return a._code == b._code; }
+  friend bool operator!=(const boxed_payload &a, const boxed_payload &b) noexcept { return !(a._code == b._code); }
+  //! Compares the error code with anything comparable to the error code, such as an error enum
+  template <class T, std::enable_if_t<_is_comparable<T>::value, bool> = true> friend bool operator==(const boxed_payload &a, const T &b) noexcept { return a._code == b; }
+  template <class T, std::enable_if_t<_is_comparable<T>::value, bool> = true> friend bool operator==(const T &a, const boxed_payload &b) noexcept { return b._code == a; }
+  template <class T, std::enable_if_t<_is_comparable<T>::value, bool> = true> friend bool operator!=(const boxed_payload &a, const T &b) noexcept { return !(a._code == b); }
+  template <class T, std::enable_if_t<_is_comparable<T>::value, bool> = true> friend bool operator!=(const T &a, const boxed_payload &b) noexcept { return !(b._code == a); }
+};
+
+//! Swaps two boxed payloads
+template <class Payload, class EC> inline void swap(boxed_payload<Payload, EC> &a, boxed_payload<Payload, EC> &b) noexcept
+{
+  a.swap(b);
+}
+
+namespace detail
+{
+  template <class Payload, class EC> struct error_wrapper_traits<boxed_payload<Payload, EC>>
+  {
+    static constexpr bool value = true;
+    using wrapped_type = EC;
+    static const EC *wrapped(const boxed_payload<Payload, EC> &v) noexcept { return &v.code(); }
+  };
+}  // namespace detail
+
+namespace trait
+{
+  // A boxed payload is an error type if its error code is
+  template <class Payload, class EC> struct is_error_type<boxed_payload<Payload, EC>> : detail::wrapped_is_error_type<boxed_payload<Payload, EC>>
+  {
+  };
+  template <class Payload, class EC, class Enum> struct is_error_type_enum<boxed_payload<Payload, EC>, Enum> : detail::wrapped_is_error_type_enum<boxed_payload<Payload, EC>, Enum>
+  {
+  };
+}  // namespace trait
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
@@ -0,0 +1,172 @@
+/* Per-thread breadcrumb trail of OUTCOME_TRY propagation
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_BREADCRUMBS_HPP
+#define OUTCOME_BREADCRUMBS_HPP
+
+#include "trait.hpp"
+
+#include <vector>
+
+/* Number of propagation steps each thread remembers. Must be a power of two no greater than 32768.
+*/
+#ifndef OUTCOME_TRY_BREADCRUMBS_DEPTH
+#define OUTCOME_TRY_BREADCRUMBS_DEPTH 256
+#endif
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+namespace breadcrumbs
+{
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+type definition  breadcrumb. Potential doc page: NOT FOUND
+*/
+  struct breadcrumb
+  {
+    //! The `__FILE__` of the `OUTCOME_TRY` which propagated the failure.
+    const char *file{nullptr};
+    //! The `__LINE__` of the `OUTCOME_TRY` which propagated the failure.
+    uint32_t line{0};
+    //! The id of the previous breadcrumb in this trail, or zero if this was the first propagation.
+    uint16_t previous{0};
+  };
+
+  namespace detail
+  {
+    static_assert(OUTCOME_TRY_BREADCRUMBS_DEPTH > 0 && OUTCOME_TRY_BREADCRUMBS_DEPTH <= 32768 && (OUTCOME_TRY_BREADCRUMBS_DEPTH & (OUTCOME_TRY_BREADCRUMBS_DEPTH - 1)) == 0, "OUTCOME_TRY_BREADCRUMBS_DEPTH must be a power of two no greater than 32768");
+
+    // Ids are a wrapping sequence number which skips zero, as zero in spare storage means no trail.
+    // As the depth divides 65536, id % depth is always the same slot even across wraparound.
+    struct trail_buffer
+    {
+      breadcrumb crumbs[OUTCOME_TRY_BREADCRUMBS_DEPTH];
+      uint16_t next_id;
+      // The id which the failure returned by the OUTCOME_TRY currently returning should adopt
+      uint16_t pending;
+    };
+    // Trivially destructible and zero initialised, so access needs no thread local guard
+    inline trail_buffer &this_thread_trail() noexcept
+    {
+      static OUTCOME_THREAD_LOCAL trail_buffer v;
+      return v;
+    }
+
+    inline bool is_stale(const trail_buffer &t, uint16_t id) noexcept { return id == 0 || static_cast<uint16_t>(t.next_id - id) > OUTCOME_TRY_BREADCRUMBS_DEPTH || static_cast<uint16_t>(t.next_id - id) == 0; }
+
+    template <class T> using result_of_spare_storage = decltype(hooks::spare_storage(std::declval<const T *>()));
+
+    template <class T> inline uint16_t previous_id(const T &v, std::true_type /*has spare storage*/) noexcept { return hooks::spare_storage(&v); }
+    template <class T> inline uint16_t previous_id(const T & /*unused*/, std::false_type /*has spare storage*/) noexcept { return 0; }
+
+    template <class T> QUICKCPPLIB_NOINLINE inline void record_try_propagate(const T &v, const char *file, uint32_t line) noexcept
+    {
+      trail_buffer &t = this_thread_trail();
+      uint16_t id = t.next_id++;
+      if(id == 0)
+      {
+        id = t.next_id++;
+      }
+      breadcrumb &c = t.crumbs[id % OUTCOME_TRY_BREADCRUMBS_DEPTH];
+      c.file = file;
+      c.line = line;
+      c.previous = previous_id(v, std::integral_constant<bool, trait::detail::is_detected<result_of_spare_storage, T>::value>());
+      t.pending = id;
+    }
+
+    // Constructed by OUTCOME_TRY just before it returns a failure. As a temporary of the return
+    // statement, it is destroyed only after the caller's return value has been constructed, which
+    // is when the pending id is stitched in if the return value is a result or outcome. If it was
+    // something else, such as a std::expected, the pending id must not reach a later failure.
+    struct try_propagation
+    {
+      template <class T> constexpr try_propagation(const T &v, const char *file, uint32_t line) noexcept
+      {
+        if(!OUTCOME_IS_CONSTANT_EVALUATED())
+        {
+          record_try_propagate(v, file, line);
+        }
+      }
+      try_propagation(const try_propagation &) = delete;
+      try_propagation(try_propagation &&) = delete;
+      try_propagation &operator=(const try_propagation &) = delete;
+      try_propagation &operator=(try_propagation &&) = delete;
+      OUTCOME_CXX20_CONSTEXPR ~try_propagation() { clear_pending(); }
+
+    private:
+      static constexpr inline void clear_pending() noexcept
+      {
+        if(!OUTCOME_IS_CONSTANT_EVALUATED())
+        {
+          this_thread_trail().pending = 0;
+        }
+      }
+    };
+
+    template <class T> using has_failure_observer = decltype(std::declval<const T &>().has_failure());
+
+    // The failure_type returned by OUTCOME_TRY is next used to construct the caller's return value,
+    // so that is where the trail is stitched into spare storage. Conversions from another result or
+    // outcome already copied the spare storage of their source.
+    template <class T, class U> inline void on_copy_or_move_construction(T *r, const U & /*unused*/) noexcept
+    {
+      if(!trait::detail::is_detected<has_failure_observer, U>::value)
+      {
+        trail_buffer &t = this_thread_trail();
+        if(t.pending != 0)
+        {
+          if(!r->has_value() && hooks::spare_storage(r) == 0)
+          {
+            hooks::set_spare_storage(r, t.pending);
+          }
+          t.pending = 0;
+        }
+      }
+    }
+  }  // namespace detail
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class T> inline std::vector<breadcrumb> trail(const T &r)
+  {
+    std::vector<breadcrumb> ret;
+    const detail::trail_buffer &t = detail::this_thread_trail();
+    uint16_t id = hooks::spare_storage(&r);
+    // Bounded in case an id was recycled into a cycle
+    for(size_t n = 0; n < OUTCOME_TRY_BREADCRUMBS_DEPTH && !detail::is_stale(t, id); n++)
+    {
+      const breadcrumb &c = t.crumbs[id % OUTCOME_TRY_BREADCRUMBS_DEPTH];
+      ret.push_back(c);
+      id = c.previous;
+    }
+    return ret;
+  }
+}  // namespace breadcrumbs
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
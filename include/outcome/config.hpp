@@ -69,6 +69,14 @@ SIGNATURE NOT RECOGNISED
 #ifndef OUTCOME_THREAD_LOCAL
 #define OUTCOME_THREAD_LOCAL QUICKCPPLIB_THREAD_LOCAL
 #endif
+#ifndef OUTCOME_INLINE_CONSTEXPR
+#ifdef __cpp_inline_variables
+// Namespace scope constants must not have internal linkage if they are to be used from a C++ Module
+#define OUTCOME_INLINE_CONSTEXPR inline constexpr
+#else
+#define OUTCOME_INLINE_CONSTEXPR static constexpr
+#endif
+#endif
 #ifndef OUTCOME_TEMPLATE
 #define OUTCOME_TEMPLATE(...) QUICKCPPLIB_TEMPLATE(__VA_ARGS__)
 #endif
@@ -85,31 +93,10 @@ SIGNATURE NOT RECOGNISED
 #define OUTCOME_REQUIRES(...) QUICKCPPLIB_REQUIRES(__VA_ARGS__)
 #endif
 
-#include "quickcpplib/include/import.h"
-
-
-#if defined(OUTCOME_UNSTABLE_VERSION)
-#include "revision.hpp"
-#define OUTCOME_V2 (QUICKCPPLIB_BIND_NAMESPACE_VERSION(outcome_v2, OUTCOME_PREVIOUS_COMMIT_UNIQUE))
-#else
-#define OUTCOME_V2 (QUICKCPPLIB_BIND_NAMESPACE_VERSION(outcome_v2))
-#endif
-
-#if defined(GENERATING_OUTCOME_MODULE_INTERFACE)
-#define OUTCOME_V2_NAMESPACE QUICKCPPLIB_BIND_NAMESPACE(OUTCOME_V2)
-#define OUTCOME_V2_NAMESPACE_BEGIN QUICKCPPLIB_BIND_NAMESPACE_BEGIN(OUTCOME_V2)
-#define OUTCOME_V2_NAMESPACE_EXPORT_BEGIN QUICKCPPLIB_BIND_NAMESPACE_EXPORT_BEGIN(OUTCOME_V2)
-#define OUTCOME_V2_NAMESPACE_END QUICKCPPLIB_BIND_NAMESPACE_END(OUTCOME_V2)
-#else
-#define OUTCOME_V2_NAMESPACE QUICKCPPLIB_BIND_NAMESPACE(OUTCOME_V2)
-#define OUTCOME_V2_NAMESPACE_BEGIN QUICKCPPLIB_BIND_NAMESPACE_BEGIN(OUTCOME_V2)
-#define OUTCOME_V2_NAMESPACE_EXPORT_BEGIN QUICKCPPLIB_BIND_NAMESPACE_BEGIN(OUTCOME_V2)
-#define OUTCOME_V2_NAMESPACE_END QUICKCPPLIB_BIND_NAMESPACE_END(OUTCOME_V2)
-#endif
+#include "detail/namespace_macros.hpp"
 
 #include <cstdint>  // for uint32_t etc
 #include <initializer_list>
-#include <iosfwd>  // for future serialisation
 #include <new>     // for placement in moves etc
 #include <type_traits>
 
@@ -220,7 +207,7 @@ namespace detail
   {
     static constexpr bool value = false;
   };
-  template <class T, class U> static constexpr bool is_explicitly_constructible = _is_explicitly_constructible<T, U>::value;
+  template <class T, class U> OUTCOME_INLINE_CONSTEXPR bool is_explicitly_constructible = _is_explicitly_constructible<T, U>::value;
 
   template <class T, class U> struct _is_implicitly_constructible
   {
@@ -234,7 +221,7 @@ namespace detail
   {
     static constexpr bool value = false;
   };
-  template <class T, class U> static constexpr bool is_implicitly_constructible = _is_implicitly_constructible<T, U>::value;
+  template <class T, class U> OUTCOME_INLINE_CONSTEXPR bool is_implicitly_constructible = _is_implicitly_constructible<T, U>::value;
 
 #ifndef OUTCOME_USE_STD_IS_NOTHROW_SWAPPABLE
 #if defined(_MSC_VER) && _HAS_CXX17
@@ -275,6 +262,62 @@ namespace detail
 }  // namespace detail
 OUTCOME_V2_NAMESPACE_END
 
+// True if the current evaluation is a constant evaluation. Always false if the compiler cannot tell.
+#ifndef OUTCOME_IS_CONSTANT_EVALUATED
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define OUTCOME_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#endif
+#endif
+#ifndef OUTCOME_IS_CONSTANT_EVALUATED
+#if(defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define OUTCOME_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define OUTCOME_IS_CONSTANT_EVALUATED() false
+#endif
+#endif
+
+// C++ 20 permits placement construction and destruction of non-trivial types in constant evaluation
+#ifndef OUTCOME_USE_STD_CONSTRUCT_AT
+#ifdef __has_include
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+#if defined(__cpp_lib_constexpr_dynamic_alloc) && __cpp_lib_constexpr_dynamic_alloc >= 201907L && defined(__cpp_constexpr_dynamic_alloc) && __cpp_constexpr_dynamic_alloc >= 201907L
+#define OUTCOME_USE_STD_CONSTRUCT_AT 1
+#else
+#define OUTCOME_USE_STD_CONSTRUCT_AT 0
+#endif
+#endif
+
+#if OUTCOME_USE_STD_CONSTRUCT_AT
+#include <memory>  // for construct_at and destroy_at
+#endif
+
+//! Expands to `constexpr` if non-trivial types can be constructed and destroyed in constant evaluation, else to nothing
+#ifndef OUTCOME_CXX20_CONSTEXPR
+#if OUTCOME_USE_STD_CONSTRUCT_AT
+#define OUTCOME_CXX20_CONSTEXPR constexpr
+#else
+#define OUTCOME_CXX20_CONSTEXPR
+#endif
+#endif
+
+OUTCOME_V2_NAMESPACE_BEGIN
+namespace detail
+{
+#if OUTCOME_USE_STD_CONSTRUCT_AT
+  template <class T, class... Args> constexpr T *construct_at(T *p, Args &&... args) noexcept(std::is_nothrow_constructible<T, Args...>::value) { return std::construct_at(p, static_cast<Args &&>(args)...); }
+  template <class T> constexpr void destroy_at(T *p) noexcept(std::is_nothrow_destructible<T>::value) { std::destroy_at(p); }
+#else
+  template <class T, class... Args> inline T *construct_at(T *p, Args &&... args) noexcept(std::is_nothrow_constructible<T, Args...>::value) { return new(p) T(static_cast<Args &&>(args)...); }  // NOLINT
+  template <class T> inline void destroy_at(T *p) noexcept(std::is_nothrow_destructible<T>::value) { p->~T(); }  // NOLINT
+#endif
+}  // namespace detail
+OUTCOME_V2_NAMESPACE_END
+
 
 #ifndef OUTCOME_THROW_EXCEPTION
 #ifdef __cpp_exceptions
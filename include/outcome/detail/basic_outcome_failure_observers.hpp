@@ -27,6 +27,8 @@ http://www.boost.org/LICENSE_1_0.txt)
 
 #include "basic_result_storage.hpp"
 
+#include <exception>  // for std::exception_ptr
+
 OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
 
 namespace detail
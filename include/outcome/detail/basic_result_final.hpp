@@ -52,6 +52,8 @@ namespace detail
     constexpr bool has_error() const noexcept { return (this->_state._status & detail::status_have_error) != 0; }
     constexpr bool has_exception() const noexcept { return (this->_state._status & detail::status_have_exception) != 0; }
     constexpr bool has_failure() const noexcept { return (this->_state._status & detail::status_have_error) != 0 || (this->_state._status & detail::status_have_exception) != 0; }
+    constexpr uint8_t error_class() const noexcept { return static_cast<uint8_t>((this->_state._status & detail::status_error_class_mask) >> detail::status_error_class_shift); }
+    constexpr bool has_error_class(uint8_t mask) const noexcept { return (this->_state._status & (static_cast<detail::status_bitfield_type>(mask) << detail::status_error_class_shift)) != 0; }
 
     OUTCOME_TEMPLATE(class T, class U, class V)
     OUTCOME_TREQUIRES(OUTCOME_TEXPR(std::declval<detail::devoid<R>>() == std::declval<detail::devoid<T>>()),  //
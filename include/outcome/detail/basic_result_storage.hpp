@@ -29,12 +29,37 @@ http://www.boost.org/LICENSE_1_0.txt)
 #include "../trait.hpp"
 #include "value_storage.hpp"
 
+#include <cstddef>  // for offsetof
+
 OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
 
 namespace detail
 {
-  template <class State, class E> constexpr inline void _set_error_is_errno(State & /*unused*/, const E & /*unused*/) {}
+  // Specialised by error types which wrap another error, see error_wrapper.hpp
+  template <class W> struct error_wrapper_traits
+  {
+    static constexpr bool value = false;
+  };
+  template <class State, class E> constexpr inline void _set_error_is_errno(State & /*unused*/, const E & /*unused*/, std::false_type /*not a wrapper*/) {}
+  // An error wrapper is errno compatible if the error it wraps is
+  template <class State, class E> constexpr inline void _set_error_is_errno(State &state, const E &error, std::true_type /*is a wrapper*/)
+  {
+    const auto *wrapped = error_wrapper_traits<E>::wrapped(error);
+    if(wrapped != nullptr)
+    {
+      _set_error_is_errno(state, *wrapped);
+    }
+  }
+  template <class State, class E> constexpr inline void _set_error_is_errno(State &state, const E &error) { _set_error_is_errno(state, error, std::integral_constant<bool, error_wrapper_traits<E>::value>()); }
+  // Caches the class bits of an error, if its type has a trait::error_classifier, in bits 8-15 of the status
+  template <class State, class E> constexpr inline void _set_error_class(State & /*unused*/, const E & /*unused*/, std::false_type /*no classifier*/) {}
+  template <class State, class E> constexpr inline void _set_error_class(State &state, const E &error, std::true_type /*has classifier*/)
+  {
+    state._status = (state._status & ~status_error_class_mask) | (static_cast<status_bitfield_type>(static_cast<uint8_t>(trait::error_classifier<E>::classify(error))) << status_error_class_shift);
+  }
+  template <class State, class E> constexpr inline void _set_error_class(State &state, const E &error) { _set_error_class(state, error, std::integral_constant<bool, trait::detail::introspect_error_classifier<E>::value>()); }
   template <class R, class S, class NoValuePolicy> class basic_result_final;
+  template <class R, class S, class NoValuePolicy> struct basic_result_storage_layout;
 }  // namespace detail
 
 namespace hooks
@@ -50,10 +75,207 @@ namespace policy
 
 namespace detail
 {
+  struct compatible_conversion_tag
+  {
+  };
+  struct basic_result_storage_disable_in_place_value_type
+  {
+  };
+  struct basic_result_storage_disable_in_place_error_type
+  {
+  };
+
+  /* If the error type is trivially copyable and destructible, its lifetime can be left to the status bits
+  without any special member function needing to know whether it is live. Such errors with a non-trivial
+  default constructor, like std::error_code, are constructed only when there is one, so successful results
+  never run the error type's default constructor. Trivially default constructible errors cost nothing to
+  construct, and are always constructed so conversions between results stay usable in constant expressions
+  before C++ 20.
+  */
+  template <class EC>
+  struct error_is_lazily_constructed
+      : std::integral_constant<bool, std::is_trivially_copyable<devoid<EC>>::value && std::is_trivially_destructible<devoid<EC>>::value && !std::is_trivially_default_constructible<devoid<EC>>::value>
+  {
+  };
+
+  // The state and error of a basic_result_storage, with the error always constructed
+  template <class V, class E, bool = error_is_lazily_constructed<E>::value> struct basic_result_storage_members
+  {
+#ifdef STANDARDESE_IS_IN_THE_HOUSE
+    detail::value_storage_trivial<V> _state;
+#else
+    detail::value_storage_select_impl<V> _state;
+#endif
+    devoid<E> _error;
+
+    basic_result_storage_members() = default;
+    template <class... Args>
+    constexpr explicit basic_result_storage_members(in_place_type_t<V> _, Args &&... args)
+        : _state{_, static_cast<Args &&>(args)...}
+        , _error()
+    {
+    }
+    template <class F, class... Args>
+    constexpr basic_result_storage_members(in_place_invoke_tag _, F &&f, Args &&... args)
+        : _state{_, static_cast<F &&>(f), static_cast<Args &&>(args)...}
+        , _error()
+    {
+    }
+    template <class... Args>
+    constexpr explicit basic_result_storage_members(in_place_type_t<E> /*unused*/, Args &&... args)
+        : _state{detail::status_have_error}
+        , _error(static_cast<Args &&>(args)...)
+    {
+    }
+    template <class U, class... Args>
+    constexpr basic_result_storage_members(in_place_type_t<E> /*unused*/, std::initializer_list<U> il, Args &&... args)
+        : _state{detail::status_have_error}
+        , _error{il, static_cast<Args &&>(args)...}
+    {
+    }
+    template <class T, class U>
+    constexpr basic_result_storage_members(compatible_conversion_tag /*unused*/, const basic_result_storage_members<T, U, false> &o)
+        : _state(o._state)
+        , _error(o._error)
+    {
+    }
+    template <class T, class U>
+    constexpr basic_result_storage_members(compatible_conversion_tag /*unused*/, basic_result_storage_members<T, U, false> &&o)
+        : _state(static_cast<decltype(o._state) &&>(o._state))
+        , _error(static_cast<U &&>(o._error))
+    {
+    }
+    template <class T>
+    constexpr basic_result_storage_members(compatible_conversion_tag /*unused*/, const basic_result_storage_members<T, void, false> &o)
+        : _state(o._state)
+        , _error()
+    {
+    }
+    template <class T>
+    constexpr basic_result_storage_members(compatible_conversion_tag /*unused*/, basic_result_storage_members<T, void, false> &&o)
+        : _state(static_cast<decltype(o._state) &&>(o._state))
+        , _error()
+    {
+    }
+    template <class T, class U>
+    constexpr basic_result_storage_members(compatible_conversion_tag /*unused*/, const basic_result_storage_members<T, U, true> &o)
+        : _state(o._state)
+        , _error()
+    {
+      if((_state._status & detail::status_have_error) != 0)
+      {
+        _error = o._error;
+      }
+    }
+    template <class T, class U>
+    constexpr basic_result_storage_members(compatible_conversion_tag /*unused*/, basic_result_storage_members<T, U, true> &&o)
+        : _state(static_cast<decltype(o._state) &&>(o._state))
+        , _error()
+    {
+      if((_state._status & detail::status_have_error) != 0)
+      {
+        _error = static_cast<U &&>(o._error);
+      }
+    }
+
+    // Swaps errors with o, given which of us currently hold a live error
+    constexpr void _swap_live_errors(basic_result_storage_members &o, bool /*unused*/, bool /*unused*/) noexcept(detail::is_nothrow_swappable<devoid<E>>::value)
+    {
+      using std::swap;
+      swap(_error, o._error);
+    }
+
+  };
+  // The state and error of a basic_result_storage, with the error constructed only when there is one
+  template <class V, class E> struct basic_result_storage_members<V, E, true>
+  {
+#ifdef STANDARDESE_IS_IN_THE_HOUSE
+    detail::value_storage_trivial<V> _state;
+#else
+    detail::value_storage_select_impl<V> _state;
+#endif
+    union {
+      empty_type _empty;
+      devoid<E> _error;
+    };
+
+    constexpr basic_result_storage_members() noexcept
+        : _empty()
+    {
+    }
+    template <class... Args>
+    constexpr explicit basic_result_storage_members(in_place_type_t<V> _, Args &&... args)
+        : _state{_, static_cast<Args &&>(args)...}
+        , _empty()
+    {
+    }
+    template <class F, class... Args>
+    constexpr basic_result_storage_members(in_place_invoke_tag _, F &&f, Args &&... args)
+        : _state{_, static_cast<F &&>(f), static_cast<Args &&>(args)...}
+        , _empty()
+    {
+    }
+    template <class... Args>
+    constexpr explicit basic_result_storage_members(in_place_type_t<E> /*unused*/, Args &&... args)
+        : _state{detail::status_have_error}
+        , _error(static_cast<Args &&>(args)...)
+    {
+    }
+    template <class U, class... Args>
+    constexpr basic_result_storage_members(in_place_type_t<E> /*unused*/, std::initializer_list<U> il, Args &&... args)
+        : _state{detail::status_have_error}
+        , _error{il, static_cast<Args &&>(args)...}
+    {
+    }
+    template <class T, class U, bool lazy>
+    constexpr basic_result_storage_members(compatible_conversion_tag /*unused*/, const basic_result_storage_members<T, U, lazy> &o)
+        : _state(o._state)
+        , _empty()
+    {
+      if((_state._status & detail::status_have_error) != 0)
+      {
+        _construct_error(o._error);
+      }
+    }
+    template <class T, class U, bool lazy>
+    constexpr basic_result_storage_members(compatible_conversion_tag /*unused*/, basic_result_storage_members<T, U, lazy> &&o)
+        : _state(static_cast<decltype(o._state) &&>(o._state))
+        , _empty()
+    {
+      if((_state._status & detail::status_have_error) != 0)
+      {
+        _construct_error(static_cast<devoid<U> &&>(o._error));
+      }
+    }
+
+    // Swaps errors with o, given which of us currently hold a live error
+    constexpr void _swap_live_errors(basic_result_storage_members &o, bool mine, bool theirs) noexcept(detail::is_nothrow_swappable<devoid<E>>::value)
+    {
+      if(mine && theirs)
+      {
+        using std::swap;
+        swap(_error, o._error);
+      }
+      else if(mine)
+      {
+        o._construct_error(static_cast<devoid<E> &&>(_error));
+      }
+      else if(theirs)
+      {
+        _construct_error(static_cast<devoid<E> &&>(o._error));
+      }
+    }
+
+  private:
+    constexpr void _construct_error(const void_type & /*unused*/) { detail::construct_at(&_error); }
+    constexpr void _construct_error(void_type && /*unused*/) { detail::construct_at(&_error); }
+    template <class U> constexpr void _construct_error(U &&v) { detail::construct_at(&_error, static_cast<U &&>(v)); }
+  };
+
   template <bool value_throws, bool error_throws> struct basic_result_storage_swap;
   template <class R, class EC, class NoValuePolicy>                                                                                                                                    //
   OUTCOME_REQUIRES(trait::type_can_be_used_in_basic_result<R> &&trait::type_can_be_used_in_basic_result<EC> && (std::is_void<EC>::value || std::is_default_constructible<EC>::value))  //
-  class basic_result_storage
+  class basic_result_storage : protected basic_result_storage_members<std::conditional_t<std::is_same<R, EC>::value, basic_result_storage_disable_in_place_value_type, R>, std::conditional_t<std::is_same<R, EC>::value, basic_result_storage_disable_in_place_error_type, EC>>
   {
     static_assert(trait::type_can_be_used_in_basic_result<R>, "The type R cannot be used in a basic_result");
     static_assert(trait::type_can_be_used_in_basic_result<EC>, "The type S cannot be used in a basic_result");
@@ -62,36 +284,46 @@ namespace detail
     friend struct policy::base;
     template <class T, class U, class V> friend class basic_result_storage;
     template <class T, class U, class V> friend class basic_result_final;
+    template <class T, class U, class V> friend struct basic_result_storage_layout;
     template <class T, class U, class V> friend constexpr inline uint16_t hooks::spare_storage(const detail::basic_result_final<T, U, V> *r) noexcept;        // NOLINT
     template <class T, class U, class V> friend constexpr inline void hooks::set_spare_storage(detail::basic_result_final<T, U, V> *r, uint16_t v) noexcept;  // NOLINT
     template <bool value_throws, bool error_throws> struct basic_result_storage_swap;
 
-    struct disable_in_place_value_type
-    {
-    };
-    struct disable_in_place_error_type
-    {
-    };
-
   protected:
-    using _value_type = std::conditional_t<std::is_same<R, EC>::value, disable_in_place_value_type, R>;
-    using _error_type = std::conditional_t<std::is_same<R, EC>::value, disable_in_place_error_type, EC>;
-
-#ifdef STANDARDESE_IS_IN_THE_HOUSE
-    detail::value_storage_trivial<_value_type> _state;
-#else
-    detail::value_storage_select_impl<_value_type> _state;
-#endif
-    detail::devoid<_error_type> _error;
+    using _value_type = std::conditional_t<std::is_same<R, EC>::value, basic_result_storage_disable_in_place_value_type, R>;
+    using _error_type = std::conditional_t<std::is_same<R, EC>::value, basic_result_storage_disable_in_place_error_type, EC>;
+    using _members = basic_result_storage_members<_value_type, _error_type>;
 
   public:
     // Used by iostream support to access state
-    detail::value_storage_select_impl<_value_type> &_iostreams_state() { return _state; }
-    const detail::value_storage_select_impl<_value_type> &_iostreams_state() const { return _state; }
+    detail::value_storage_select_impl<_value_type> &_iostreams_state() { return this->_state; }
+    const detail::value_storage_select_impl<_value_type> &_iostreams_state() const { return this->_state; }
 
     // Hack to work around MSVC bug in /permissive-
-    detail::value_storage_select_impl<_value_type> &_msvc_nonpermissive_state() { return _state; }
-    detail::devoid<_error_type> &_msvc_nonpermissive_error() { return _error; }
+    constexpr detail::value_storage_select_impl<_value_type> &_msvc_nonpermissive_state() { return this->_state; }
+    constexpr detail::devoid<_error_type> &_msvc_nonpermissive_error() { return this->_error; }
+    // Swaps errors with o, either before or after our states were swapped
+    constexpr void _msvc_nonpermissive_swap_error(basic_result_storage &o, bool states_swapped) noexcept(noexcept(std::declval<_members &>()._swap_live_errors(std::declval<_members &>(), true, true)))
+    {
+      const bool have_error = (this->_state._status & detail::status_have_error) != 0;
+      const bool o_have_error = (o._state._status & detail::status_have_error) != 0;
+      this->_swap_live_errors(o, states_swapped ? o_have_error : have_error, states_swapped ? have_error : o_have_error);
+    }
+    // Used by error injection to replace the value with an error, without running the construction hooks again
+    template <class U> void _replace_value_with_error(U &&e) noexcept
+    {
+      _destroy_value(std::is_trivially_destructible<devoid<_value_type>>());
+      _place_error(static_cast<U &&>(e), detail::error_is_lazily_constructed<_error_type>());
+      this->_state._status = (this->_state._status & ~detail::status_have_value) | detail::status_have_error;
+      _set_error_is_errno(this->_state, this->_error);
+      _set_error_class(this->_state, this->_error);
+    }
+
+  private:
+    void _destroy_value(std::true_type /*trivially destructible*/) noexcept {}
+    void _destroy_value(std::false_type /*trivially destructible*/) noexcept { detail::destroy_at(&this->_state._value); }
+    template <class U> void _place_error(U &&e, std::true_type /*lazily constructed*/) noexcept { detail::construct_at(&this->_error, static_cast<U &&>(e)); }
+    template <class U> void _place_error(U &&e, std::false_type /*lazily constructed*/) noexcept { this->_error = static_cast<U &&>(e); }
 
   protected:
     basic_result_storage() = default;
@@ -103,56 +335,54 @@ namespace detail
 
     template <class... Args>
     constexpr explicit basic_result_storage(in_place_type_t<_value_type> _, Args &&... args) noexcept(std::is_nothrow_constructible<_value_type, Args...>::value)
-        : _state{_, static_cast<Args &&>(args)...}
-        , _error()
+        : _members{_, static_cast<Args &&>(args)...}
     {
     }
     template <class U, class... Args>
     constexpr basic_result_storage(in_place_type_t<_value_type> _, std::initializer_list<U> il, Args &&... args) noexcept(std::is_nothrow_constructible<_value_type, std::initializer_list<U>, Args...>::value)
-        : _state{_, il, static_cast<Args &&>(args)...}
-        , _error()
+        : _members{_, il, static_cast<Args &&>(args)...}
     {
     }
     template <class... Args>
-    constexpr explicit basic_result_storage(in_place_type_t<_error_type> /*unused*/, Args &&... args) noexcept(std::is_nothrow_constructible<_error_type, Args...>::value)
-        : _state{detail::status_have_error}
-        , _error(static_cast<Args &&>(args)...)
+    constexpr explicit basic_result_storage(in_place_type_t<_error_type> _, Args &&... args) noexcept(std::is_nothrow_constructible<_error_type, Args...>::value)
+        : _members{_, static_cast<Args &&>(args)...}
     {
-      _set_error_is_errno(_state, _error);
+      _set_error_is_errno(this->_state, this->_error);
+      _set_error_class(this->_state, this->_error);
     }
     template <class U, class... Args>
-    constexpr basic_result_storage(in_place_type_t<_error_type> /*unused*/, std::initializer_list<U> il, Args &&... args) noexcept(std::is_nothrow_constructible<_error_type, std::initializer_list<U>, Args...>::value)
-        : _state{detail::status_have_error}
-        , _error{il, static_cast<Args &&>(args)...}
+    constexpr basic_result_storage(in_place_type_t<_error_type> _, std::initializer_list<U> il, Args &&... args) noexcept(std::is_nothrow_constructible<_error_type, std::initializer_list<U>, Args...>::value)
+        : _members{_, il, static_cast<Args &&>(args)...}
     {
-      _set_error_is_errno(_state, _error);
+      _set_error_is_errno(this->_state, this->_error);
+      _set_error_class(this->_state, this->_error);
     }
-    struct compatible_conversion_tag
-    {
-    };
-    template <class T, class U, class V>
-    constexpr basic_result_storage(compatible_conversion_tag /*unused*/, const basic_result_storage<T, U, V> &o) noexcept(std::is_nothrow_constructible<_value_type, T>::value &&std::is_nothrow_constructible<_error_type, U>::value)
-        : _state(o._state)
-        , _error(o._error)
+    template <class F, class... Args>
+    constexpr basic_result_storage(in_place_invoke_tag _, F &&f, Args &&... args)
+        : _members{_, static_cast<F &&>(f), static_cast<Args &&>(args)...}
     {
     }
-    template <class T, class V>
-    constexpr basic_result_storage(compatible_conversion_tag /*unused*/, const basic_result_storage<T, void, V> &o) noexcept(std::is_nothrow_constructible<_value_type, T>::value)
-        : _state(o._state)
-        , _error(_error_type{})
+    // The class bits belong to the error type, so are recomputed after conversion from another error type
+    constexpr void _reclassify_error()
     {
+      this->_state._status &= ~detail::status_error_class_mask;
+      if((this->_state._status & detail::status_have_error) != 0)
+      {
+        _set_error_class(this->_state, this->_error);
+      }
     }
+    using compatible_conversion_tag = detail::compatible_conversion_tag;
     template <class T, class U, class V>
-    constexpr basic_result_storage(compatible_conversion_tag /*unused*/, basic_result_storage<T, U, V> &&o) noexcept(std::is_nothrow_constructible<_value_type, T>::value &&std::is_nothrow_constructible<_error_type, U>::value)
-        : _state(static_cast<decltype(o._state) &&>(o._state))
-        , _error(static_cast<U &&>(o._error))
+    constexpr basic_result_storage(compatible_conversion_tag _, const basic_result_storage<T, U, V> &o) noexcept(std::is_nothrow_constructible<_value_type, T>::value &&std::is_nothrow_constructible<_error_type, detail::devoid<U>>::value)
+        : _members{_, static_cast<const typename basic_result_storage<T, U, V>::_members &>(o)}
     {
+      _reclassify_error();
     }
-    template <class T, class V>
-    constexpr basic_result_storage(compatible_conversion_tag /*unused*/, basic_result_storage<T, void, V> &&o) noexcept(std::is_nothrow_constructible<_value_type, T>::value)
-        : _state(static_cast<decltype(o._state) &&>(o._state))
-        , _error(_error_type{})
+    template <class T, class U, class V>
+    constexpr basic_result_storage(compatible_conversion_tag _, basic_result_storage<T, U, V> &&o) noexcept(std::is_nothrow_constructible<_value_type, T>::value &&std::is_nothrow_constructible<_error_type, detail::devoid<U>>::value)
+        : _members{_, static_cast<typename basic_result_storage<T, U, V>::_members &&>(o)}
     {
+      _reclassify_error();
     }
   };
 
@@ -165,9 +395,8 @@ namespace detail
   {
     template <class R, class EC, class NoValuePolicy> constexpr basic_result_storage_swap(basic_result_storage<R, EC, NoValuePolicy> &a, basic_result_storage<R, EC, NoValuePolicy> &b)
     {
-      using std::swap;
       a._msvc_nonpermissive_state().swap(b._msvc_nonpermissive_state());
-      swap(a._msvc_nonpermissive_error(), b._msvc_nonpermissive_error());
+      a._msvc_nonpermissive_swap_error(b, true);
     }
   };
 #ifdef __cpp_exceptions
@@ -176,9 +405,8 @@ namespace detail
   {
     template <class R, class EC, class NoValuePolicy> constexpr basic_result_storage_swap(basic_result_storage<R, EC, NoValuePolicy> &a, basic_result_storage<R, EC, NoValuePolicy> &b)
     {
-      using std::swap;
       a._msvc_nonpermissive_state().swap(b._msvc_nonpermissive_state());
-      swap(a._msvc_nonpermissive_error(), b._msvc_nonpermissive_error());
+      a._msvc_nonpermissive_swap_error(b, true);
     }
   };
   // Swap potentially throwing error first
@@ -186,22 +414,20 @@ namespace detail
   {
     template <class R, class EC, class NoValuePolicy> constexpr basic_result_storage_swap(basic_result_storage<R, EC, NoValuePolicy> &a, basic_result_storage<R, EC, NoValuePolicy> &b)
     {
-      using std::swap;
-      swap(a._msvc_nonpermissive_error(), b._msvc_nonpermissive_error());
+      a._msvc_nonpermissive_swap_error(b, false);
       a._msvc_nonpermissive_state().swap(b._msvc_nonpermissive_state());
     }
   };
   // Both could throw
   template <> struct basic_result_storage_swap<true, true>
   {
-    template <class R, class EC, class NoValuePolicy> basic_result_storage_swap(basic_result_storage<R, EC, NoValuePolicy> &a, basic_result_storage<R, EC, NoValuePolicy> &b)
+    template <class R, class EC, class NoValuePolicy> OUTCOME_CXX20_CONSTEXPR basic_result_storage_swap(basic_result_storage<R, EC, NoValuePolicy> &a, basic_result_storage<R, EC, NoValuePolicy> &b)
     {
-      using std::swap;
       // Swap value and status first, if it throws, status will remain unchanged
       a._msvc_nonpermissive_state().swap(b._msvc_nonpermissive_state());
       try
       {
-        swap(a._msvc_nonpermissive_error(), b._msvc_nonpermissive_error());
+        a._msvc_nonpermissive_swap_error(b, true);
       }
       catch(...)
       {
@@ -245,6 +471,17 @@ namespace detail
   };
 #endif
 
+  // Offsets of the members of basic_result_storage, used to verify that the C layout in <outcome/experimental/result.h> matches
+  template <class R, class S, class NoValuePolicy> struct basic_result_storage_layout
+  {
+    using storage_type = basic_result_storage<R, S, NoValuePolicy>;
+    using state_type = decltype(std::declval<storage_type>()._state);
+    static constexpr size_t value_offset = offsetof(storage_type, _state) + offsetof(state_type, _value);
+    static constexpr size_t status_offset = offsetof(storage_type, _state) + offsetof(state_type, _status);
+    static constexpr size_t error_offset = offsetof(storage_type, _error);
+    static constexpr size_t status_size = sizeof(std::declval<storage_type>()._state._status);
+  };
+
 }  // namespace detail
 OUTCOME_V2_NAMESPACE_END
 
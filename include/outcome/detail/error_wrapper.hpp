@@ -0,0 +1,102 @@
+/* Shared forwarding for error types which wrap another error
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_DETAIL_ERROR_WRAPPER_HPP
+#define OUTCOME_DETAIL_ERROR_WRAPPER_HPP
+
+#include "../std_result.hpp"
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+/* Error types which wrap another error, such as boxed_payload, error_list and error_with_context,
+specialise detail::error_wrapper_traits with:
+
+  static constexpr bool value = true;
+  using wrapped_type = ...;
+  static const wrapped_type *wrapped(const W &) noexcept;  // null if there is no wrapped error
+
+and so get make_error_code(), outcome_throw_as_system_error_with_payload() and errno tracking which
+forward to the wrapped error. Their trait::is_error_type and trait::is_error_type_enum specialisations
+derive from the trait::detail::wrapped_* bases below.
+*/
+namespace detail
+{
+  // Anything which the wrapped error can be compared to
+  template <class E, class T, class = void> struct error_wrapper_is_comparable : std::false_type
+  {
+  };
+  template <class E, class T> struct error_wrapper_is_comparable<E, T, decltype((void) (std::declval<const E &>() == std::declval<const T &>()))> : std::true_type
+  {
+  };
+  template <class W> using error_wrapper_wrapped_type = typename error_wrapper_traits<W>::wrapped_type;
+}  // namespace detail
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class W, std::enable_if_t<detail::error_wrapper_traits<W>::value, bool> = true, class E = detail::error_wrapper_wrapped_type<W>, std::enable_if_t<trait::is_error_code_available<E>::value, bool> = true>
+inline auto make_error_code(const W &v)
+{
+  using code_type = std::decay_t<decltype(policy::error_code(std::declval<const E &>()))>;
+  const E *wrapped = detail::error_wrapper_traits<W>::wrapped(v);
+  if(wrapped == nullptr)
+  {
+    return code_type();
+  }
+  return code_type(policy::error_code(*wrapped));
+}
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class W, std::enable_if_t<detail::error_wrapper_traits<W>::value, bool> = true> inline void outcome_throw_as_system_error_with_payload(const W &v)
+{
+  using policy::outcome_throw_as_system_error_with_payload;
+  const auto *wrapped = detail::error_wrapper_traits<W>::wrapped(v);
+  if(wrapped == nullptr)
+  {
+    OUTCOME_THROW_EXCEPTION(bad_result_access("no value"));  // NOLINT
+  }
+  outcome_throw_as_system_error_with_payload(*wrapped);
+}
+
+namespace trait
+{
+  namespace detail
+  {
+    // A wrapper is an error type if the error it wraps is
+    template <class W> struct wrapped_is_error_type
+    {
+      static constexpr bool value = is_error_type<OUTCOME_V2_NAMESPACE::detail::error_wrapper_wrapped_type<W>>::value;
+    };
+    template <class W, class Enum> struct wrapped_is_error_type_enum
+    {
+      static constexpr bool value = is_error_type_enum<OUTCOME_V2_NAMESPACE::detail::error_wrapper_wrapped_type<W>, Enum>::value;
+    };
+  }  // namespace detail
+}  // namespace trait
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
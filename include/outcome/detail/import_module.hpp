@@ -0,0 +1,34 @@
+/* Imports the Outcome C++ Module
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_DETAIL_IMPORT_MODULE_HPP
+#define OUTCOME_DETAIL_IMPORT_MODULE_HPP
+
+import outcome_v2_0;  // OUTCOME_MODULE_NAME
+
+// Preprocessor macros are not exported from C++ Modules
+#include "namespace_macros.hpp"
+#include "try_macros.hpp"
+
+#endif
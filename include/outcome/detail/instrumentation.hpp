@@ -0,0 +1,97 @@
+/* Dispatch of the default construction hooks to opt-in instrumentation
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_DETAIL_INSTRUMENTATION_HPP
+#define OUTCOME_DETAIL_INSTRUMENTATION_HPP
+
+#include "../config.hpp"
+
+#ifdef OUTCOME_ENABLE_ERROR_INJECTION
+#include "../error_injection.hpp"
+#endif
+#ifdef OUTCOME_ENABLE_TELEMETRY
+#include "../telemetry.hpp"
+#endif
+#ifdef OUTCOME_ENABLE_USDT
+#include "../usdt.hpp"
+#endif
+#ifdef OUTCOME_ENABLE_TRY_BREADCRUMBS
+#include "../breadcrumbs.hpp"
+#endif
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+namespace detail
+{
+  /* Called by the default construction hooks of result and outcome. These do nothing unless
+  some opt-in instrumentation is enabled, and even then nothing during constant evaluation.
+  */
+  template <class T> constexpr inline void instrument_construction(T *r) noexcept
+  {
+    (void) r;
+#if defined(OUTCOME_ENABLE_ERROR_INJECTION) || defined(OUTCOME_ENABLE_TELEMETRY) || defined(OUTCOME_ENABLE_USDT)
+    if(OUTCOME_IS_CONSTANT_EVALUATED())
+    {
+      return;
+    }
+#endif
+#ifdef OUTCOME_ENABLE_ERROR_INJECTION
+    // First, so all other instrumentation sees the injected failure
+    error_injection::detail::on_construction(r);
+#endif
+#ifdef OUTCOME_ENABLE_TELEMETRY
+    telemetry::detail::on_construction(r);
+#endif
+#ifdef OUTCOME_ENABLE_USDT
+    usdt::detail::on_construction(r);
+#endif
+  }
+  template <class T, class U> constexpr inline void instrument_copy_or_move_construction(T *r, const U &o) noexcept
+  {
+    (void) r;
+    (void) o;
+#if defined(OUTCOME_ENABLE_ERROR_INJECTION) || defined(OUTCOME_ENABLE_TELEMETRY) || defined(OUTCOME_ENABLE_USDT) || defined(OUTCOME_ENABLE_TRY_BREADCRUMBS)
+    if(OUTCOME_IS_CONSTANT_EVALUATED())
+    {
+      return;
+    }
+#endif
+#ifdef OUTCOME_ENABLE_ERROR_INJECTION
+    error_injection::detail::on_copy_or_move_construction(r, o);
+#endif
+#ifdef OUTCOME_ENABLE_TELEMETRY
+    telemetry::detail::on_copy_or_move_construction(r, o);
+#endif
+#ifdef OUTCOME_ENABLE_USDT
+    usdt::detail::on_copy_or_move_construction(r, o);
+#endif
+#ifdef OUTCOME_ENABLE_TRY_BREADCRUMBS
+    breadcrumbs::detail::on_copy_or_move_construction(r, o);
+#endif
+  }
+}  // namespace detail
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
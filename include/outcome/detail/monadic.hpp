@@ -0,0 +1,81 @@
+/* Building blocks for the monadic operations of basic_result and basic_outcome
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_DETAIL_MONADIC_HPP
+#define OUTCOME_DETAIL_MONADIC_HPP
+
+#include "../config.hpp"
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+namespace detail
+{
+  // Rebinds the value and error types of a policy template taking <T, EC, E>, any other policy is kept
+  template <class Policy, class T, class EC> struct rebind_policy
+  {
+    using type = Policy;
+  };
+  template <template <class, class, class> class Policy, class T0, class EC0, class E, class T, class EC> struct rebind_policy<Policy<T0, EC0, E>, T, EC>
+  {
+    using type = Policy<T, EC, E>;
+  };
+  template <class Policy, class T, class EC> using rebind_policy_t = typename rebind_policy<Policy, T, EC>::type;
+
+  // Invokes F with the value or error of Self, or with no arguments if that is void
+  template <class F, class Self> constexpr decltype(auto) invoke_with_value(F &&f, Self &&self, std::false_type /*void value*/) { return static_cast<F &&>(f)(static_cast<Self &&>(self).assume_value()); }
+  template <class F, class Self> constexpr decltype(auto) invoke_with_value(F &&f, Self && /*unused*/, std::true_type /*void value*/) { return static_cast<F &&>(f)(); }
+  template <class F, class Self> constexpr decltype(auto) invoke_with_error(F &&f, Self &&self, std::false_type /*void error*/) { return static_cast<F &&>(f)(static_cast<Self &&>(self).assume_error()); }
+  template <class F, class Self> constexpr decltype(auto) invoke_with_error(F &&f, Self && /*unused*/, std::true_type /*void error*/) { return static_cast<F &&>(f)(); }
+  template <class Self> using self_value_is_void = std::is_void<typename std::decay_t<Self>::value_type>;
+  template <class Self> using self_error_is_void = std::is_void<typename std::decay_t<Self>::error_type>;
+  template <class F, class Self> using invoke_with_value_t = decltype(invoke_with_value(std::declval<F>(), std::declval<Self>(), self_value_is_void<Self>()));
+  template <class F, class Self> using invoke_with_error_t = decltype(invoke_with_error(std::declval<F>(), std::declval<Self>(), self_error_is_void<Self>()));
+
+  // Constructs R in place with the value or error of Self, moving it if Self is an rvalue
+  template <class R, class Self> constexpr R monadic_value(Self &&self, std::false_type /*void value*/) { return R{in_place_type<typename R::value_type>, static_cast<Self &&>(self).assume_value()}; }
+  template <class R, class Self> constexpr R monadic_value(Self && /*unused*/, std::true_type /*void value*/) { return R{in_place_type<typename R::value_type>}; }
+  template <class R, class Self> constexpr R monadic_error(Self &&self, std::false_type /*void error*/) { return R{in_place_type<typename R::error_type>, static_cast<Self &&>(self).assume_error()}; }
+  template <class R, class Self> constexpr R monadic_error(Self && /*unused*/, std::true_type /*void error*/) { return R{in_place_type<typename R::error_type>}; }
+
+  // Constructs R in place with what invoking F upon the value or error of Self returns, which may be void.
+  // A value returned by F is constructed directly inside R, an error is moved into R.
+  template <class R, class F, class Self> constexpr R monadic_invoke_value(F &&f, Self &&self, std::false_type /*void value*/) { return R{in_place_invoke_tag(), static_cast<F &&>(f), static_cast<Self &&>(self).assume_value()}; }
+  template <class R, class F, class Self> constexpr R monadic_invoke_value(F &&f, Self && /*unused*/, std::true_type /*void value*/) { return R{in_place_invoke_tag(), static_cast<F &&>(f)}; }
+  template <class R, class F, class Self> constexpr R monadic_mapped_value(F &&f, Self &&self, std::false_type /*void return*/) { return monadic_invoke_value<R>(static_cast<F &&>(f), static_cast<Self &&>(self), self_value_is_void<Self>()); }
+  template <class R, class F, class Self> constexpr R monadic_mapped_value(F &&f, Self &&self, std::true_type /*void return*/)
+  {
+    invoke_with_value(static_cast<F &&>(f), static_cast<Self &&>(self), self_value_is_void<Self>());
+    return R{in_place_type<typename R::value_type>};
+  }
+  template <class R, class F, class Self> constexpr R monadic_mapped_error(F &&f, Self &&self, std::false_type /*void return*/) { return R{in_place_type<typename R::error_type>, invoke_with_error(static_cast<F &&>(f), static_cast<Self &&>(self), self_error_is_void<Self>())}; }
+  template <class R, class F, class Self> constexpr R monadic_mapped_error(F &&f, Self &&self, std::true_type /*void return*/)
+  {
+    invoke_with_error(static_cast<F &&>(f), static_cast<Self &&>(self), self_error_is_void<Self>());
+    return R{in_place_type<typename R::error_type>};
+  }
+}  // namespace detail
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
@@ -33,25 +33,53 @@ OUTCOME_V2_NAMESPACE_BEGIN
 
 namespace detail
 {
-  // Customise _set_error_is_errno
-  template <class State> constexpr inline void _set_error_is_errno(State &state, const std::error_code &error)
+  /* The standard categories are looked up once during static initialisation, so classifying an error
+  compares it against a cached category rather than calling out of line into the standard library. If
+  used before the cache is initialised, the categories are looked up directly.
+  */
+  template <class T = void> struct std_categories
   {
-    if(error.category() == std::generic_category()
+    static const std::error_category *const generic;
+    static const std::error_category *const system;
+  };
+  template <class T> const std::error_category *const std_categories<T>::generic = &std::generic_category();
+  template <class T> const std::error_category *const std_categories<T>::system = &std::system_category();
+  inline bool is_errno_category(const std::error_category &cat) noexcept
+  {
+    const std::error_category *generic = std_categories<>::generic;
+    if(generic == nullptr)
+    {
+      generic = &std::generic_category();
+    }
+    if(cat == *generic)
+    {
+      return true;
+    }
 #ifndef _WIN32
-       || error.category() == std::system_category()
+    const std::error_category *system = std_categories<>::system;
+    if(system == nullptr)
+    {
+      system = &std::system_category();
+    }
+    if(cat == *system)
+    {
+      return true;
+    }
 #endif
-    )
+    return false;
+  }
+
+  // Customise _set_error_is_errno
+  template <class State> constexpr inline void _set_error_is_errno(State &state, const std::error_code &error)
+  {
+    if(is_errno_category(error.category()))
     {
       state._status |= status_error_is_errno;
     }
   }
   template <class State> constexpr inline void _set_error_is_errno(State &state, const std::error_condition &error)
   {
-    if(error.category() == std::generic_category()
-#ifndef _WIN32
-       || error.category() == std::system_category()
-#endif
-    )
+    if(is_errno_category(error.category()))
     {
       state._status |= status_error_is_errno;
     }
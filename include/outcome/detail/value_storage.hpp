@@ -34,15 +34,21 @@ namespace detail
   using status_bitfield_type = uint32_t;
 
   // WARNING: These bits are not tracked by abi-dumper, but changing them will break ABI!
-  static constexpr status_bitfield_type status_have_value = (1U << 0U);
-  static constexpr status_bitfield_type status_have_error = (1U << 1U);
-  static constexpr status_bitfield_type status_have_exception = (1U << 2U);
-  static constexpr status_bitfield_type status_error_is_errno = (1U << 4U);  // can errno be set from this error?
+  OUTCOME_INLINE_CONSTEXPR status_bitfield_type status_have_value = (1U << 0U);
+  OUTCOME_INLINE_CONSTEXPR status_bitfield_type status_have_error = (1U << 1U);
+  OUTCOME_INLINE_CONSTEXPR status_bitfield_type status_have_exception = (1U << 2U);
+  OUTCOME_INLINE_CONSTEXPR status_bitfield_type status_error_is_errno = (1U << 4U);  // can errno be set from this error?
   // bit 7 unused
-  // bits 8-15 unused
+  OUTCOME_INLINE_CONSTEXPR status_bitfield_type status_error_class_shift = 8;  // bits 8-15 cache trait::error_classifier<E>
+  OUTCOME_INLINE_CONSTEXPR status_bitfield_type status_error_class_mask = (0xffU << status_error_class_shift);
   // bits 16-31 used for user supplied 16 bit value
-  static constexpr status_bitfield_type status_2byte_shift = 16;
-  static constexpr status_bitfield_type status_2byte_mask = (0xffffU << status_2byte_shift);
+  OUTCOME_INLINE_CONSTEXPR status_bitfield_type status_2byte_shift = 16;
+  OUTCOME_INLINE_CONSTEXPR status_bitfield_type status_2byte_mask = (0xffffU << status_2byte_shift);
+
+  // Constructs the value from what invoking a callable returns, so a returned prvalue is never moved
+  struct in_place_invoke_tag
+  {
+  };
 
   // Used if T is trivial
   template <class T> struct value_storage_trivial
@@ -86,6 +92,12 @@ namespace detail
         , _status(status_have_value)
     {
     }
+    template <class F, class... Args>
+    constexpr value_storage_trivial(in_place_invoke_tag /*unused*/, F &&f, Args &&... args)
+        : _value(static_cast<F &&>(f)(static_cast<Args &&>(args)...))
+        , _status(status_have_value)
+    {
+    }
     template <class U> static constexpr bool enable_converting_constructor = !std::is_same<std::decay_t<U>, value_type>::value && std::is_constructible<value_type, U>::value;
     OUTCOME_TEMPLATE(class U)
     OUTCOME_TREQUIRES(OUTCOME_TPRED(enable_converting_constructor<U>))
@@ -118,57 +130,63 @@ namespace detail
       value_type _value;
     };
     status_bitfield_type _status{0};
-    value_storage_nontrivial() noexcept : _empty{} {}
+    OUTCOME_CXX20_CONSTEXPR value_storage_nontrivial() noexcept : _empty{} {}
     value_storage_nontrivial &operator=(const value_storage_nontrivial &) = default;                                        // if reaches here, copy assignment is trivial
     value_storage_nontrivial &operator=(value_storage_nontrivial &&) = default;                                             // NOLINT if reaches here, move assignment is trivial
-    value_storage_nontrivial(value_storage_nontrivial &&o) noexcept(std::is_nothrow_move_constructible<value_type>::value)  // NOLINT
+    OUTCOME_CXX20_CONSTEXPR value_storage_nontrivial(value_storage_nontrivial &&o) noexcept(std::is_nothrow_move_constructible<value_type>::value)  // NOLINT
     : _status(o._status)
     {
       if(this->_status & status_have_value)
       {
         this->_status &= ~status_have_value;
-        new(&_value) value_type(static_cast<value_type &&>(o._value));  // NOLINT
+        detail::construct_at(&_value, static_cast<value_type &&>(o._value));  // NOLINT
         _status = o._status;
       }
     }
-    value_storage_nontrivial(const value_storage_nontrivial &o) noexcept(std::is_nothrow_copy_constructible<value_type>::value)
+    OUTCOME_CXX20_CONSTEXPR value_storage_nontrivial(const value_storage_nontrivial &o) noexcept(std::is_nothrow_copy_constructible<value_type>::value)
         : _status(o._status)
     {
       if(this->_status & status_have_value)
       {
         this->_status &= ~status_have_value;
-        new(&_value) value_type(o._value);  // NOLINT
+        detail::construct_at(&_value, o._value);  // NOLINT
         _status = o._status;
       }
     }
     // Special from-void constructor, constructs default T if void valued
-    explicit value_storage_nontrivial(const value_storage_trivial<void> &o) noexcept(std::is_nothrow_default_constructible<value_type>::value)
+    OUTCOME_CXX20_CONSTEXPR explicit value_storage_nontrivial(const value_storage_trivial<void> &o) noexcept(std::is_nothrow_default_constructible<value_type>::value)
         : _status(o._status)
     {
       if(this->_status & status_have_value)
       {
         this->_status &= ~status_have_value;
-        new(&_value) value_type;  // NOLINT
+        detail::construct_at(&_value);  // NOLINT
         _status = o._status;
       }
     }
-    explicit value_storage_nontrivial(status_bitfield_type status)
+    OUTCOME_CXX20_CONSTEXPR explicit value_storage_nontrivial(status_bitfield_type status)
         : _empty()
         , _status(status)
     {
     }
     template <class... Args>
-    explicit value_storage_nontrivial(in_place_type_t<value_type> /*unused*/, Args &&... args) noexcept(std::is_nothrow_constructible<value_type, Args...>::value)
+    OUTCOME_CXX20_CONSTEXPR explicit value_storage_nontrivial(in_place_type_t<value_type> /*unused*/, Args &&... args) noexcept(std::is_nothrow_constructible<value_type, Args...>::value)
         : _value(static_cast<Args &&>(args)...)  // NOLINT
         , _status(status_have_value)
     {
     }
     template <class U, class... Args>
-    value_storage_nontrivial(in_place_type_t<value_type> /*unused*/, std::initializer_list<U> il, Args &&... args) noexcept(std::is_nothrow_constructible<value_type, std::initializer_list<U>, Args...>::value)
+    OUTCOME_CXX20_CONSTEXPR value_storage_nontrivial(in_place_type_t<value_type> /*unused*/, std::initializer_list<U> il, Args &&... args) noexcept(std::is_nothrow_constructible<value_type, std::initializer_list<U>, Args...>::value)
         : _value(il, static_cast<Args &&>(args)...)
         , _status(status_have_value)
     {
     }
+    template <class F, class... Args>
+    OUTCOME_CXX20_CONSTEXPR value_storage_nontrivial(in_place_invoke_tag /*unused*/, F &&f, Args &&... args)
+        : _value(static_cast<F &&>(f)(static_cast<Args &&>(args)...))
+        , _status(status_have_value)
+    {
+    }
     template <class U> static constexpr bool enable_converting_constructor = !std::is_same<std::decay_t<U>, value_type>::value && std::is_constructible<value_type, U>::value;
     OUTCOME_TEMPLATE(class U)
     OUTCOME_TREQUIRES(OUTCOME_TPRED(enable_converting_constructor<U>))
@@ -198,11 +216,11 @@ namespace detail
     {
       _status = o._status;
     }
-    ~value_storage_nontrivial() noexcept(std::is_nothrow_destructible<T>::value)
+    OUTCOME_CXX20_CONSTEXPR ~value_storage_nontrivial() noexcept(std::is_nothrow_destructible<T>::value)
     {
       if(this->_status & status_have_value)
       {
-        this->_value.~value_type();  // NOLINT
+        detail::destroy_at(&this->_value);  // NOLINT
         this->_status &= ~status_have_value;
       }
     }
@@ -224,15 +242,15 @@ namespace detail
       if((_status & status_have_value) != 0)
       {
         // Move construct me into other
-        new(&o._value) value_type(static_cast<value_type &&>(_value));  // NOLINT
-        this->_value.~value_type();                                     // NOLINT
+        detail::construct_at(&o._value, static_cast<value_type &&>(_value));  // NOLINT
+        detail::destroy_at(&this->_value);                                    // NOLINT
         swap(_status, o._status);
       }
       else
       {
         // Move construct other into me
-        new(&_value) value_type(static_cast<value_type &&>(o._value));  // NOLINT
-        o._value.~value_type();                                         // NOLINT
+        detail::construct_at(&_value, static_cast<value_type &&>(o._value));  // NOLINT
+        detail::destroy_at(&o._value);                                        // NOLINT
         swap(_status, o._status);
       }
     }
@@ -281,7 +299,7 @@ namespace detail
     value_storage_nontrivial_move_assignment(const value_storage_nontrivial_move_assignment &) = default;
     value_storage_nontrivial_move_assignment(value_storage_nontrivial_move_assignment &&) = default;  // NOLINT
     value_storage_nontrivial_move_assignment &operator=(const value_storage_nontrivial_move_assignment &o) = default;
-    value_storage_nontrivial_move_assignment &operator=(value_storage_nontrivial_move_assignment &&o) noexcept(std::is_nothrow_move_assignable<value_type>::value)  // NOLINT
+    OUTCOME_CXX20_CONSTEXPR value_storage_nontrivial_move_assignment &operator=(value_storage_nontrivial_move_assignment &&o) noexcept(std::is_nothrow_move_assignable<value_type>::value)  // NOLINT
     {
       if((this->_status & status_have_value) != 0 && (o._status & status_have_value) != 0)
       {
@@ -289,11 +307,11 @@ namespace detail
       }
       else if((this->_status & status_have_value) != 0 && (o._status & status_have_value) == 0)
       {
-        this->_value.~value_type();  // NOLINT
+        detail::destroy_at(&this->_value);  // NOLINT
       }
       else if((this->_status & status_have_value) == 0 && (o._status & status_have_value) != 0)
       {
-        new(&this->_value) value_type(static_cast<value_type &&>(o._value));  // NOLINT
+        detail::construct_at(&this->_value, static_cast<value_type &&>(o._value));  // NOLINT
       }
       this->_status = o._status;
       return *this;
@@ -307,7 +325,7 @@ namespace detail
     value_storage_nontrivial_copy_assignment(const value_storage_nontrivial_copy_assignment &) = default;
     value_storage_nontrivial_copy_assignment(value_storage_nontrivial_copy_assignment &&) = default;              // NOLINT
     value_storage_nontrivial_copy_assignment &operator=(value_storage_nontrivial_copy_assignment &&o) = default;  // NOLINT
-    value_storage_nontrivial_copy_assignment &operator=(const value_storage_nontrivial_copy_assignment &o) noexcept(std::is_nothrow_copy_assignable<value_type>::value)
+    OUTCOME_CXX20_CONSTEXPR value_storage_nontrivial_copy_assignment &operator=(const value_storage_nontrivial_copy_assignment &o) noexcept(std::is_nothrow_copy_assignable<value_type>::value)
     {
       if((this->_status & status_have_value) != 0 && (o._status & status_have_value) != 0)
       {
@@ -315,11 +333,11 @@ namespace detail
       }
       else if((this->_status & status_have_value) != 0 && (o._status & status_have_value) == 0)
       {
-        this->_value.~value_type();  // NOLINT
+        detail::destroy_at(&this->_value);  // NOLINT
       }
       else if((this->_status & status_have_value) == 0 && (o._status & status_have_value) != 0)
       {
-        new(&this->_value) value_type(o._value);  // NOLINT
+        detail::construct_at(&this->_value, o._value);  // NOLINT
       }
       this->_status = o._status;
       return *this;
@@ -0,0 +1,407 @@
+/* Error codes with context frames chained through an arena
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_ERROR_CONTEXT_HPP
+#define OUTCOME_ERROR_CONTEXT_HPP
+
+#include "detail/error_wrapper.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+/* Number of context frames in each thread's arena. Must be a power of two.
+*/
+#ifndef OUTCOME_ERROR_CONTEXT_ARENA_FRAMES
+#define OUTCOME_ERROR_CONTEXT_ARENA_FRAMES 1024
+#endif
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+class context_arena
+{
+public:
+  //! Formatted context longer than this is truncated
+  static constexpr size_t max_formatted_length = 39;
+
+  //! A copy of a frame of context, which is a static string or a short formatted one
+  struct frame
+  {
+    //! The static string of this frame, or null if the context is in `formatted`
+    const char *what;
+    //! The arena holding the previous frame in the chain, which can be another thread's
+    const context_arena *previous_arena;
+    //! The sequence number of this frame, used to detect frames overwritten by wraparound
+    uint32_t sequence;
+    //! The sequence number of the previous frame in the chain, or zero if this was the first
+    uint32_t previous;
+    char formatted[max_formatted_length + 1];
+
+    const char *text() const noexcept { return (what != nullptr) ? what : formatted; }
+  };
+
+private:
+  static_assert((max_formatted_length + 1) % sizeof(uint64_t) == 0, "formatted text must be a whole number of words");
+  /* A frame as stored. Other threads may read it while the writing thread overwrites it, so as in a
+  seqlock its sequence is zeroed before the other fields are written and set after, and readers
+  copy the fields then check the sequence did not change.
+  */
+  struct _slot
+  {
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint32_t> previous{0};
+    std::atomic<const char *> what{nullptr};
+    std::atomic<const context_arena *> previous_arena{nullptr};
+    std::atomic<uint64_t> formatted[(max_formatted_length + 1) / sizeof(uint64_t)];
+  };
+  // Arenas of exited threads, which later threads reuse
+  struct _thread_pool
+  {
+    std::mutex lock;
+    context_arena *free{nullptr};
+  };
+
+  std::unique_ptr<_slot[]> _slots;
+  uint32_t _mask;
+  uint32_t _next{1};
+  context_arena *_next_free{nullptr};
+
+  _slot &_begin(uint32_t &sequence) noexcept
+  {
+    if(!_slots)
+    {
+      _slots.reset(new _slot[_mask + 1]);
+    }
+    sequence = _next++;
+    if(sequence == 0)
+    {
+      sequence = _next++;
+    }
+    _slot &s = _slots[sequence & _mask];
+    s.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return s;
+  }
+  static uint32_t _publish(_slot &s, uint32_t sequence, const context_arena *previous_arena, uint32_t previous, const char *what) noexcept
+  {
+    s.what.store(what, std::memory_order_relaxed);
+    s.previous_arena.store(previous_arena, std::memory_order_relaxed);
+    s.previous.store(previous, std::memory_order_relaxed);
+    s.sequence.store(sequence, std::memory_order_release);
+    return sequence;
+  }
+
+  // Never destroyed, as threads may exit during static deinitialisation
+  static _thread_pool &_pool() noexcept
+  {
+    static _thread_pool *v = new _thread_pool;  // NOLINT
+    return *v;
+  }
+
+public:
+  //! Constructs an arena of `frames` frames, which must be a power of two. Memory is allocated on first use.
+  explicit context_arena(uint32_t frames = OUTCOME_ERROR_CONTEXT_ARENA_FRAMES)
+      : _mask(frames - 1)
+  {
+    if(frames == 0 || (frames & (frames - 1)) != 0)
+    {
+      OUTCOME_THROW_EXCEPTION(std::invalid_argument("context_arena frames must be a power of two"));
+    }
+  }
+  context_arena(const context_arena &) = delete;
+  context_arena(context_arena &&) = delete;
+  context_arena &operator=(const context_arena &) = delete;
+  context_arena &operator=(context_arena &&) = delete;
+  ~context_arena() = default;
+
+  //! The number of frames, after which the oldest are overwritten
+  uint32_t capacity() const noexcept { return _mask + 1; }
+
+  //! Appends a static string frame after `previous` in `previous_arena`, returning its sequence number. Only one thread may append at a time.
+  uint32_t append(const context_arena *previous_arena, uint32_t previous, const char *what) noexcept
+  {
+    uint32_t sequence;
+    _slot &s = _begin(sequence);
+    return _publish(s, sequence, previous_arena, previous, what);
+  }
+  //! Appends a `snprintf()` formatted frame after `previous` in `previous_arena`, returning its sequence number. Only one thread may append at a time.
+  template <class Arg, class... Args> uint32_t append_format(const context_arena *previous_arena, uint32_t previous, const char *format, Arg &&arg, Args &&... args) noexcept
+  {
+    char buffer[max_formatted_length + 1];
+    snprintf(buffer, sizeof(buffer), format, static_cast<Arg &&>(arg), static_cast<Args &&>(args)...);  // NOLINT
+    uint32_t sequence;
+    _slot &s = _begin(sequence);
+    for(size_t n = 0; n < sizeof(buffer) / sizeof(uint64_t); n++)
+    {
+      uint64_t word;
+      memcpy(&word, buffer + n * sizeof(uint64_t), sizeof(uint64_t));
+      s.formatted[n].store(word, std::memory_order_relaxed);
+    }
+    return _publish(s, sequence, previous_arena, previous, nullptr);
+  }
+  //! Copies the frame with sequence number `sequence` into `out`, returning false if it has since been overwritten. Any thread may call this while another appends.
+  bool find(uint32_t sequence, frame &out) const noexcept
+  {
+    if(sequence == 0 || !_slots)
+    {
+      return false;
+    }
+    const _slot &s = _slots[sequence & _mask];
+    if(s.sequence.load(std::memory_order_acquire) != sequence)
+    {
+      return false;
+    }
+    out.what = s.what.load(std::memory_order_relaxed);
+    out.previous_arena = s.previous_arena.load(std::memory_order_relaxed);
+    out.sequence = sequence;
+    out.previous = s.previous.load(std::memory_order_relaxed);
+    if(out.what == nullptr)
+    {
+      for(size_t n = 0; n < sizeof(out.formatted) / sizeof(uint64_t); n++)
+      {
+        const uint64_t word = s.formatted[n].load(std::memory_order_relaxed);
+        memcpy(out.formatted + n * sizeof(uint64_t), &word, sizeof(uint64_t));
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s.sequence.load(std::memory_order_relaxed) == sequence;
+  }
+
+  /*! The arena of the calling thread. These arenas are never freed. When a thread exits its arena is
+  reused by a later thread, continuing its sequence numbers, so context added by an exited thread
+  remains readable until it is overwritten.
+  */
+  static context_arena &this_thread() noexcept
+  {
+    struct lease
+    {
+      context_arena *arena{nullptr};
+      lease() noexcept
+      {
+        _thread_pool &pool = _pool();
+        {
+          std::lock_guard<std::mutex> g(pool.lock);
+          arena = pool.free;
+          if(arena != nullptr)
+          {
+            pool.free = arena->_next_free;
+            return;
+          }
+        }
+        arena = new context_arena;  // NOLINT
+      }
+      lease(const lease &) = delete;
+      lease(lease &&) = delete;
+      lease &operator=(const lease &) = delete;
+      lease &operator=(lease &&) = delete;
+      ~lease()
+      {
+        _thread_pool &pool = _pool();
+        std::lock_guard<std::mutex> g(pool.lock);
+        arena->_next_free = pool.free;
+        pool.free = arena;
+      }
+    };
+    static thread_local lease v;
+    return *v.arena;
+  }
+};
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class EC = std::error_code> class error_with_context
+{
+  EC _code;
+  const context_arena *_arena{nullptr};
+  uint32_t _head{0};
+
+  template <class T> using _is_comparable = std::conditional_t<std::is_same<T, error_with_context>::value, std::false_type, detail::error_wrapper_is_comparable<EC, T>>;
+
+public:
+  //! The error code type
+  using error_code_type = EC;
+
+  //! Default constructor, with a default constructed error code and no context
+  error_with_context() = default;
+  //! Implicit constructor from an error code, with no context
+  error_with_context(const EC &code) noexcept(std::is_nothrow_copy_constructible<EC>::value)  // NOLINT
+      : _code(code)
+  {
+  }
+  //! Constructs from an error code and a static string frame of context
+  error_with_context(const EC &code, const char *what, context_arena &arena = context_arena::this_thread()) noexcept(std::is_nothrow_copy_constructible<EC>::value)
+      : _code(code)
+      , _arena(&arena)
+      , _head(arena.append(nullptr, 0, what))
+  {
+  }
+
+  //! The error code
+  const EC &code() const noexcept { return _code; }
+  //! True if any context has been added
+  bool has_context() const noexcept { return _head != 0; }
+
+  //! Adds a static string frame of context, which must outlive the error
+  error_with_context &add(const char *what, context_arena &arena = context_arena::this_thread()) noexcept
+  {
+    _head = arena.append(_arena, _head, what);
+    _arena = &arena;
+    return *this;
+  }
+  //! Adds a `snprintf()` formatted frame of context, truncated to `context_arena::max_formatted_length` characters
+  template <class Arg, class... Args> error_with_context &add_format(const char *format, Arg &&arg, Args &&... args) noexcept { return add_format(context_arena::this_thread(), format, static_cast<Arg &&>(arg), static_cast<Args &&>(args)...); }
+  //! As above, but into `arena`
+  template <class Arg, class... Args> error_with_context &add_format(context_arena &arena, const char *format, Arg &&arg, Args &&... args) noexcept
+  {
+    _head = arena.append_format(_arena, _head, format, static_cast<Arg &&>(arg), static_cast<Args &&>(args)...);
+    _arena = &arena;
+    return *this;
+  }
+
+  //! Calls `f` with the text of each frame, most recently added first. Returns false if the chain was truncated by arenas wrapping.
+  template <class F> bool visit_context(F &&f) const
+  {
+    const context_arena *arena = _arena;
+    uint32_t sequence = _head;
+    context_arena::frame fr;
+    while(sequence != 0)
+    {
+      if(arena == nullptr || !arena->find(sequence, fr))
+      {
+        return false;
+      }
+      f(fr.text());
+      arena = fr.previous_arena;
+      sequence = fr.previous;
+    }
+    return true;
+  }
+  //! Renders the context, most recently added first, then the message of the error code, separated by colons
+  std::string render() const
+  {
+    std::string ret;
+    if(!visit_context([&](const char *text) {
+         ret.append(text);
+         ret.append(": ");
+       }))
+    {
+      ret.append("...: ");
+    }
+    ret.append(_code.message().c_str());
+    return ret;
+  }
+
+  //! Compares the error codes only
+  friend bool operator==(const error_with_context &a, const error_with_context &b) noexcept { return a._code == b._code; }
+  friend bool operator!=(const error_with_context &a, const error_with_context &b) noexcept { return !(a._code == b._code); }
+  //! Compares the error code with anything comparable to the error code, such as an error enum
+  template <class T, std::enable_if_t<_is_comparable<T>::value, bool> = true> friend bool operator==(const error_with_context &a, const T &b) noexcept { return a._code == b; }
+  template <class T, std::enable_if_t<_is_comparable<T>::value, bool> = true> friend bool operator==(const T &a, const error_with_context &b) noexcept { return b._code == a; }
+  template <class T, std::enable_if_t<_is_comparable<T>::value, bool> = true> friend bool operator!=(const error_with_context &a, const T &b) noexcept { return !(a._code == b); }
+  template <class T, std::enable_if_t<_is_comparable<T>::value, bool> = true> friend bool operator!=(const T &a, const error_with_context &b) noexcept { return !(b._code == a); }
+};
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class T, class EC = std::error_code> using context_result = basic_result<T, error_with_context<EC>, policy::default_policy<T, error_with_context<EC>, void>>;
+
+namespace detail
+{
+  template <class EC> struct error_wrapper_traits<error_with_context<EC>>
+  {
+    static constexpr bool value = true;
+    using wrapped_type = EC;
+    static const EC *wrapped(const error_with_context<EC> &v) noexcept { return &v.code(); }
+  };
+
+  template <class T, class EC, class NoValuePolicy> inline context_result<T, EC> as_context_result(basic_result<T, EC, NoValuePolicy> &&r) { return r ? context_result<T, EC>(in_place_type<T>, static_cast<T &&>(r.assume_value())) : context_result<T, EC>(in_place_type<error_with_context<EC>>, static_cast<EC &&>(r.assume_error())); }
+  template <class EC, class NoValuePolicy> inline context_result<void, EC> as_context_result(basic_result<void, EC, NoValuePolicy> &&r) { return r ? context_result<void, EC>(in_place_type<void>) : context_result<void, EC>(in_place_type<error_with_context<EC>>, static_cast<EC &&>(r.assume_error())); }
+  template <class T, class EC, class NoValuePolicy> inline basic_result<T, error_with_context<EC>, NoValuePolicy> &&as_context_result(basic_result<T, error_with_context<EC>, NoValuePolicy> &&r) { return static_cast<basic_result<T, error_with_context<EC>, NoValuePolicy> &&>(r); }
+}  // namespace detail
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class R> inline auto add_context(R &&r, const char *what, context_arena &arena = context_arena::this_thread()) -> std::decay_t<decltype(detail::as_context_result(static_cast<R &&>(r)))>
+{
+  auto ret = detail::as_context_result(static_cast<R &&>(r));
+  if(ret.has_error())
+  {
+    ret.assume_error().add(what, arena);
+  }
+  return ret;
+}
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class R, class Arg, class... Args> inline auto add_context_format(R &&r, const char *format, Arg &&arg, Args &&... args) -> std::decay_t<decltype(detail::as_context_result(static_cast<R &&>(r)))>
+{
+  auto ret = detail::as_context_result(static_cast<R &&>(r));
+  if(ret.has_error())
+  {
+    ret.assume_error().add_format(format, static_cast<Arg &&>(arg), static_cast<Args &&>(args)...);
+  }
+  return ret;
+}
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class R, class Arg, class... Args> inline auto add_context_format(R &&r, context_arena &arena, const char *format, Arg &&arg, Args &&... args) -> std::decay_t<decltype(detail::as_context_result(static_cast<R &&>(r)))>
+{
+  auto ret = detail::as_context_result(static_cast<R &&>(r));
+  if(ret.has_error())
+  {
+    ret.assume_error().add_format(arena, format, static_cast<Arg &&>(arg), static_cast<Args &&>(args)...);
+  }
+  return ret;
+}
+
+namespace trait
+{
+  // An error with context is an error type if its error code is
+  template <class EC> struct is_error_type<error_with_context<EC>> : detail::wrapped_is_error_type<error_with_context<EC>>
+  {
+  };
+  template <class EC, class Enum> struct is_error_type_enum<error_with_context<EC>, Enum> : detail::wrapped_is_error_type_enum<error_with_context<EC>, Enum>
+  {
+  };
+  // And is classified as its error code is
+  template <class EC> struct error_classifier<error_with_context<EC>>
+  {
+    template <class U = EC> static auto classify(const error_with_context<EC> &v) noexcept -> decltype(error_classifier<U>::classify(v.code())) { return error_classifier<U>::classify(v.code()); }
+  };
+}  // namespace trait
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
@@ -0,0 +1,167 @@
+/* Opt-in injection of failures into successful result and outcome construction
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_ERROR_INJECTION_HPP
+#define OUTCOME_ERROR_INJECTION_HPP
+
+#include "trait.hpp"
+
+#include <atomic>
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+namespace error_injection
+{
+  namespace detail
+  {
+    // Injection happens inside a noexcept construction hook, so the error factory must not throw.
+    // Before C++ 17 that cannot be part of the function pointer type, so a throw skips the injection.
+#ifdef __cpp_noexcept_function_type
+    template <class E> using make_error_function = E (*)() noexcept;
+#else
+    template <class E> using make_error_function = E (*)();
+#endif
+
+    // Per result or outcome type injection configuration. A zero threshold means disabled.
+    template <class T> struct site
+    {
+      using error_type = typename T::error_type;
+      static std::atomic<uint32_t> threshold;
+      static std::atomic<make_error_function<error_type>> make_error;
+    };
+    template <class T> std::atomic<uint32_t> site<T>::threshold{0};
+    template <class T> std::atomic<make_error_function<typename site<T>::error_type>> site<T>::make_error{nullptr};
+
+    // Per-thread xorshift32, seeded from the address of its own state so each thread differs.
+    // Trivially destructible and zero initialised, so access needs no thread local guard.
+    inline uint32_t random32() noexcept
+    {
+      static OUTCOME_THREAD_LOCAL uint32_t state;
+      uint32_t x = state;
+      if(x == 0)
+      {
+        x = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&state) >> 4U) | 1U;  // NOLINT
+      }
+      x ^= x << 13U;
+      x ^= x >> 17U;
+      x ^= x << 5U;
+      state = x;
+      return x;
+    }
+
+    template <class T> inline void do_inject(T *r, std::true_type /*can inject*/) noexcept
+    {
+      using error_type = typename T::error_type;
+      make_error_function<error_type> make_error = site<T>::make_error.load(std::memory_order_acquire);
+      if(make_error != nullptr)
+      {
+#if !defined(__cpp_noexcept_function_type) && defined(__cpp_exceptions)
+        try
+        {
+#endif
+          // All members of *r are constructed by now. The error replaces the value in place, as constructing
+          // a failed result and assigning it would run the construction hooks, and so all instrumentation, twice.
+          r->_replace_value_with_error(make_error());
+#if !defined(__cpp_noexcept_function_type) && defined(__cpp_exceptions)
+        }
+        catch(...)
+        {
+          // The factory threw, so leave the value in place
+        }
+#endif
+      }
+    }
+    template <class T> inline void do_inject(T * /*unused*/, std::false_type /*can inject*/) noexcept {}
+
+    template <class T, bool = !std::is_void<typename T::error_type>::value> struct can_inject : std::false_type
+    {
+    };
+    template <class T>
+    struct can_inject<T, true> : std::integral_constant<bool, !std::is_same<typename T::value_type, typename T::error_type>::value && std::is_nothrow_move_constructible<typename T::error_type>::value && std::is_nothrow_move_assignable<typename T::error_type>::value>
+    {
+    };
+
+    template <class T> QUICKCPPLIB_NOINLINE inline void maybe_inject(T *r, uint32_t threshold) noexcept
+    {
+      // xorshift32 never returns zero, so a threshold of 0xffffffff always injects
+      if(random32() <= threshold)
+      {
+        do_inject(r, std::integral_constant<bool, can_inject<T>::value>());
+      }
+    }
+
+    template <class T> inline void on_construction(T *r) noexcept
+    {
+      // When not injecting, this is a single relaxed load and branch
+      const uint32_t threshold = site<T>::threshold.load(std::memory_order_relaxed);
+      if(threshold != 0 && r->has_value())
+      {
+        maybe_inject(r, threshold);
+      }
+    }
+
+    template <class T> using has_failure_observer = decltype(std::declval<const T &>().has_failure());
+
+    // Conversions from another result or outcome have already had their chance of injection
+    template <class T, class U> inline void on_copy_or_move_construction(T *r, const U & /*unused*/) noexcept
+    {
+      if(!trait::detail::is_detected<has_failure_observer, U>::value)
+      {
+        on_construction(r);
+      }
+    }
+  }  // namespace detail
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class T, class F> inline void inject(double rate, F make_error) noexcept
+  {
+    static_assert(std::is_convertible<F, detail::make_error_function<typename T::error_type>>::value, "make_error must be a noexcept function taking no arguments and returning the error_type of T");
+    uint32_t threshold = 0;
+    if(rate >= 1.0)
+    {
+      threshold = 0xffffffffU;
+    }
+    else if(rate > 0.0)
+    {
+      threshold = static_cast<uint32_t>(rate * 4294967296.0);
+      threshold = (threshold == 0) ? 1 : threshold;
+    }
+    detail::site<T>::make_error.store(static_cast<detail::make_error_function<typename T::error_type>>(make_error), std::memory_order_release);
+    detail::site<T>::threshold.store(threshold, std::memory_order_relaxed);
+  }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class T> inline void stop() noexcept { detail::site<T>::threshold.store(0, std::memory_order_relaxed); }
+}  // namespace error_injection
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
@@ -0,0 +1,400 @@
+/* Small buffer optimised list of errors
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_ERROR_LIST_HPP
+#define OUTCOME_ERROR_LIST_HPP
+
+#include "detail/error_wrapper.hpp"
+
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class E, size_t N = 3> class error_list
+{
+  static_assert(N > 0, "error_list must have at least one inline slot");
+  static_assert(std::is_nothrow_move_constructible<E>::value, "error_list requires error types which are nothrow move constructible");
+  template <class F, size_t M> friend class error_list;
+
+public:
+  using value_type = E;
+  using size_type = size_t;
+  using reference = E &;
+  using const_reference = const E &;
+  using iterator = E *;
+  using const_iterator = const E *;
+
+private:
+  // The errors live inline until more than N are added, after which they all live on the heap
+  union _storage_t {
+    E *heap;
+    E inline_[N];
+    constexpr _storage_t() noexcept
+        : heap(nullptr)
+    {
+    }
+    ~_storage_t() {}  // NOLINT
+  } _storage;
+  unsigned _size{0}, _capacity{N};
+
+  bool _on_heap() const noexcept { return _capacity > N; }
+  E *_data() noexcept { return _on_heap() ? _storage.heap : _storage.inline_; }
+  const E *_data() const noexcept { return _on_heap() ? _storage.heap : _storage.inline_; }
+  size_t _grown_capacity(size_t count) const noexcept { return (_capacity * 2 > count) ? _capacity * 2 : count; }
+  // Moves the errors into p, which has room for capacity errors, and releases their old storage
+  void _adopt(E *p, size_t capacity) noexcept
+  {
+    E *from = _data();
+    for(unsigned n = 0; n < _size; n++)
+    {
+      new(p + n) E(static_cast<E &&>(from[n]));
+      from[n].~E();
+    }
+    _deallocate();
+    _storage.heap = p;
+    _capacity = static_cast<unsigned>(capacity);
+  }
+  void _reserve(size_t count)
+  {
+    if(count <= _capacity)
+    {
+      return;
+    }
+    size_t capacity = _grown_capacity(count);
+    _adopt(std::allocator<E>().allocate(capacity), capacity);
+  }
+  void _deallocate() noexcept
+  {
+    if(_on_heap())
+    {
+      std::allocator<E>().deallocate(_storage.heap, _capacity);
+      _storage.heap = nullptr;
+      _capacity = N;
+    }
+  }
+  template <class It> void _copy_from(It first, It last)
+  {
+    _reserve(_size + static_cast<size_t>(std::distance(first, last)));
+    E *p = _data();
+    for(; first != last; ++first)
+    {
+      new(p + _size) E(*first);
+      ++_size;
+    }
+  }
+  // Copies during construction, when the destructor will not clean up after a throwing copy
+  template <class It> void _construct_from(It first, It last)
+  {
+#ifdef __cpp_exceptions
+    try
+    {
+#endif
+      _copy_from(first, last);
+#ifdef __cpp_exceptions
+    }
+    catch(...)
+    {
+      clear();
+      _deallocate();
+      throw;
+    }
+#endif
+  }
+  template <size_t M> void _move_from(error_list<E, M> &&o)
+  {
+    if(_size == 0 && o._on_heap() && o._capacity > N)
+    {
+      // Steal the heap allocation of the source
+      _deallocate();
+      _storage.heap = o._storage.heap;
+      _size = o._size;
+      _capacity = o._capacity;
+      o._storage.heap = nullptr;
+      o._size = 0;
+      o._capacity = M;
+      return;
+    }
+    _reserve(_size + o._size);  // cannot throw when moving from a list of the same inline capacity into an empty list
+    E *p = _data();
+    E *from = o._data();
+    for(unsigned n = 0; n < o._size; n++)
+    {
+      new(p + _size) E(static_cast<E &&>(from[n]));
+      ++_size;
+    }
+    o.clear();
+  }
+
+public:
+  //! Default constructor, constructing no errors
+  constexpr error_list() noexcept {}  // NOLINT
+  //! Implicit constructor from a single error
+  error_list(const E &e)  // NOLINT
+  {
+    new(_storage.inline_) E(e);
+    _size = 1;
+  }
+  //! Implicit constructor from a single error
+  error_list(E &&e) noexcept  // NOLINT
+  {
+    new(_storage.inline_) E(static_cast<E &&>(e));
+    _size = 1;
+  }
+  //! Constructs from a list of errors
+  error_list(std::initializer_list<E> il) { _construct_from(il.begin(), il.end()); }
+  //! Explicit conversion from a list of errors with a different inline capacity
+  template <size_t M, std::enable_if_t<M != N, bool> = true> explicit error_list(const error_list<E, M> &o) { _construct_from(o.begin(), o.end()); }
+  //! Explicit conversion from a list of errors with a different inline capacity
+  template <size_t M, std::enable_if_t<M != N, bool> = true> explicit error_list(error_list<E, M> &&o) noexcept(M <= N) { _move_from(static_cast<error_list<E, M> &&>(o)); }
+  error_list(const error_list &o) { _construct_from(o.begin(), o.end()); }
+  error_list(error_list &&o) noexcept { _move_from(static_cast<error_list &&>(o)); }
+  error_list &operator=(const error_list &o)
+  {
+    if(this != &o)
+    {
+      clear();
+      _copy_from(o.begin(), o.end());
+    }
+    return *this;
+  }
+  error_list &operator=(error_list &&o) noexcept
+  {
+    if(this != &o)
+    {
+      clear();
+      _move_from(static_cast<error_list &&>(o));
+    }
+    return *this;
+  }
+  ~error_list()
+  {
+    clear();
+    _deallocate();
+  }
+  //! Swaps with another list
+  void swap(error_list &o) noexcept
+  {
+    error_list temp(static_cast<error_list &&>(o));
+    o = static_cast<error_list &&>(*this);
+    *this = static_cast<error_list &&>(temp);
+  }
+
+  //! The number of errors which can be stored without allocating memory
+  static constexpr size_type inline_capacity() noexcept { return N; }
+  //! The number of errors which can be stored without reallocating
+  size_type capacity() const noexcept { return _capacity; }
+  //! The number of errors
+  size_type size() const noexcept { return _size; }
+  //! True if there are no errors
+  bool empty() const noexcept { return _size == 0; }
+
+  E *data() noexcept { return _data(); }
+  const E *data() const noexcept { return _data(); }
+  iterator begin() noexcept { return _data(); }
+  const_iterator begin() const noexcept { return _data(); }
+  iterator end() noexcept { return _data() + _size; }
+  const_iterator end() const noexcept { return _data() + _size; }
+  reference operator[](size_type idx) noexcept { return _data()[idx]; }
+  const_reference operator[](size_type idx) const noexcept { return _data()[idx]; }
+  //! The first error, which is the one reported by `make_error_code()`
+  reference front() noexcept { return _data()[0]; }
+  const_reference front() const noexcept { return _data()[0]; }
+  reference back() noexcept { return _data()[_size - 1]; }
+  const_reference back() const noexcept { return _data()[_size - 1]; }
+
+  //! Constructs an error at the end of the list, allocating memory if the inline slots are exhausted
+  template <class... Args> reference emplace_back(Args &&... args)
+  {
+    if(_size < _capacity)
+    {
+      E *p = new(_data() + _size) E(static_cast<Args &&>(args)...);
+      ++_size;
+      return *p;
+    }
+    // The arguments may refer to one of the errors, so construct the new error before moving the others
+    size_t capacity = _grown_capacity(_size + 1);
+    E *p = std::allocator<E>().allocate(capacity);
+#ifdef __cpp_exceptions
+    try
+    {
+#endif
+      new(p + _size) E(static_cast<Args &&>(args)...);
+#ifdef __cpp_exceptions
+    }
+    catch(...)
+    {
+      std::allocator<E>().deallocate(p, capacity);
+      throw;
+    }
+#endif
+    _adopt(p, capacity);
+    return p[_size++];
+  }
+  void push_back(const E &e) { emplace_back(e); }
+  void push_back(E &&e) { emplace_back(static_cast<E &&>(e)); }
+  //! Appends all the errors of another list
+  template <size_t M> void append(const error_list<E, M> &o)
+  {
+    if(static_cast<const void *>(&o) == this)
+    {
+      // Growing would free the errors being copied
+      error_list copy(*this);
+      _copy_from(copy.begin(), copy.end());
+      return;
+    }
+    _copy_from(o.begin(), o.end());
+  }
+  //! Appends all the errors of another list
+  template <size_t M> void append(error_list<E, M> &&o)
+  {
+    _reserve(_size + o._size);
+    _move_from(static_cast<error_list<E, M> &&>(o));
+  }
+  //! Destroys all the errors, retaining any heap allocation
+  void clear() noexcept
+  {
+    E *p = _data();
+    for(unsigned n = 0; n < _size; n++)
+    {
+      p[n].~E();
+    }
+    _size = 0;
+  }
+
+  template <size_t M> bool operator==(const error_list<E, M> &o) const noexcept
+  {
+    if(_size != o.size())
+    {
+      return false;
+    }
+    for(unsigned n = 0; n < _size; n++)
+    {
+      if(!((*this)[n] == o[n]))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+  template <size_t M> bool operator!=(const error_list<E, M> &o) const noexcept { return !(*this == o); }
+};
+
+//! Swaps two lists of errors
+template <class E, size_t N> inline void swap(error_list<E, N> &a, error_list<E, N> &b) noexcept
+{
+  a.swap(b);
+}
+
+namespace detail
+{
+  // A list of errors forwards to its first error, if any
+  template <class E, size_t N> struct error_wrapper_traits<error_list<E, N>>
+  {
+    static constexpr bool value = true;
+    using wrapped_type = E;
+    static const E *wrapped(const error_list<E, N> &errors) noexcept { return errors.empty() ? nullptr : &errors.front(); }
+  };
+
+  template <class E, size_t N, class F> inline void error_list_append(error_list<E, N> &errors, F &&e) { errors.push_back(static_cast<F &&>(e)); }
+  template <class E, size_t N, size_t M> inline void error_list_append(error_list<E, N> &errors, const error_list<E, M> &o) { errors.append(o); }
+  template <class E, size_t N, size_t M> inline void error_list_append(error_list<E, N> &errors, error_list<E, M> &&o) { errors.append(static_cast<error_list<E, M> &&>(o)); }
+  template <class E, size_t N, size_t M> inline void error_list_append(error_list<E, N> &errors, error_list<E, M> &o) { errors.append(o); }
+
+  template <class E> struct error_list_element
+  {
+    using type = E;
+  };
+  template <class E, size_t N> struct error_list_element<error_list<E, N>>
+  {
+    using type = E;
+  };
+
+  template <class Result, class OutputIt> inline void error_list_collect_value(std::true_type /*void value*/, Result && /*unused*/, OutputIt & /*unused*/) {}
+  template <class Result, class OutputIt> inline void error_list_collect_value(std::false_type /*void value*/, Result &&r, OutputIt &out)
+  {
+    *out = static_cast<Result &&>(r).assume_value();
+    ++out;
+  }
+}  // namespace detail
+
+namespace trait
+{
+  // A list of errors is an error type if its errors are
+  template <class E, size_t N> struct is_error_type<error_list<E, N>> : detail::wrapped_is_error_type<error_list<E, N>>
+  {
+  };
+  template <class E, size_t N, class Enum> struct is_error_type_enum<error_list<E, N>, Enum> : detail::wrapped_is_error_type_enum<error_list<E, N>, Enum>
+  {
+  };
+}  // namespace trait
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class T, class E, size_t N = 3> using error_list_result = basic_result<T, error_list<E, N>, policy::default_policy<T, error_list<E, N>, void>>;
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class E, size_t N, class Result>
+inline auto accumulate_errors(error_list<E, N> &errors, Result &&r) -> decltype(detail::error_list_append(errors, static_cast<Result &&>(r).assume_error()), bool())
+{
+  if(r.has_error())
+  {
+    detail::error_list_append(errors, static_cast<Result &&>(r).assume_error());
+    return false;
+  }
+  return true;
+}
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <size_t N = 3, class InputIt, class OutputIt, class E = typename detail::error_list_element<typename std::iterator_traits<InputIt>::value_type::error_type>::type>
+inline error_list_result<OutputIt, E, N> collect(InputIt first, InputIt last, OutputIt out)
+{
+  using result_type = typename std::iterator_traits<InputIt>::value_type;
+  error_list<E, N> errors;
+  for(; first != last; ++first)
+  {
+    if(accumulate_errors(errors, *first))
+    {
+      detail::error_list_collect_value(std::is_void<typename result_type::value_type>(), *first, out);
+    }
+  }
+  if(!errors.empty())
+  {
+    return error_list_result<OutputIt, E, N>(in_place_type<error_list<E, N>>, static_cast<error_list<E, N> &&>(errors));
+  }
+  return error_list_result<OutputIt, E, N>(in_place_type<OutputIt>, out);
+}
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
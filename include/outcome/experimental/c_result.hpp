@@ -0,0 +1,77 @@
+/* C++ side of the C interface for result
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_EXPERIMENTAL_C_RESULT_HPP
+#define OUTCOME_EXPERIMENTAL_C_RESULT_HPP
+
+#include "../basic_result.hpp"
+#include "result.h"
+
+#include <cstring>  // for memcpy
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+namespace experimental
+{
+  namespace detail
+  {
+    template <class C, class R, class S> struct c_result_layout_matches
+    {
+      using cpp_type = basic_result<R, S, policy::all_narrow>;
+      using layout = OUTCOME_V2_NAMESPACE::detail::basic_result_storage_layout<R, S, policy::all_narrow>;
+      static constexpr bool value = std::is_standard_layout<C>::value && std::is_trivially_copyable<cpp_type>::value  //
+                                    && sizeof(C) == sizeof(cpp_type) && alignof(C) == alignof(cpp_type)             //
+                                    && offsetof(C, value) == layout::value_offset                                   //
+                                    && offsetof(C, flags) == layout::status_offset && sizeof(std::declval<C>().flags) == layout::status_size  //
+                                    && offsetof(C, error) == layout::error_offset;
+    };
+  }  // namespace detail
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class C, class R, class S, class NoValuePolicy> inline void to_c_result(C &slot, const basic_result<R, S, NoValuePolicy> &r) noexcept
+  {
+    static_assert(detail::c_result_layout_matches<C, R, S>::value, "C result type does not have the same layout as the basic_result being written into it");
+    memcpy(&slot, &r, sizeof(C));
+  }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class C, class F> inline void fill_c_results(C *slots, size_t count, F &&f)
+  {
+    for(size_t n = 0; n < count; n++)
+    {
+      to_c_result(slots[n], f(n));
+    }
+  }
+}  // namespace experimental
+OUTCOME_V2_NAMESPACE_END
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+#define CXX_RESULT_CHECK_LAYOUT(C, R, S) static_assert(OUTCOME_V2_NAMESPACE::experimental::detail::c_result_layout_matches<C, R, S>::value, #C " does not have the same layout as basic_result<" #R ", " #S ">")
+
+#endif
@@ -0,0 +1,549 @@
+/* errno native POSIX i/o returning status results
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_EXPERIMENTAL_POSIX_HPP
+#define OUTCOME_EXPERIMENTAL_POSIX_HPP
+
+#ifdef _WIN32
+#error <outcome/experimental/posix.hpp> requires a POSIX platform
+#endif
+
+#include "status_result.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// The io_uring backend of posix::io_queue is used on Linux where the kernel headers are available
+#ifndef OUTCOME_POSIX_USE_IO_URING
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define OUTCOME_POSIX_USE_IO_URING 1
+#endif
+#endif
+#endif
+#ifndef OUTCOME_POSIX_USE_IO_URING
+#define OUTCOME_POSIX_USE_IO_URING 0
+#endif
+#if OUTCOME_POSIX_USE_IO_URING
+#include <linux/io_uring.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+namespace experimental
+{
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class T> using posix_result = status_result<T, posix_code>;
+}  // namespace experimental
+
+namespace detail
+{
+  // A posix_code is constructed straight from errno, without any category lookup, and sets status_error_is_errno
+  template <class T> inline experimental::posix_result<T> posix_failure(int code = errno) noexcept { return experimental::posix_result<T>(in_place_type<experimental::posix_code>, code); }
+
+  // Calls a syscall returning -1 on failure, retrying if it was interrupted by a signal
+  template <class T, class F> inline experimental::posix_result<T> posix_call(F &&f) noexcept
+  {
+    auto ret = f();
+    while(-1 == ret && EINTR == errno)
+    {
+      ret = f();
+    }
+    if(-1 == ret)
+    {
+      return posix_failure<T>();
+    }
+    return static_cast<T>(ret);
+  }
+}  // namespace detail
+
+namespace experimental
+{
+  namespace posix
+  {
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<int> open(const char *path, int flags, mode_t mode = 0) noexcept
+    {
+      return detail::posix_call<int>([&] { return ::open(path, flags, mode); });  // NOLINT
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<void> close(int fd) noexcept
+    {
+      // close() must not be retried on EINTR, as the descriptor has already been released on Linux
+      if(-1 == ::close(fd))
+      {
+        return detail::posix_failure<void>();
+      }
+      return success();
+    }
+
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> read(int fd, void *buffer, size_t bytes) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::read(fd, buffer, bytes); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> write(int fd, const void *buffer, size_t bytes) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::write(fd, buffer, bytes); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> pread(int fd, void *buffer, size_t bytes, off_t offset) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::pread(fd, buffer, bytes, offset); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> pwrite(int fd, const void *buffer, size_t bytes, off_t offset) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::pwrite(fd, buffer, bytes, offset); });
+    }
+
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> readv(int fd, const struct iovec *buffers, int count) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::readv(fd, buffers, count); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> writev(int fd, const struct iovec *buffers, int count) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::writev(fd, buffers, count); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> preadv(int fd, const struct iovec *buffers, int count, off_t offset) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::preadv(fd, buffers, count, offset); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> pwritev(int fd, const struct iovec *buffers, int count, off_t offset) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::pwritev(fd, buffers, count, offset); });
+    }
+#if defined(__linux__) && defined(RWF_NOWAIT)
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> preadv2(int fd, const struct iovec *buffers, int count, off_t offset, int flags) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::preadv2(fd, buffers, count, offset, flags); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> pwritev2(int fd, const struct iovec *buffers, int count, off_t offset, int flags) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::pwritev2(fd, buffers, count, offset, flags); });
+    }
+#endif
+
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<int> socket(int domain, int type, int protocol) noexcept
+    {
+      return detail::posix_call<int>([&] { return ::socket(domain, type, protocol); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<int> accept(int fd, struct sockaddr *addr = nullptr, socklen_t *addrlen = nullptr) noexcept
+    {
+      return detail::posix_call<int>([&] { return ::accept(fd, addr, addrlen); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<void> connect(int fd, const struct sockaddr *addr, socklen_t addrlen) noexcept
+    {
+      // An interrupted connect() continues asynchronously, so it is not retried
+      if(-1 == ::connect(fd, addr, addrlen))
+      {
+        return detail::posix_failure<void>();
+      }
+      return success();
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> send(int fd, const void *buffer, size_t bytes, int flags = 0) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::send(fd, buffer, bytes, flags); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> recv(int fd, void *buffer, size_t bytes, int flags = 0) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::recv(fd, buffer, bytes, flags); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> sendmsg(int fd, const struct msghdr *msg, int flags = 0) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::sendmsg(fd, msg, flags); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> recvmsg(int fd, struct msghdr *msg, int flags = 0) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::recvmsg(fd, msg, flags); });
+    }
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> sendmmsg(int fd, struct mmsghdr *msgs, unsigned count, int flags = 0) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::sendmmsg(fd, msgs, count, flags); });
+    }
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    inline posix_result<size_t> recvmmsg(int fd, struct mmsghdr *msgs, unsigned count, int flags = 0, struct timespec *timeout = nullptr) noexcept
+    {
+      return detail::posix_call<size_t>([&] { return ::recvmmsg(fd, msgs, count, flags, timeout); });
+    }
+#endif
+
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    enum class io_operation : unsigned char
+    {
+      read,
+      write
+    };
+
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    struct io_request
+    {
+      io_operation operation;
+      int fd;
+      const struct iovec *buffers;
+      int buffers_count;
+      off_t offset;  // -1 for the current file position
+    };
+
+    /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+    class io_queue
+    {
+#if OUTCOME_POSIX_USE_IO_URING
+      int _ring{-1};
+      unsigned _entries{0};
+      unsigned *_sq_tail{nullptr}, *_sq_array{nullptr}, _sq_mask{0};
+      unsigned *_cq_head{nullptr}, *_cq_tail{nullptr}, _cq_mask{0};
+      struct io_uring_sqe *_sqes{nullptr};
+      struct io_uring_cqe *_cqes{nullptr};
+      void *_sq_ptr{nullptr}, *_cq_ptr{nullptr};
+      size_t _sq_size{0}, _cq_size{0};
+
+      void _setup(unsigned entries) noexcept
+      {
+        struct io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        _ring = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if(_ring < 0)
+        {
+          // Not supported by this kernel, or forbidden by a seccomp filter
+          _ring = -1;
+          return;
+        }
+        // Requests at the current file position need IORING_FEAT_RW_CUR_POS (Linux 5.6)
+        if(!(params.features & IORING_FEAT_RW_CUR_POS))
+        {
+          _teardown();
+          return;
+        }
+        _entries = params.sq_entries;
+        _sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if(single_mmap)
+        {
+          _sq_size = _cq_size = (_sq_size > _cq_size) ? _sq_size : _cq_size;
+        }
+        _sq_ptr = mmap(nullptr, _sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQ_RING);
+        _cq_ptr = single_mmap ? _sq_ptr : mmap(nullptr, _cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_CQ_RING);
+        void *sqes = mmap(nullptr, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQES);
+        if(MAP_FAILED == _sq_ptr || MAP_FAILED == _cq_ptr || MAP_FAILED == sqes)
+        {
+          if(MAP_FAILED != sqes)
+          {
+            munmap(sqes, params.sq_entries * sizeof(struct io_uring_sqe));
+          }
+          _sq_ptr = (MAP_FAILED == _sq_ptr) ? nullptr : _sq_ptr;
+          _cq_ptr = (MAP_FAILED == _cq_ptr) ? nullptr : _cq_ptr;
+          _teardown();
+          return;
+        }
+        auto *sq = static_cast<char *>(_sq_ptr);
+        auto *cq = static_cast<char *>(_cq_ptr);
+        _sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);                // NOLINT
+        _sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);          // NOLINT
+        _sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);              // NOLINT
+        _cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);                // NOLINT
+        _cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);                // NOLINT
+        _cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);          // NOLINT
+        _cqes = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);        // NOLINT
+        _sqes = static_cast<struct io_uring_sqe *>(sqes);
+      }
+      void _teardown() noexcept
+      {
+        if(_sqes != nullptr)
+        {
+          munmap(_sqes, _entries * sizeof(struct io_uring_sqe));
+        }
+        if(_cq_ptr != nullptr && _cq_ptr != _sq_ptr)
+        {
+          munmap(_cq_ptr, _cq_size);
+        }
+        if(_sq_ptr != nullptr)
+        {
+          munmap(_sq_ptr, _sq_size);
+        }
+        if(_ring != -1)
+        {
+          (void) ::close(_ring);
+        }
+        _ring = -1;
+        _entries = 0;
+        _sqes = nullptr;
+        _sq_ptr = _cq_ptr = nullptr;
+      }
+
+      // Calls f for every completion in the completion queue, returning how many there were
+      template <class F> unsigned _reap(F &f) noexcept
+      {
+        unsigned head = *_cq_head, reaped = 0;
+        const unsigned cq_tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+        for(; head != cq_tail; ++head, ++reaped)
+        {
+          const struct io_uring_cqe &cqe = _cqes[head & _cq_mask];
+          if(cqe.res < 0)
+          {
+            f(static_cast<size_t>(cqe.user_data), detail::posix_failure<size_t>(-cqe.res));
+          }
+          else
+          {
+            f(static_cast<size_t>(cqe.user_data), posix_result<size_t>(static_cast<size_t>(cqe.res)));
+          }
+        }
+        __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+        return reaped;
+      }
+
+      // Submits up to _entries requests with one syscall, and reaps their completions as they arrive
+      template <class F> posix_result<void> _submit_ring(const io_request *requests, size_t count, F &f) noexcept
+      {
+        for(size_t done = 0; done < count;)
+        {
+          const unsigned n = (count - done < _entries) ? static_cast<unsigned>(count - done) : _entries;
+          const unsigned tail = *_sq_tail;
+          for(unsigned i = 0; i < n; i++)
+          {
+            const io_request &req = requests[done + i];
+            const unsigned idx = (tail + i) & _sq_mask;
+            struct io_uring_sqe *sqe = _sqes + idx;
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = (req.operation == io_operation::read) ? IORING_OP_READV : IORING_OP_WRITEV;
+            sqe->fd = req.fd;
+            sqe->addr = reinterpret_cast<uintptr_t>(req.buffers);  // NOLINT
+            sqe->len = static_cast<unsigned>(req.buffers_count);
+            sqe->off = (req.offset < 0) ? static_cast<uint64_t>(-1) : static_cast<uint64_t>(req.offset);
+            sqe->user_data = done + i;
+            _sq_array[idx] = idx;
+          }
+          __atomic_store_n(_sq_tail, tail + n, __ATOMIC_RELEASE);
+          unsigned submitted = 0, completed = 0;
+          while(completed < n)
+          {
+            int ret = static_cast<int>(syscall(__NR_io_uring_enter, _ring, n - submitted, n - completed, IORING_ENTER_GETEVENTS, nullptr, 0));
+            if(ret < 0)
+            {
+              if(EINTR == errno)
+              {
+                continue;
+              }
+              if(EAGAIN == errno || EBUSY == errno)
+              {
+                // The kernel is short of resources, or wants completions reaped before it accepts more
+                // submissions, which is transient, so reap what there is, or wait for some, and retry
+                const unsigned reaped = _reap(f);
+                completed += reaped;
+                if(reaped == 0)
+                {
+                  if(completed < submitted)
+                  {
+                    (void) syscall(__NR_io_uring_enter, _ring, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                  }
+                  else
+                  {
+                    sched_yield();
+                  }
+                }
+                continue;
+              }
+              const int code = errno;
+              _abandon_ring(done + submitted, count, completed, submitted, code, f);
+              return detail::posix_failure<void>(code);
+            }
+            submitted += static_cast<unsigned>(ret);
+            completed += _reap(f);
+          }
+          done += n;
+        }
+        return success();
+      }
+
+      /* The ring is no longer trustworthy, so drop it and perform all future batches synchronously.
+      Requests already submitted may still be reading into or writing from the caller's buffers, so
+      all of their completions are reaped first. Requests never submitted are failed with the error.
+      */
+      template <class F> void _abandon_ring(size_t unsubmitted, size_t count, unsigned completed, unsigned submitted, int code, F &f) noexcept
+      {
+        while(completed < submitted)
+        {
+          completed += _reap(f);
+          if(completed < submitted)
+          {
+            int ret = static_cast<int>(syscall(__NR_io_uring_enter, _ring, 0, submitted - completed, IORING_ENTER_GETEVENTS, nullptr, 0));
+            if(ret < 0 && EINTR != errno && EAGAIN != errno && EBUSY != errno)
+            {
+              // Cannot wait on the ring, but the kernel still posts completions into it
+              sched_yield();
+            }
+          }
+        }
+        _teardown();
+        for(size_t n = unsubmitted; n < count; n++)
+        {
+          f(n, detail::posix_failure<size_t>(code));
+        }
+      }
+#endif
+
+    public:
+      /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+      explicit io_queue(unsigned entries = 64, bool use_io_uring = true) noexcept
+      {
+#if OUTCOME_POSIX_USE_IO_URING
+        if(use_io_uring)
+        {
+          _setup(entries);
+        }
+#else
+        (void) entries;
+        (void) use_io_uring;
+#endif
+      }
+      io_queue(const io_queue &) = delete;
+      io_queue &operator=(const io_queue &) = delete;
+      ~io_queue()
+      {
+#if OUTCOME_POSIX_USE_IO_URING
+        _teardown();
+#endif
+      }
+
+      /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+      bool uses_io_uring() const noexcept
+      {
+#if OUTCOME_POSIX_USE_IO_URING
+        return _ring != -1;
+#else
+        return false;
+#endif
+      }
+
+      /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+      template <class F> posix_result<void> submit(const io_request *requests, size_t count, F &&f) noexcept
+      {
+#if OUTCOME_POSIX_USE_IO_URING
+        if(_ring != -1)
+        {
+          return _submit_ring(requests, count, f);
+        }
+#endif
+        for(size_t n = 0; n < count; n++)
+        {
+          const io_request &req = requests[n];
+          if(req.operation == io_operation::read)
+          {
+            f(n, (req.offset < 0) ? posix::readv(req.fd, req.buffers, req.buffers_count) : posix::preadv(req.fd, req.buffers, req.buffers_count, req.offset));
+          }
+          else
+          {
+            f(n, (req.offset < 0) ? posix::writev(req.fd, req.buffers, req.buffers_count) : posix::pwritev(req.fd, req.buffers, req.buffers_count, req.offset));
+          }
+        }
+        return success();
+      }
+    };
+  }  // namespace posix
+}  // namespace experimental
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
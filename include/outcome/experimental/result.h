@@ -44,6 +44,8 @@ http://www.boost.org/LICENSE_1_0.txt)
 
 #define CXX_RESULT_ERROR_IS_ERRNO(r) (((r).flags & (1U << 4U)) == (1U << 4U))
 
+#define CXX_RESULT_ERROR_CLASS(r) (((r).flags >> 8U) & 0xffU)
+
 
 /***************************** <system_error2> support ******************************/
 
@@ -0,0 +1,255 @@
+/* Generates a status code domain from a constexpr table
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_EXPERIMENTAL_STATUS_CODE_TABLE_HPP
+#define OUTCOME_EXPERIMENTAL_STATUS_CODE_TABLE_HPP
+
+#include "status_result.hpp"
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+namespace experimental
+{
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class Enum> struct status_code_table_entry
+  {
+    Enum value{};
+    const char *message{nullptr};
+    errc generic{errc::unknown};
+    bool failure{true};
+  };
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class Enum, size_t N> struct status_code_table
+  {
+    status_code_table_entry<Enum> entries[N];
+
+    static constexpr size_t size() noexcept { return N; }
+    constexpr const status_code_table_entry<Enum> &operator[](size_t idx) const noexcept { return entries[idx]; }
+  };
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class Enum, size_t N> constexpr inline status_code_table<Enum, N> make_status_code_table(const status_code_table_entry<Enum> (&entries)[N]) noexcept
+  {
+    status_code_table<Enum, N> ret{};
+    for(size_t n = 0; n < N; n++)
+    {
+      ret.entries[n] = entries[n];
+    }
+    return ret;
+  }
+
+  namespace detail
+  {
+    template <class Enum> using status_code_table_int = std::conditional_t<std::is_signed<std::underlying_type_t<Enum>>::value, long long, unsigned long long>;
+
+    template <class Table> constexpr inline auto status_code_table_min(const Table &table) noexcept
+    {
+      using enum_type = std::decay_t<decltype(table[0].value)>;
+      auto ret = static_cast<status_code_table_int<enum_type>>(table[0].value);
+      for(size_t n = 1; n < table.size(); n++)
+      {
+        const auto v = static_cast<status_code_table_int<enum_type>>(table[n].value);
+        ret = (v < ret) ? v : ret;
+      }
+      return ret;
+    }
+    template <class Table> constexpr inline auto status_code_table_max(const Table &table) noexcept
+    {
+      using enum_type = std::decay_t<decltype(table[0].value)>;
+      auto ret = static_cast<status_code_table_int<enum_type>>(table[0].value);
+      for(size_t n = 1; n < table.size(); n++)
+      {
+        const auto v = static_cast<status_code_table_int<enum_type>>(table[n].value);
+        ret = (v > ret) ? v : ret;
+      }
+      return ret;
+    }
+  }  // namespace detail
+
+  template <class Traits> class table_status_code_domain;
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class Traits> using table_status_code = status_code<table_status_code_domain<Traits>>;
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class Traits> class table_status_code_domain final : public status_code_domain
+  {
+    template <class DomainType> friend class SYSTEM_ERROR2_NAMESPACE::status_code;
+    using _base = status_code_domain;
+
+  public:
+    //! The value type of the codes of this domain, which is the enum of the table
+    using value_type = typename Traits::value_type;
+    using _base::string_ref;
+
+  private:
+    using _int_type = detail::status_code_table_int<value_type>;
+    static constexpr _int_type _min = detail::status_code_table_min(Traits::table());
+    static constexpr size_t _size = static_cast<size_t>(detail::status_code_table_max(Traits::table()) - _min) + 1;
+    static_assert(_size <= 65536, "The values of the table are too sparse to be indexed densely, write a domain by hand instead");
+
+    // The table, densely indexed by value minus the smallest value. Holes have a null message.
+    const char *_messages[_size];
+    errc _generic[_size];
+    bool _failure[_size];
+
+    constexpr size_t _index(value_type v) const noexcept
+    {
+      const auto i = static_cast<_int_type>(v);
+      return (i < _min || static_cast<size_t>(i - _min) >= _size) ? _size : static_cast<size_t>(i - _min);
+    }
+    static constexpr const table_status_code<Traits> &_code(const status_code<void> &code) noexcept { return static_cast<const table_status_code<Traits> &>(code); }  // NOLINT
+
+  public:
+    //! Builds the dense table from `Traits::table()`, at compile time for the instance returned by `get()`
+    constexpr explicit table_status_code_domain(typename _base::unique_id_type id = Traits::id) noexcept
+        : _base(id)
+        , _messages{}
+        , _generic{}
+        , _failure{}
+    {
+      constexpr auto table = Traits::table();
+      for(size_t n = 0; n < _size; n++)
+      {
+        _generic[n] = errc::unknown;
+        _failure[n] = true;
+      }
+      for(size_t n = 0; n < table.size(); n++)
+      {
+        const size_t idx = _index(table[n].value);
+        _messages[idx] = table[n].message;
+        _generic[idx] = table[n].generic;
+        _failure[idx] = table[n].failure;
+      }
+    }
+    table_status_code_domain(const table_status_code_domain &) = default;
+    table_status_code_domain(table_status_code_domain &&) = default;
+    table_status_code_domain &operator=(const table_status_code_domain &) = default;
+    table_status_code_domain &operator=(table_status_code_domain &&) = default;
+    ~table_status_code_domain() = default;
+
+    //! Constexpr singleton getter
+    static inline constexpr const table_status_code_domain &get();
+
+    virtual string_ref name() const noexcept override final { return string_ref(Traits::name()); }  // NOLINT
+
+    /* The status_code observers other than message() call the virtual functions below through a
+    pointer to the erased domain, so cannot be inlined even though this domain is final. These
+    non-virtual equivalents can be, and are constexpr, for when the domain is known statically.
+    */
+    //! True if `v` is a failure, which values not in the table are
+    constexpr bool failure(value_type v) const noexcept
+    {
+      const size_t idx = _index(v);
+      return idx == _size || _failure[idx];
+    }
+    //! The message of `v`, which is "unknown" for values not in the table
+    constexpr const char *message(value_type v) const noexcept
+    {
+      const size_t idx = _index(v);
+      return (idx == _size || _messages[idx] == nullptr) ? "unknown" : _messages[idx];
+    }
+    //! The generic equivalent of `v`, which is `errc::unknown` for values not in the table
+    constexpr errc generic(value_type v) const noexcept
+    {
+      const size_t idx = _index(v);
+      return (idx == _size) ? errc::unknown : _generic[idx];
+    }
+    //! True if `v` is equivalent to `c`, which `errc::unknown` never is
+    constexpr bool equivalent(value_type v, errc c) const noexcept { return c != errc::unknown && generic(v) == c; }
+
+  protected:
+    virtual bool _do_failure(const status_code<void> &code) const noexcept override final { return failure(_code(code).value()); }  // NOLINT
+    virtual bool _do_equivalent(const status_code<void> &code1, const status_code<void> &code2) const noexcept override final      // NOLINT
+    {
+      if(code2.domain() == *this)
+      {
+        return _code(code1).value() == _code(code2).value();
+      }
+      if(code2.domain() == generic_code_domain)
+      {
+        const auto &c2 = static_cast<const generic_code &>(code2);  // NOLINT
+        return equivalent(_code(code1).value(), c2.value());
+      }
+      return false;
+    }
+    virtual generic_code _generic_code(const status_code<void> &code) const noexcept override final { return generic_code(generic(_code(code).value())); }  // NOLINT
+    virtual string_ref _do_message(const status_code<void> &code) const noexcept override final { return string_ref(message(_code(code).value())); }            // NOLINT
+#ifdef __cpp_exceptions
+    SYSTEM_ERROR2_NORETURN virtual void _do_throw_exception(const status_code<void> &code) const override final  // NOLINT
+    {
+      throw status_error<table_status_code_domain>(_code(code));
+    }
+#endif
+  };
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class Traits> constexpr table_status_code_domain<Traits> table_status_code_domain_v{};
+  template <class Traits> inline constexpr const table_status_code_domain<Traits> &table_status_code_domain<Traits>::get()
+  {
+    return table_status_code_domain_v<Traits>;
+  }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  namespace static_dispatch
+  {
+    //! True if `c` is a failure
+    constexpr inline bool failure(const generic_code &c) noexcept { return c.value() != errc::success; }
+    inline bool failure(const posix_code &c) noexcept { return c.value() != 0; }
+    template <class Traits> constexpr inline bool failure(const table_status_code<Traits> &c) noexcept { return table_status_code_domain<Traits>::get().failure(c.value()); }
+
+    //! The generic equivalent of `c`
+    constexpr inline errc generic(const generic_code &c) noexcept { return c.value(); }
+    inline errc generic(const posix_code &c) noexcept { return static_cast<errc>(c.value()); }
+    template <class Traits> constexpr inline errc generic(const table_status_code<Traits> &c) noexcept { return table_status_code_domain<Traits>::get().generic(c.value()); }
+
+    //! True if `c == e`
+    constexpr inline bool equivalent(const generic_code &c, errc e) noexcept { return c.value() == e; }
+    inline bool equivalent(const posix_code &c, errc e) noexcept { return c.value() == static_cast<int>(e); }
+    template <class Traits> constexpr inline bool equivalent(const table_status_code<Traits> &c, errc e) noexcept { return table_status_code_domain<Traits>::get().equivalent(c.value(), e); }
+
+    //! The message of `c`. For a `posix_code` this is the message of its generic equivalent, not `strerror()`.
+    inline const char *message(const generic_code &c) noexcept { return SYSTEM_ERROR2_NAMESPACE::detail::generic_code_message(c.value()); }
+    inline const char *message(const posix_code &c) noexcept { return SYSTEM_ERROR2_NAMESPACE::detail::generic_code_message(static_cast<errc>(c.value())); }
+    template <class Traits> constexpr inline const char *message(const table_status_code<Traits> &c) noexcept { return table_status_code_domain<Traits>::get().message(c.value()); }
+  }  // namespace static_dispatch
+}  // namespace experimental
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
@@ -22,7 +22,9 @@ Distributed under the Boost Software License, Version 1.0.
 http://www.boost.org/LICENSE_1_0.txt)
 */
 
-#ifndef OUTCOME_OUTCOME_HPP
+#if defined(OUTCOME_ENABLE_CXX_MODULES) && !defined(GENERATING_OUTCOME_MODULE_INTERFACE)
+#include "detail/import_module.hpp"
+#elif !defined(OUTCOME_OUTCOME_HPP)
 #define OUTCOME_OUTCOME_HPP
 
 #include "result.hpp"
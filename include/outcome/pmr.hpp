@@ -0,0 +1,80 @@
+/* Aliases of result and outcome for use with polymorphic allocators
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_PMR_HPP
+#define OUTCOME_PMR_HPP
+
+#include "std_outcome.hpp"
+#include "std_result.hpp"
+
+#ifdef __has_include
+#if __has_include(<memory_resource>) && __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+#endif
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+namespace pmr
+{
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class R, class S = std::error_code, class NoValuePolicy = policy::default_policy<R, S, void>>  //
+  using result = std_result<R, S, NoValuePolicy>;
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+type alias template <class R, class S = std::error_code> unchecked. Potential doc page: `pmr::unchecked<T, E = std::error_code>`
+*/
+  template <class R, class S = std::error_code> using unchecked = result<R, S, policy::all_narrow>;
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+type alias template <class R, class S = std::error_code> checked. Potential doc page: `pmr::checked<T, E = std::error_code>`
+*/
+  template <class R, class S = std::error_code> using checked = result<R, S, policy::throw_bad_result_access<S, void>>;
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class R, class S = std::error_code, class P = std::exception_ptr, class NoValuePolicy = policy::default_policy<R, S, P>>  //
+  using outcome = std_outcome<R, S, P, NoValuePolicy>;
+
+#if defined(__cpp_lib_memory_resource) && __cpp_lib_memory_resource >= 201603L
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class T, class... Args> inline T make_in(std::pmr::memory_resource *mr, Args &&... args)
+  {
+    static_assert(std::uses_allocator<T, std::pmr::polymorphic_allocator<char>>::value, "make_in() requires a result or outcome whose value or error uses a polymorphic allocator");
+    return T(std::allocator_arg, std::pmr::polymorphic_allocator<char>(mr), static_cast<Args &&>(args)...);
+  }
+#endif
+}  // namespace pmr
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
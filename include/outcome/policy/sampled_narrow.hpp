@@ -0,0 +1,126 @@
+/* Policies for result and outcome
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_POLICY_SAMPLED_NARROW_HPP
+#define OUTCOME_POLICY_SAMPLED_NARROW_HPP
+
+#include "base.hpp"
+
+#include <atomic>
+#include <cstdlib>
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+namespace policy
+{
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+type definition  sampled_check_violation_handler. Potential doc page: NOT FOUND
+*/
+  using sampled_check_violation_handler = void (*)(const char *what);
+}  // namespace policy
+
+namespace detail
+{
+  inline std::atomic<policy::sampled_check_violation_handler> &sampled_check_handler() noexcept
+  {
+    static std::atomic<policy::sampled_check_violation_handler> v{nullptr};
+    return v;
+  }
+
+  // Trivially destructible and zero initialised, so access needs no thread local guard
+  inline unsigned &sampled_check_countdown() noexcept
+  {
+    static OUTCOME_THREAD_LOCAL unsigned v;
+    return v;
+  }
+
+  // Returns true once every SampleRate calls on this thread, including the first
+  template <unsigned SampleRate> inline bool sample_this_check() noexcept
+  {
+    unsigned &countdown = sampled_check_countdown();
+    if(countdown == 0)
+    {
+      countdown = SampleRate - 1;
+      return true;
+    }
+    --countdown;
+    return false;
+  }
+
+  // Continuing after a violation would be undefined behaviour, so this never returns. The handler may throw.
+  QUICKCPPLIB_NORETURN QUICKCPPLIB_NOINLINE inline void sampled_check_violation(const char *what)
+  {
+    policy::sampled_check_violation_handler h = sampled_check_handler().load(std::memory_order_acquire);
+    if(h != nullptr)
+    {
+      h(what);
+    }
+    std::abort();
+  }
+}  // namespace detail
+
+namespace policy
+{
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  inline sampled_check_violation_handler set_sampled_check_violation_handler(sampled_check_violation_handler h) noexcept { return OUTCOME_V2_NAMESPACE::detail::sampled_check_handler().exchange(h, std::memory_order_acq_rel); }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+type definition  sampled_narrow. Potential doc page: `sampled_narrow`
+*/
+  template <unsigned SampleRate = 64> struct sampled_narrow : base
+  {
+    static_assert(SampleRate > 0, "SampleRate must be at least one");
+
+    template <class Impl> static constexpr void wide_value_check(Impl &&self)
+    {
+      if(!OUTCOME_IS_CONSTANT_EVALUATED() && OUTCOME_V2_NAMESPACE::detail::sample_this_check<SampleRate>() && !base::_has_value(static_cast<Impl &&>(self)))
+      {
+        OUTCOME_V2_NAMESPACE::detail::sampled_check_violation("no value");
+      }
+      base::narrow_value_check(static_cast<Impl &&>(self));
+    }
+    template <class Impl> static constexpr void wide_error_check(Impl &&self)
+    {
+      if(!OUTCOME_IS_CONSTANT_EVALUATED() && OUTCOME_V2_NAMESPACE::detail::sample_this_check<SampleRate>() && !base::_has_error(static_cast<Impl &&>(self)))
+      {
+        OUTCOME_V2_NAMESPACE::detail::sampled_check_violation("no error");
+      }
+      base::narrow_error_check(static_cast<Impl &&>(self));
+    }
+    template <class Impl> static constexpr void wide_exception_check(Impl &&self)
+    {
+      if(!OUTCOME_IS_CONSTANT_EVALUATED() && OUTCOME_V2_NAMESPACE::detail::sample_this_check<SampleRate>() && !base::_has_exception(static_cast<Impl &&>(self)))
+      {
+        OUTCOME_V2_NAMESPACE::detail::sampled_check_violation("no exception");
+      }
+      base::narrow_exception_check(static_cast<Impl &&>(self));
+    }
+  };
+}  // namespace policy
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
@@ -0,0 +1,515 @@
+/* A bounded lock free MPMC channel of results which an error closes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_RESULT_CHANNEL_HPP
+#define OUTCOME_RESULT_CHANNEL_HPP
+
+#include "std_result.hpp"
+
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#ifndef OUTCOME_RESULT_CHANNEL_USE_FUTEX
+#ifdef __linux__
+#define OUTCOME_RESULT_CHANNEL_USE_FUTEX 1
+#else
+#define OUTCOME_RESULT_CHANNEL_USE_FUTEX 0
+#endif
+#endif
+#if OUTCOME_RESULT_CHANNEL_USE_FUTEX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+enum class result_channel_wait
+{
+  spin,   // busy wait, for when every thread has a core of its own
+  yield,  // busy wait, yielding the processor after a while
+  block   // busy wait, sleeping in the kernel after a while
+};
+
+namespace detail
+{
+  inline void result_channel_pause() noexcept
+  {
+#if(defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#elif(defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+  }
+
+  // An event count. Waiters register, recheck their condition, then sleep until the epoch changes,
+  // and notifiers only enter the kernel if somebody is registered.
+  class result_channel_event
+  {
+    std::atomic<uint32_t> _epoch{0};
+    std::atomic<uint32_t> _waiters{0};
+#if !OUTCOME_RESULT_CHANNEL_USE_FUTEX
+    std::mutex _lock;
+    std::condition_variable _cond;
+#endif
+
+  public:
+    // Registers a waiter, after which the caller must recheck its condition before wait() or cancel_wait()
+    uint32_t prepare_wait() noexcept
+    {
+      _waiters.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      return _epoch.load(std::memory_order_seq_cst);
+    }
+    void wait(uint32_t epoch) noexcept
+    {
+#if OUTCOME_RESULT_CHANNEL_USE_FUTEX
+      static_assert(sizeof(_epoch) == sizeof(uint32_t), "futex requires a 32 bit word");
+      ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_epoch), FUTEX_WAIT_PRIVATE, epoch, nullptr, nullptr, 0);  // NOLINT
+#else
+      std::unique_lock<std::mutex> g(_lock);
+      _cond.wait(g, [&] { return _epoch.load(std::memory_order_seq_cst) != epoch; });
+#endif
+    }
+    void cancel_wait() noexcept { _waiters.fetch_sub(1, std::memory_order_relaxed); }
+    // Must be called after the condition of the waiters was made true
+    void notify_all() noexcept
+    {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if(_waiters.load(std::memory_order_relaxed) == 0)
+      {
+        return;
+      }
+#if OUTCOME_RESULT_CHANNEL_USE_FUTEX
+      _epoch.fetch_add(1, std::memory_order_seq_cst);
+      ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_epoch), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);  // NOLINT
+#else
+      {
+        std::lock_guard<std::mutex> g(_lock);
+        _epoch.fetch_add(1, std::memory_order_seq_cst);
+      }
+      _cond.notify_all();
+#endif
+    }
+  };
+}  // namespace detail
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+template <class T, class E = std::error_code, class NoValuePolicy = policy::default_policy<T, E, void>> class result_channel
+{
+  static_assert(!std::is_void<T>::value && !std::is_void<E>::value, "result_channel requires non-void value and error types");
+  static_assert(!std::is_same<T, E>::value, "result_channel requires different value and error types, as basic_result cannot be constructed otherwise");
+  static_assert(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_constructible<E>::value, "result_channel requires value and error types which are nothrow move constructible");
+
+public:
+  using value_type = T;
+  using error_type = E;
+  using result_type = basic_result<T, E, NoValuePolicy>;
+
+private:
+  // A Vyukov bounded queue. A slot holding position p is free for a producer when its sequence is
+  // p, and ready for a consumer when it is p + 1. Slots hold whole results, which are only moved
+  // or copied as bytes on their way through, so the construction hooks run once, when produced.
+  struct _slot
+  {
+    std::atomic<size_t> seq;
+    alignas(result_type) unsigned char storage[sizeof(result_type)];
+  };
+  // The top bit of the enqueue position marks the channel closed, and the rest is then the end
+  static constexpr size_t _closed_bit = ~(static_cast<size_t>(-1) >> 1);
+  enum _error_state_t : int
+  {
+    _error_pending,  // not closed, or closing
+    _error_none,     // closed without an error
+    _error_ready,    // closed with an error, which no consumer has taken yet
+    _error_taken     // closed with an error, which a consumer has taken
+  };
+  enum class _status
+  {
+    success,
+    unavailable,  // full, or empty
+    closed        // closed, or closed and drained
+  };
+
+  std::unique_ptr<_slot[]> _slots;
+  size_t _mask;
+  result_channel_wait _wait_strategy;
+  char _pad0[64];
+  std::atomic<size_t> _enqueue_pos{0};
+  char _pad1[64 - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> _dequeue_pos{0};
+  char _pad2[64 - sizeof(std::atomic<size_t>)];
+  std::atomic<int> _error_state{_error_pending};
+  alignas(result_type) unsigned char _error[sizeof(result_type)];
+  detail::result_channel_event _not_empty, _not_full;
+
+  static result_type *_result_at(unsigned char *storage) noexcept { return reinterpret_cast<result_type *>(storage); }  // NOLINT
+
+  // Results pushed whole are moved in. Values pushed alone become results here, the once.
+  static void _store(_slot &s, result_type &&r) noexcept { new(s.storage) result_type(static_cast<result_type &&>(r)); }
+  static void _store(_slot &s, T &&v) noexcept { new(s.storage) result_type(success_type<T>(static_cast<T &&>(v))); }
+  // Trivially copyable results are copied out as bytes, and need no destruction
+  static result_type _take(unsigned char *storage, std::true_type /*trivially copyable*/) noexcept
+  {
+    alignas(result_type) unsigned char out[sizeof(result_type)];
+    memcpy(out, storage, sizeof(result_type));
+    return *reinterpret_cast<const result_type *>(out);  // NOLINT
+  }
+  static result_type _take(unsigned char *storage, std::false_type /*trivially copyable*/) noexcept
+  {
+    result_type *p = _result_at(storage);
+    result_type ret(static_cast<result_type &&>(*p));
+    p->~result_type();
+    return ret;
+  }
+  static void _discard(unsigned char * /*unused*/, std::true_type /*trivially copyable*/) noexcept {}
+  static void _discard(unsigned char *storage, std::false_type /*trivially copyable*/) noexcept { _result_at(storage)->~result_type(); }
+  using _trivial = std::integral_constant<bool, std::is_trivially_copyable<result_type>::value>;
+
+  void _notify(detail::result_channel_event &e) noexcept
+  {
+    if(_wait_strategy == result_channel_wait::block)
+    {
+      e.notify_all();
+    }
+  }
+  // Returns true once the caller should sleep rather than spin
+  bool _backoff(unsigned &spins) const noexcept
+  {
+    if(++spins < 64 || _wait_strategy == result_channel_wait::spin)
+    {
+      detail::result_channel_pause();
+      return false;
+    }
+    if(_wait_strategy == result_channel_wait::yield || spins < 128)
+    {
+      std::this_thread::yield();
+      return false;
+    }
+    return true;
+  }
+  // Retries op until it does not return unavailable, spinning then sleeping on e
+  template <class Op> _status _retry(detail::result_channel_event &e, Op &&op) noexcept(noexcept(op()))
+  {
+    // Unregisters if op() throws while registered, else notifiers would keep entering the kernel
+    struct registration
+    {
+      detail::result_channel_event &e;
+      bool registered;
+      ~registration()
+      {
+        if(registered)
+        {
+          e.cancel_wait();
+        }
+      }
+    } reg{e, false};
+    unsigned spins = 0;
+    uint32_t epoch = 0;
+    for(;;)
+    {
+      const _status s = op();
+      if(reg.registered)
+      {
+        if(s == _status::unavailable)
+        {
+          e.wait(epoch);
+        }
+        reg.registered = false;
+        e.cancel_wait();
+      }
+      if(s != _status::unavailable)
+      {
+        return s;
+      }
+      if(_backoff(spins))
+      {
+        epoch = e.prepare_wait();
+        reg.registered = true;
+      }
+    }
+  }
+
+  // Claims up to count consecutive positions from pos, returning how many were claimed
+  size_t _claim(std::atomic<size_t> &position, size_t &pos, size_t count, size_t ready_offset, bool producer) noexcept
+  {
+    pos = position.load(std::memory_order_relaxed);
+    for(;;)
+    {
+      if(producer && (pos & _closed_bit) != 0)
+      {
+        return 0;
+      }
+      size_t n = 0;
+      for(; n < count; n++)
+      {
+        const size_t seq = _slots[(pos + n) & _mask].seq.load(std::memory_order_acquire);
+        const auto dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + n + ready_offset);
+        if(dif != 0)
+        {
+          if(n == 0 && dif > 0)
+          {
+            n = static_cast<size_t>(-1);  // another thread claimed pos, so reload it
+          }
+          break;
+        }
+      }
+      if(n == static_cast<size_t>(-1))
+      {
+        pos = position.load(std::memory_order_relaxed);
+        continue;
+      }
+      if(n == 0)
+      {
+        return 0;
+      }
+      if(position.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+      {
+        return n;
+      }
+    }
+  }
+
+  template <class It> _status _try_push(It &first, size_t count, size_t &pushed) noexcept
+  {
+    size_t pos;
+    pushed = _claim(_enqueue_pos, pos, count, 0, true);
+    if(pushed == 0)
+    {
+      return (_enqueue_pos.load(std::memory_order_relaxed) & _closed_bit) != 0 ? _status::closed : _status::unavailable;
+    }
+    for(size_t n = 0; n < pushed; n++, ++first)
+    {
+      _slot &s = _slots[(pos + n) & _mask];
+      _store(s, static_cast<std::remove_reference_t<decltype(*first)> &&>(*first));
+      s.seq.store(pos + n + 1, std::memory_order_release);
+    }
+    _notify(_not_empty);
+    return _status::success;
+  }
+
+  template <class F> _status _try_pop(size_t max, F &f, size_t &popped)
+  {
+    size_t pos;
+    popped = _claim(_dequeue_pos, pos, max, 1, false);
+    if(popped == 0)
+    {
+      const size_t end = _enqueue_pos.load(std::memory_order_acquire);
+      if((end & _closed_bit) == 0 || (end & ~_closed_bit) != _dequeue_pos.load(std::memory_order_relaxed))
+      {
+        return _status::unavailable;
+      }
+      // Closed and drained, so exactly one consumer takes the error, if there is one
+      int state;
+      while((state = _error_state.load(std::memory_order_acquire)) == _error_pending)
+      {
+        detail::result_channel_pause();
+      }
+      if(state == _error_ready && _error_state.compare_exchange_strong(state, _error_taken, std::memory_order_acquire))
+      {
+        popped = 1;
+        f(_take(_error, _trivial()));
+        return _status::success;
+      }
+      return _status::closed;
+    }
+    // Each value is moved out and its slot released before f sees it. If f throws, the rest of the
+    // batch is destroyed and released, else producers would wait forever for those slots.
+    struct release_rest
+    {
+      result_channel *self;
+      size_t pos, n, popped;
+      ~release_rest()
+      {
+        for(; n < popped; n++)
+        {
+          _slot &s = self->_slots[(pos + n) & self->_mask];
+          self->_discard(s.storage, _trivial());
+          s.seq.store(pos + n + self->_mask + 1, std::memory_order_release);
+        }
+        self->_notify(self->_not_full);
+      }
+    } batch{this, pos, 0, popped};
+    while(batch.n < popped)
+    {
+      _slot &s = _slots[(pos + batch.n) & _mask];
+      result_type r(_take(s.storage, _trivial()));
+      s.seq.store(pos + batch.n + _mask + 1, std::memory_order_release);
+      ++batch.n;
+      f(static_cast<result_type &&>(r));
+    }
+    return _status::success;
+  }
+
+  // Takes a failed result to deliver once the values are drained, or none
+  bool _close(result_type *r) noexcept
+  {
+    if((_enqueue_pos.fetch_or(_closed_bit, std::memory_order_acq_rel) & _closed_bit) != 0)
+    {
+      return false;
+    }
+    if(r != nullptr)
+    {
+      new(_error) result_type(static_cast<result_type &&>(*r));
+    }
+    _error_state.store((r != nullptr) ? _error_ready : _error_none, std::memory_order_release);
+    _notify(_not_empty);
+    _notify(_not_full);
+    return true;
+  }
+
+public:
+  //! Constructs a channel holding at least `capacity` values, rounded up to a power of two
+  explicit result_channel(size_t capacity, result_channel_wait wait_strategy = result_channel_wait::block)
+      : _mask(0)
+      , _wait_strategy(wait_strategy)
+  {
+    size_t size = 2;
+    while(size < capacity)
+    {
+      size <<= 1;
+    }
+    _slots.reset(new _slot[size]);
+    _mask = size - 1;
+    for(size_t n = 0; n < size; n++)
+    {
+      _slots[n].seq.store(n, std::memory_order_relaxed);
+    }
+  }
+  result_channel(const result_channel &) = delete;
+  result_channel(result_channel &&) = delete;
+  result_channel &operator=(const result_channel &) = delete;
+  result_channel &operator=(result_channel &&) = delete;
+  //! Destroys any values and error not yet consumed. No thread may be using the channel.
+  ~result_channel()
+  {
+    const size_t end = _enqueue_pos.load(std::memory_order_relaxed) & ~_closed_bit;
+    for(size_t pos = _dequeue_pos.load(std::memory_order_relaxed); pos != end && !_trivial::value; pos++)
+    {
+      _discard(_slots[pos & _mask].storage, _trivial());
+    }
+    if(_error_state.load(std::memory_order_relaxed) == _error_ready)
+    {
+      _discard(_error, _trivial());
+    }
+  }
+
+  //! The number of values the channel can hold
+  size_t capacity() const noexcept { return _mask + 1; }
+  //! True if the channel has been closed, though values and an error may remain to be consumed
+  bool closed() const noexcept { return (_enqueue_pos.load(std::memory_order_acquire) & _closed_bit) != 0; }
+
+  //! Closes the channel without an error. Returns false if it was already closed.
+  bool close() noexcept { return _close(nullptr); }
+  //! Closes the channel with an error, which one consumer will receive after all the values. Returns false if it was already closed.
+  bool close(E e) noexcept
+  {
+    result_type r(failure_type<E>(static_cast<E &&>(e)));
+    return _close(&r);
+  }
+
+  //! Enqueues the value of `r`, or closes the channel with its error. Returns false if the channel is full or closed.
+  bool try_push(result_type &&r) noexcept
+  {
+    if(r.has_error())
+    {
+      return _close(&r);
+    }
+    size_t pushed;
+    result_type *p = &r;
+    return _try_push(p, 1, pushed) == _status::success;
+  }
+  //! Enqueues the value of `r` when there is room, or closes the channel with its error. Returns false if the channel is closed.
+  bool push(result_type &&r) noexcept
+  {
+    if(r.has_error())
+    {
+      return _close(&r);
+    }
+    result_type *p = &r;
+    return push_batch(p, 1) == 1;
+  }
+  //! Moves up to `count` values from `first` into the channel, returning how many were moved
+  template <class It> size_t try_push_batch(It first, size_t count) noexcept
+  {
+    size_t pushed = 0;
+    _try_push(first, count, pushed);
+    return pushed;
+  }
+  //! Moves `count` values from `first` into the channel as room becomes available. Returns fewer if the channel is closed.
+  template <class It> size_t push_batch(It first, size_t count) noexcept
+  {
+    size_t done = 0;
+    while(done < count)
+    {
+      size_t pushed = 0;
+      if(_retry(_not_full, [&] { return _try_push(first, count - done, pushed); }) == _status::closed)
+      {
+        break;
+      }
+      done += pushed;
+    }
+    return done;
+  }
+
+  //! Calls `f` with a result holding the next value, or the closing error once the values are drained. Returns false if nothing was available.
+  template <class F> bool try_pop(F &&f)
+  {
+    size_t popped;
+    return _try_pop(1, f, popped) == _status::success;
+  }
+  //! Calls `f` with a result holding the next value, or the closing error once the values are drained, waiting as necessary. Returns false once the channel is closed and drained and its error consumed.
+  template <class F> bool pop(F &&f) { return pop_batch(1, static_cast<F &&>(f)) == 1; }
+  //! Calls `f` with results holding up to `max` values, or the closing error once the values are drained. Returns the number of calls.
+  //! If `f` throws, the values of the batch not yet passed to it are destroyed.
+  template <class F> size_t try_pop_batch(size_t max, F &&f)
+  {
+    size_t popped = 0;
+    _try_pop(max, f, popped);
+    return popped;
+  }
+  //! As `try_pop_batch()`, but waits for at least one value. Returns zero once the channel is closed and drained and its error consumed.
+  template <class F> size_t pop_batch(size_t max, F &&f)
+  {
+    size_t popped = 0;
+    _retry(_not_empty, [&] { return _try_pop(max, f, popped); });
+    return popped;
+  }
+};
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
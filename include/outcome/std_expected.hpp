@@ -0,0 +1,124 @@
+/* Conversions between basic_result and C++ 23 std::expected
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#if defined(OUTCOME_ENABLE_CXX_MODULES) && !defined(GENERATING_OUTCOME_MODULE_INTERFACE)
+#include "detail/import_module.hpp"
+#elif !defined(OUTCOME_STD_EXPECTED_HPP)
+#define OUTCOME_STD_EXPECTED_HPP
+
+#include "basic_result.hpp"
+#include "try.hpp"
+
+#ifdef __has_include
+#if __has_include(<expected>)
+#include <expected>
+#endif
+#endif
+
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+namespace detail
+{
+  template <class T> struct is_std_expected : std::false_type
+  {
+  };
+  template <class T, class E> struct is_std_expected<std::expected<T, E>> : std::true_type
+  {
+  };
+  template <class R, class T, class E, class X> constexpr R make_from_std_expected(X &&v, std::false_type /*value is void*/)
+  {
+    return v.has_value() ? R{in_place_type<typename R::value_type>, *static_cast<X &&>(v)} : R{in_place_type<typename R::error_type>, static_cast<X &&>(v).error()};
+  }
+  template <class R, class T, class E, class X> constexpr R make_from_std_expected(X &&v, std::true_type /*value is void*/)
+  {
+    return v.has_value() ? R{in_place_type<typename R::value_type>} : R{in_place_type<typename R::error_type>, static_cast<X &&>(v).error()};
+  }
+  template <class T, class E, class NoValuePolicy> constexpr std::expected<T, E> make_std_expected(basic_result<T, E, NoValuePolicy> &&v, std::false_type /*value is void*/)
+  {
+    return v.has_value() ? std::expected<T, E>{std::in_place, static_cast<basic_result<T, E, NoValuePolicy> &&>(v).assume_value()} : std::expected<T, E>{std::unexpect, static_cast<basic_result<T, E, NoValuePolicy> &&>(v).assume_error()};
+  }
+  template <class T, class E, class NoValuePolicy> constexpr std::expected<T, E> make_std_expected(basic_result<T, E, NoValuePolicy> &&v, std::true_type /*value is void*/)
+  {
+    return v.has_value() ? std::expected<T, E>{std::in_place} : std::expected<T, E>{std::unexpect, static_cast<basic_result<T, E, NoValuePolicy> &&>(v).assume_error()};
+  }
+
+  // OUTCOME_TRY extracts the value of a std::expected without the throwing check in .value()
+  OUTCOME_TEMPLATE(class T)
+  OUTCOME_TREQUIRES(OUTCOME_TPRED(is_std_expected<std::decay_t<T>>::value))
+  constexpr decltype(auto) try_extract_value(T &&v) { return *static_cast<T &&>(v); }
+}  // namespace detail
+
+namespace convert
+{
+  /*! AWAITING HUGO JSON CONVERSION TOOL 
+type definition  value_or_error. Potential doc page: NOT FOUND
+*/
+  template <class R, class S, class NoValuePolicy, class T, class E> struct value_or_error<basic_result<R, S, NoValuePolicy>, std::expected<T, E>>
+  {
+    static constexpr bool enable_result_inputs = false;
+    static constexpr bool enable_outcome_inputs = false;
+    // Only rvalues are accepted, so the payload is always moved and never silently copied
+    OUTCOME_TEMPLATE(class X)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(std::is_same<std::expected<T, E>, X>::value                                                     //
+                                    && (std::is_void<T>::value || OUTCOME_V2_NAMESPACE::detail::is_explicitly_constructible<R, T>)  //
+                                    &&OUTCOME_V2_NAMESPACE::detail::is_explicitly_constructible<S, E>))
+    constexpr basic_result<R, S, NoValuePolicy> operator()(X &&v) { return OUTCOME_V2_NAMESPACE::detail::make_from_std_expected<basic_result<R, S, NoValuePolicy>, T, E>(static_cast<X &&>(v), std::is_void<T>()); }
+  };
+}  // namespace convert
+
+/*! AWAITING HUGO JSON CONVERSION TOOL 
+SIGNATURE NOT RECOGNISED
+*/
+OUTCOME_TEMPLATE(class T, class E, class NoValuePolicy)
+OUTCOME_TREQUIRES(OUTCOME_TPRED(!std::is_void<E>::value))
+constexpr std::expected<T, E> to_expected(basic_result<T, E, NoValuePolicy> &&v) noexcept((std::is_void<T>::value || std::is_nothrow_move_constructible<T>::value) && std::is_nothrow_move_constructible<E>::value)
+{
+  return detail::make_std_expected(static_cast<basic_result<T, E, NoValuePolicy> &&>(v), std::is_void<T>());
+}
+/*! AWAITING HUGO JSON CONVERSION TOOL 
+SIGNATURE NOT RECOGNISED
+*/
+template <class T, class E, class NoValuePolicy> std::expected<T, E> to_expected(const basic_result<T, E, NoValuePolicy> &v) = delete;
+
+/*! AWAITING HUGO JSON CONVERSION TOOL 
+SIGNATURE NOT RECOGNISED
+*/
+template <class T, class E> inline auto try_operation_return_as(const std::expected<T, E> &v)
+{
+  return std::unexpected<E>(v.error());
+}
+/*! AWAITING HUGO JSON CONVERSION TOOL 
+SIGNATURE NOT RECOGNISED
+*/
+template <class T, class E> inline auto try_operation_return_as(std::expected<T, E> &&v)
+{
+  return std::unexpected<E>(static_cast<std::expected<T, E> &&>(v).error());
+}
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
+#endif
@@ -0,0 +1,386 @@
+/* Opt-in construction telemetry for result and outcome
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_TELEMETRY_HPP
+#define OUTCOME_TELEMETRY_HPP
+
+#include "trait.hpp"
+
+#include <atomic>
+#include <cstdlib>  // for malloc
+#include <vector>
+
+/* Number of distinct (category, value) pairs each thread can count failures for.
+Failures beyond this are still counted, but only as unclassified.
+*/
+#ifndef OUTCOME_TELEMETRY_FAILURE_SLOTS
+#define OUTCOME_TELEMETRY_FAILURE_SLOTS 64
+#endif
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+namespace telemetry
+{
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+type definition  error_key. Potential doc page: NOT FOUND
+*/
+  struct error_key
+  {
+    //! The identity of the error's category or domain, or of its type if it has neither.
+    const void *category{nullptr};
+    //! The error's value, or zero if it has none which can be represented.
+    intptr_t value{0};
+    //! Optional function returning a printable name for `category`.
+    const char *(*name)(const void *category){nullptr};
+  };
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+type definition  failure_count. Potential doc page: NOT FOUND
+*/
+  struct failure_count
+  {
+    error_key key;
+    uint64_t count{0};
+
+    const char *category_name() const { return (key.name != nullptr) ? key.name(key.category) : ""; }
+  };
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+type definition  counts. Potential doc page: NOT FOUND
+*/
+  struct counts
+  {
+    uint64_t successes{0};
+    uint64_t failures{0};
+    uint64_t conversions{0};
+    //! Failures which could not be attributed to a (category, value) pair as the per-thread table was full.
+    uint64_t unclassified_failures{0};
+    std::vector<failure_count> by_error;
+
+    uint64_t constructions() const noexcept { return successes + failures; }
+  };
+
+  namespace detail
+  {
+    using counter = std::atomic<uint64_t>;
+
+    // Only the owning thread ever writes to its shard, so a relaxed load and store
+    // suffices. This compiles to a plain increment, not a locked read-modify-write.
+    inline void bump(counter &c) noexcept { c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+    struct failure_slot
+    {
+      std::atomic<const void *> category{nullptr};  // published last with release semantics
+      std::atomic<intptr_t> value{0};
+      std::atomic<const char *(*) (const void *)> name{nullptr};
+      counter count{0};
+    };
+
+    // One per thread, padded so no two threads ever write the same cache line
+    struct alignas(64) shard
+    {
+      counter successes{0};
+      counter failures{0};
+      counter conversions{0};
+      counter unclassified{0};
+      std::atomic<bool> in_use{true};
+      shard *next{nullptr};  // never changes after the shard is published
+      alignas(64) failure_slot slots[OUTCOME_TELEMETRY_FAILURE_SLOTS];
+    };
+
+    // Shards are never freed, only recycled when their thread exits, so this list only ever grows
+    inline std::atomic<shard *> &shard_list() noexcept
+    {
+      static std::atomic<shard *> v{nullptr};
+      return v;
+    }
+
+    // Trivially destructible so access needs no thread local guard
+    struct tls_state
+    {
+      shard *current;
+      bool exiting;
+    };
+    inline tls_state &this_thread_state() noexcept
+    {
+      static OUTCOME_THREAD_LOCAL tls_state v;
+      return v;
+    }
+
+    struct shard_releaser
+    {
+      shard *s{nullptr};
+      shard_releaser() = default;
+      shard_releaser(const shard_releaser &) = delete;
+      shard_releaser(shard_releaser &&) = delete;
+      shard_releaser &operator=(const shard_releaser &) = delete;
+      shard_releaser &operator=(shard_releaser &&) = delete;
+      ~shard_releaser()
+      {
+        tls_state &tls = this_thread_state();
+        tls.current = nullptr;
+        tls.exiting = true;
+        if(s != nullptr)
+        {
+          s->in_use.store(false, std::memory_order_release);
+        }
+      }
+    };
+
+    QUICKCPPLIB_NOINLINE inline shard *acquire_shard() noexcept
+    {
+      tls_state &tls = this_thread_state();
+      if(tls.exiting)
+      {
+        return nullptr;
+      }
+      shard *s = nullptr;
+      // Prefer recycling the shard of a thread which has exited, its counts remain valid
+      for(shard *i = shard_list().load(std::memory_order_acquire); i != nullptr; i = i->next)
+      {
+        bool expected = false;
+        if(!i->in_use.load(std::memory_order_relaxed) && i->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+          s = i;
+          break;
+        }
+      }
+      if(s == nullptr)
+      {
+        // Over aligned new is not available before C++ 17, so align by hand. If allocation fails, we simply don't count.
+        void *mem = std::malloc(sizeof(shard) + alignof(shard));  // NOLINT
+        if(mem == nullptr)
+        {
+          return nullptr;
+        }
+        auto addr = (reinterpret_cast<uintptr_t>(mem) + alignof(shard) - 1) & ~static_cast<uintptr_t>(alignof(shard) - 1);  // NOLINT
+        s = new(reinterpret_cast<void *>(addr)) shard;                                                                      // NOLINT
+        shard *head = shard_list().load(std::memory_order_relaxed);
+        do
+        {
+          s->next = head;
+        } while(!shard_list().compare_exchange_weak(head, s, std::memory_order_release, std::memory_order_relaxed));
+      }
+      static OUTCOME_THREAD_LOCAL shard_releaser releaser;
+      releaser.s = s;
+      tls.current = s;
+      return s;
+    }
+
+    inline shard *this_thread_shard() noexcept
+    {
+      shard *s = this_thread_state().current;
+      return (s != nullptr) ? s : acquire_shard();
+    }
+
+    inline void record_failure(const error_key &k) noexcept
+    {
+      shard *s = this_thread_shard();
+      if(s == nullptr)
+      {
+        return;
+      }
+      bump(s->failures);
+      const auto h = static_cast<size_t>((reinterpret_cast<uintptr_t>(k.category) >> 4U) ^ (static_cast<uintptr_t>(k.value) * 0x9E3779B9U));
+      for(size_t n = 0; n < OUTCOME_TELEMETRY_FAILURE_SLOTS; n++)
+      {
+        failure_slot &slot = s->slots[(h + n) % OUTCOME_TELEMETRY_FAILURE_SLOTS];
+        const void *category = slot.category.load(std::memory_order_relaxed);
+        if(category == nullptr)
+        {
+          slot.value.store(k.value, std::memory_order_relaxed);
+          slot.name.store(k.name, std::memory_order_relaxed);
+          bump(slot.count);
+          slot.category.store(k.category, std::memory_order_release);  // publish to snapshot()
+          return;
+        }
+        if(category == k.category && slot.value.load(std::memory_order_relaxed) == k.value)
+        {
+          bump(slot.count);
+          return;
+        }
+      }
+      bump(s->unclassified);
+    }
+
+    // Unique address per type, used as the category of errors which have none
+    template <class T> struct type_identity
+    {
+      static constexpr char id = 0;
+    };
+    template <class T> constexpr char type_identity<T>::id;
+
+    template <class Category> inline const char *category_name(const void *c) { return static_cast<const Category *>(c)->name(); }
+
+    template <class E> using result_of_outcome_telemetry_error_key = decltype(outcome_telemetry_error_key(std::declval<const E &>()));
+    template <class E> using result_of_category = decltype(std::declval<const E &>().category());
+    template <class E> using result_of_domain = decltype(std::declval<const E &>().domain());
+    template <class E> using result_of_value = decltype(std::declval<const E &>().value());
+
+    template <size_t N> struct priority : priority<N - 1>
+    {
+    };
+    template <> struct priority<0>
+    {
+    };
+
+    // ADL discovered customisation point takes precedence
+    OUTCOME_TEMPLATE(class E)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(trait::detail::is_detected<result_of_outcome_telemetry_error_key, E>::value))
+    inline error_key make_error_key(const E &e, priority<4> /*unused*/) { return outcome_telemetry_error_key(e); }
+    // std::error_code, std::error_condition, boost::system::error_code etc.
+    OUTCOME_TEMPLATE(class E)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(trait::detail::is_detected<result_of_category, E>::value &&trait::detail::is_detected<result_of_value, E>::value))
+    inline error_key make_error_key(const E &e, priority<3> /*unused*/)
+    {
+      using category_type = std::decay_t<result_of_category<E>>;
+      return error_key{&e.category(), static_cast<intptr_t>(e.value()), &category_name<category_type>};
+    }
+    // status_code<DomainType> with an integral value type
+    OUTCOME_TEMPLATE(class E)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(trait::detail::is_detected<result_of_domain, E>::value &&trait::detail::is_detected<result_of_value, E>::value), OUTCOME_TEXPR(static_cast<intptr_t>(std::declval<const E &>().value())))
+    inline error_key make_error_key(const E &e, priority<2> /*unused*/) { return error_key{&e.domain(), static_cast<intptr_t>(e.value()), nullptr}; }
+    // C enums, integers and the like
+    OUTCOME_TEMPLATE(class E)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(std::is_integral<E>::value || std::is_enum<E>::value))
+    inline error_key make_error_key(const E &e, priority<1> /*unused*/) { return error_key{&type_identity<E>::id, static_cast<intptr_t>(e), nullptr}; }
+    // Anything else can only be told apart by type
+    template <class E> inline error_key make_error_key(const E & /*unused*/, priority<0> /*unused*/) { return error_key{&type_identity<E>::id, 0, nullptr}; }
+
+    template <class T> using has_failure_observer = decltype(std::declval<const T &>().has_failure());
+    template <class T> using exception_type_of = typename T::exception_type;
+
+    template <class T> inline error_key failure_key(const T *r, std::false_type /*error type is not void*/) { return make_error_key(r->assume_error(), priority<4>()); }
+    template <class T> inline error_key failure_key(const T * /*unused*/, std::true_type /*error type is void*/) { return error_key{&type_identity<void>::id, 0, nullptr}; }
+    template <class T> inline error_key failure_key(const T *r)
+    {
+      if(r->has_error())
+      {
+        return failure_key(r, std::is_void<typename T::error_type>());
+      }
+      // Only outcome can get here, if it has an exception but no error
+      using exception_type = typename trait::detail::is_detected<exception_type_of, T>::type;
+      return error_key{&type_identity<exception_type>::id, 0, nullptr};
+    }
+
+    template <class T> QUICKCPPLIB_NOINLINE inline void record_failed_construction(const T *r) noexcept { record_failure(failure_key(r)); }
+
+    template <class T> inline void on_construction(const T *r) noexcept
+    {
+      // When inlined into a constructor, has_value() is a compile time constant, so the success path is a single increment
+      if(r->has_value())
+      {
+        shard *s = this_thread_shard();
+        if(s != nullptr)
+        {
+          bump(s->successes);
+        }
+        return;
+      }
+      record_failed_construction(r);
+    }
+
+    inline void on_conversion() noexcept
+    {
+      shard *s = this_thread_shard();
+      if(s != nullptr)
+      {
+        bump(s->conversions);
+      }
+    }
+
+    // Copy and move construction hooks fire both for success_type/failure_type sugar, and for conversion from another result or outcome
+    template <class T, class U> inline void on_copy_or_move_construction(const T *r, const U & /*unused*/) noexcept
+    {
+      if(trait::detail::is_detected<has_failure_observer, U>::value)
+      {
+        on_conversion();
+      }
+      else
+      {
+        on_construction(r);
+      }
+    }
+  }  // namespace detail
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  template <class T> inline void record_construction(const T *r) noexcept { detail::on_construction(r); }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  inline void record_conversion() noexcept { detail::on_conversion(); }
+
+  /*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+  inline counts snapshot()
+  {
+    counts ret;
+    for(detail::shard *s = detail::shard_list().load(std::memory_order_acquire); s != nullptr; s = s->next)
+    {
+      ret.successes += s->successes.load(std::memory_order_relaxed);
+      ret.failures += s->failures.load(std::memory_order_relaxed);
+      ret.conversions += s->conversions.load(std::memory_order_relaxed);
+      ret.unclassified_failures += s->unclassified.load(std::memory_order_relaxed);
+      for(auto &slot : s->slots)
+      {
+        const void *category = slot.category.load(std::memory_order_acquire);
+        if(category == nullptr)
+        {
+          continue;
+        }
+        failure_count fc;
+        fc.key.category = category;
+        fc.key.value = slot.value.load(std::memory_order_relaxed);
+        fc.key.name = slot.name.load(std::memory_order_relaxed);
+        fc.count = slot.count.load(std::memory_order_relaxed);
+        bool merged = false;
+        for(auto &i : ret.by_error)
+        {
+          if(i.key.category == fc.key.category && i.key.value == fc.key.value)
+          {
+            i.count += fc.count;
+            merged = true;
+            break;
+          }
+        }
+        if(!merged)
+        {
+          ret.by_error.push_back(fc);
+        }
+      }
+    }
+    return ret;
+  }
+}  // namespace telemetry
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
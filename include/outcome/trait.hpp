@@ -35,7 +35,7 @@ namespace trait
 SIGNATURE NOT RECOGNISED
 */
   template <class R>                                                             //
-  static constexpr bool type_can_be_used_in_basic_result =                       //
+  OUTCOME_INLINE_CONSTEXPR bool type_can_be_used_in_basic_result =               //
   (!std::is_reference<R>::value                                                  //
    && !OUTCOME_V2_NAMESPACE::detail::is_in_place_type_t<std::decay_t<R>>::value  //
    && !is_success_type<R>                                                        //
@@ -61,6 +61,13 @@ type definition  is_error_type_enum. Potential doc page: NOT FOUND
     static constexpr bool value = false;
   };
 
+  /*! AWAITING HUGO JSON CONVERSION TOOL 
+type definition  error_classifier. Potential doc page: NOT FOUND
+*/
+  template <class E> struct error_classifier
+  {
+  };
+
   namespace detail
   {
     template <class T> using devoid = OUTCOME_V2_NAMESPACE::detail::devoid<T>;
@@ -86,6 +93,9 @@ type definition  is_error_type_enum. Potential doc page: NOT FOUND
     template <class Arg> using result_of_make_error_code = decltype(make_error_code(declval<Arg>()));
     template <class Arg> using introspect_make_error_code = is_detected<result_of_make_error_code, Arg>;
 
+    template <class Arg> using result_of_error_classifier = decltype(error_classifier<Arg>::classify(std::declval<const Arg &>()));
+    template <class Arg> using introspect_error_classifier = is_detected<result_of_error_classifier, Arg>;
+
     template <class Arg> using result_of_make_exception_ptr = decltype(make_exception_ptr(declval<Arg>()));
     template <class Arg> using introspect_make_exception_ptr = is_detected<result_of_make_exception_ptr, Arg>;
 
@@ -0,0 +1,167 @@
+/* USDT static probes for result and outcome failure construction
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+File Created: Mar 2019
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+(See accompanying file Licence.txt or copy at
+http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef OUTCOME_USDT_HPP
+#define OUTCOME_USDT_HPP
+
+/* If <sys/sdt.h> from SystemTap is available, probes are emitted as a single
+nop plus an ELF .note.stapsdt entry which bpftrace, perf and SystemTap can attach to.
+Otherwise probes, and everything which computes their arguments, compile to nothing.
+
+If _SDT_HAS_SEMAPHORES is defined before inclusion, each probe also gets a semaphore
+which tracers increment while attached, and the failure key is only computed when one is.
+*/
+#ifndef OUTCOME_USDT_PROBE2
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define OUTCOME_USDT_PROBE2(name, a1, a2) STAP_PROBE2(outcome, name, a1, a2)
+#ifdef _SDT_HAS_SEMAPHORES
+// Weak, so every translation unit can define them, and in .probes, where tracers look for them
+extern "C"
+{
+  __attribute__((weak, section(".probes"))) volatile unsigned short outcome_result_failure_semaphore;   // NOLINT
+  __attribute__((weak, section(".probes"))) volatile unsigned short outcome_outcome_failure_semaphore;  // NOLINT
+  __attribute__((weak, section(".probes"))) volatile unsigned short outcome_try_propagate_semaphore;    // NOLINT
+}
+#define OUTCOME_USDT_ENABLED(name) __builtin_expect(outcome_##name##_semaphore != 0, 0)
+#endif
+#endif
+#endif
+#endif
+#ifdef OUTCOME_USDT_PROBE2
+#define OUTCOME_USDT_AVAILABLE 1
+#ifndef OUTCOME_USDT_ENABLED
+#define OUTCOME_USDT_ENABLED(name) true
+#endif
+#else
+#define OUTCOME_USDT_AVAILABLE 0
+#endif
+
+#if OUTCOME_USDT_AVAILABLE
+#include "telemetry.hpp"  // for the error key extraction
+#endif
+
+OUTCOME_V2_NAMESPACE_EXPORT_BEGIN
+
+/*! AWAITING HUGO JSON CONVERSION TOOL
+SIGNATURE NOT RECOGNISED
+*/
+namespace usdt
+{
+  namespace detail
+  {
+#if OUTCOME_USDT_AVAILABLE
+    using telemetry::detail::priority;
+
+    // Probe arguments are only computed on the failure path, which is out of line
+    template <class T> QUICKCPPLIB_NOINLINE inline void fire_result_failure(const T *r) noexcept
+    {
+      const telemetry::error_key k = telemetry::detail::failure_key(r);
+      (void) k;
+      OUTCOME_USDT_PROBE2(result_failure, k.category, k.value);
+    }
+    template <class T> QUICKCPPLIB_NOINLINE inline void fire_outcome_failure(const T *r) noexcept
+    {
+      const telemetry::error_key k = telemetry::detail::failure_key(r);
+      (void) k;
+      OUTCOME_USDT_PROBE2(outcome_failure, k.category, k.value);
+    }
+
+    template <class T> using exception_type_of = typename T::exception_type;
+
+    template <class T> inline void on_failure_construction(const T *r, std::false_type /*is not outcome*/) noexcept
+    {
+      if(OUTCOME_USDT_ENABLED(result_failure))
+      {
+        fire_result_failure(r);
+      }
+    }
+    template <class T> inline void on_failure_construction(const T *r, std::true_type /*is outcome*/) noexcept
+    {
+      if(OUTCOME_USDT_ENABLED(outcome_failure))
+      {
+        fire_outcome_failure(r);
+      }
+    }
+
+    template <class T> inline void on_construction(const T *r) noexcept
+    {
+      if(!r->has_value())
+      {
+        on_failure_construction(r, std::integral_constant<bool, trait::detail::is_detected<exception_type_of, T>::value>());
+      }
+    }
+
+    template <class T> using has_failure_observer = telemetry::detail::has_failure_observer<T>;
+
+    // Conversions from another result or outcome don't mint a new error, so only success_type/failure_type sugar is probed
+    template <class T, class U> inline void on_copy_or_move_construction(const T *r, const U & /*unused*/) noexcept
+    {
+      if(!trait::detail::is_detected<has_failure_observer, U>::value)
+      {
+        on_construction(r);
+      }
+    }
+
+    template <class T> using result_of_error = decltype(std::declval<const T &>().error());
+
+    // result and outcome
+    OUTCOME_TEMPLATE(class T)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(trait::detail::is_detected<has_failure_observer, T>::value))
+    inline telemetry::error_key propagation_key(const T &v, priority<2> /*unused*/) { return telemetry::detail::failure_key(&v); }
+    // expected<T, E> and the like
+    OUTCOME_TEMPLATE(class T)
+    OUTCOME_TREQUIRES(OUTCOME_TPRED(trait::detail::is_detected<result_of_error, T>::value))
+    inline telemetry::error_key propagation_key(const T &v, priority<1> /*unused*/) { return telemetry::detail::make_error_key(v.error(), priority<4>()); }
+    // optional<T> and anything else
+    template <class T> inline telemetry::error_key propagation_key(const T & /*unused*/, priority<0> /*unused*/) { return telemetry::error_key{&telemetry::detail::type_identity<T>::id, 0, nullptr}; }
+
+    template <class T> QUICKCPPLIB_NOINLINE inline void fire_try_propagate(const T &v) noexcept
+    {
+      const telemetry::error_key k = propagation_key(v, priority<2>());
+      (void) k;
+      OUTCOME_USDT_PROBE2(try_propagate, k.category, k.value);
+    }
+
+    // Called by OUTCOME_TRY just before it returns a failure
+    template <class T> constexpr inline void on_try_propagate(const T &v) noexcept
+    {
+      if(!OUTCOME_IS_CONSTANT_EVALUATED() && OUTCOME_USDT_ENABLED(try_propagate))
+      {
+        fire_try_propagate(v);
+      }
+    }
+#else
+    // Without probes there is nothing to compute, nor to call
+    template <class T> constexpr inline void on_construction(const T * /*unused*/) noexcept {}
+    template <class T, class U> constexpr inline void on_copy_or_move_construction(const T * /*unused*/, const U & /*unused*/) noexcept {}
+    template <class T> constexpr inline void on_try_propagate(const T & /*unused*/) noexcept {}
+#endif
+  }  // namespace detail
+}  // namespace usdt
+
+OUTCOME_V2_NAMESPACE_END
+
+#endif
@@ -0,0 +1,40 @@
+/* clang-format off
+(does not have the same layout as basic_result)
+clang-format on
+
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include "../../include/outcome/experimental/c_result.hpp"
+
+// A hand written C result type whose flags are narrower than basic_result's status word
+struct cxx_result_short_flags
+{
+  int value;
+  unsigned short flags;
+  long error;
+};
+CXX_RESULT_CHECK_LAYOUT(struct cxx_result_short_flags, int, long);
+
+int main()
+{
+  return 0;
+}
@@ -37,6 +37,11 @@ _disassemble_info_ = \
     , "msvc_clang" : (_mk_f("dumpbin /disasm {} > {}"), _mk_o("out", "msvc_clang.S"))
     }
 
+# Additional flags for sources which need a later C++ standard than the default
+_extra_flags_ = \
+    { "min_expected_round_trip.cpp" : { "gcc" : " -std=c++2b", "clang" : " -std=c++2b", "msvc" : " /std:c++latest", "msvc_clang" : " -std=c++2b" }
+    }
+
 #
 # Contains upper bounds on number of ops in the format
 #
@@ -46,6 +51,7 @@ _disassemble_info_ = \
 # }
 #
 limits = {
+"min_expected_round_trip"                      : { 'gcc' :  5, 'clang' :  5, 'msvc' :  5 },
 "min_monad_bind"                               : { 'gcc' :  5, 'clang' :  5, 'msvc' : 100 },
 "min_monad_construct_destruct"                 : { 'gcc' :  5, 'clang' :  5, 'msvc' :  5 },
 "min_monad_construct_error_move_destruct"      : { 'gcc' :  5, 'clang' :  5, 'msvc' :  5 },
@@ -75,7 +81,7 @@ def compile(src_file : str, compiler : str) -> str:
 
     command, output = _compile_info_[compiler]
     try:
-        subprocess.check_output(command(src_file, output(src_file)), 
+        subprocess.check_output(command(src_file, output(src_file)) + _extra_flags_.get(src_file, {}).get(compiler, ""), 
             stderr=subprocess.STDOUT, shell=True)
     except subprocess.CalledProcessError as e:
         print("[-] Error while compiling: " + e.output.decode('utf-8'), 
@@ -0,0 +1,25 @@
+#include "../../include/outcome.hpp"
+
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+// Round trip of trivially copyable payloads through std::expected must reduce to register moves.
+// The expected is a parameter, so the conversions cannot be folded away at compile time.
+extern QUICKCPPLIB_NOINLINE std::expected<int, std::errc> test1(std::expected<int, std::errc> e)
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  basic_result<int, std::errc, policy::terminate> r(std::move(e));
+  return to_expected(std::move(r));
+}
+extern QUICKCPPLIB_NOINLINE void test2()
+{
+}
+
+int main(void)
+{
+  volatile int v = 5;
+  std::expected<int, std::errc> e = test1(v);
+  test2();
+  return (e.has_value() && *e == v) ? 0 : 1;
+}
+#else
+#error This test needs std::expected
+#endif
@@ -0,0 +1,38 @@
+// Only preprocessed and parsed, to check that the minimal single header edition stays within its budget
+#include "../single-header/outcome-basic-result.hpp"
+
+enum class parse_errc
+{
+  empty = 1,
+  bad_digit
+};
+template <class T> using parse_result = OUTCOME_V2_NAMESPACE::basic_result<T, parse_errc, OUTCOME_V2_NAMESPACE::policy::all_narrow>;
+
+inline parse_result<int> parse(const char *s)
+{
+  if(*s == 0)
+  {
+    return parse_errc::empty;
+  }
+  int ret = 0;
+  for(; *s != 0; ++s)
+  {
+    if(*s < '0' || *s > '9')
+    {
+      return parse_errc::bad_digit;
+    }
+    ret = ret * 10 + (*s - '0');
+  }
+  return ret;
+}
+
+inline parse_result<int> twice(const char *s)
+{
+  OUTCOME_TRY(v, parse(s));
+  return v * 2;
+}
+
+int main()
+{
+  return (twice("21").value() == 42 && twice("x").error() == parse_errc::bad_digit) ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#if defined(__has_include)
+#if __has_include(<boost/asio/async_result.hpp>)
+#define OUTCOME_TEST_HAVE_ASIO 1
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#endif
+#endif
+
+#ifdef OUTCOME_TEST_HAVE_ASIO
+#include "../../include/outcome/asio_result.hpp"
+#endif
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#ifdef OUTCOME_TEST_HAVE_ASIO
+#include <memory>
+#include <string>
+
+namespace asio_result_test
+{
+  namespace asio = boost::asio;
+  using OUTCOME_V2_NAMESPACE::asio_error_code;
+
+  // A custom asynchronous operation completing with an error code and the supplied arguments
+  template <class Signature, class CompletionToken, class... Args> auto async_complete(asio::io_context &ctx, asio_error_code ec, CompletionToken &&token, Args... args)
+  {
+    return asio::async_initiate<CompletionToken, Signature>(
+    [&ctx, ec](auto handler, auto... args) {
+      asio::post(ctx, [ec, handler = std::move(handler), args...]() mutable { handler(ec, args...); });
+    },
+    token, args...);
+  }
+
+  // An allocator which counts the allocations made through it
+  template <class T> struct counting_allocator
+  {
+    using value_type = T;
+    int *count;
+    explicit counting_allocator(int *c)
+        : count(c)
+    {
+    }
+    template <class U>
+    counting_allocator(const counting_allocator<U> &o)
+        : count(o.count)
+    {
+    }
+    T *allocate(size_t n)
+    {
+      ++*count;
+      return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T *p, size_t n) { std::allocator<T>().deallocate(p, n); }
+    template <class U> bool operator==(const counting_allocator<U> &o) const { return count == o.count; }
+    template <class U> bool operator!=(const counting_allocator<U> &o) const { return count != o.count; }
+  };
+
+  // A handler with associated allocator and executor, which must be seen through the adapted handler
+  template <class Executor, class F> struct associated_handler
+  {
+    using allocator_type = counting_allocator<void>;
+    using executor_type = Executor;
+    allocator_type allocator;
+    executor_type executor;
+    F f;
+    allocator_type get_allocator() const noexcept { return allocator; }
+    executor_type get_executor() const noexcept { return executor; }
+    template <class... Args> void operator()(Args &&... args) { f(static_cast<Args &&>(args)...); }
+  };
+}  // namespace asio_result_test
+#endif
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / asio / as_result, "Tests that as_result adapts ASIO completion tokens to complete with a result")
+{
+#ifdef OUTCOME_TEST_HAVE_ASIO
+  namespace outcome = OUTCOME_V2_NAMESPACE;
+  namespace asio = boost::asio;
+  using namespace asio_result_test;
+  static_assert(std::is_same<outcome::detail::asio_result_signature<void(asio_error_code)>::type, void(outcome::asio_result<void>)>::value, "");
+  static_assert(std::is_same<outcome::detail::asio_result_signature<void(const asio_error_code &, size_t)>::type, void(outcome::asio_result<size_t>)>::value, "");
+  static_assert(std::is_same<outcome::detail::asio_result_signature<void(asio_error_code, int, std::string)>::type, void(outcome::asio_result<std::tuple<int, std::string>>)>::value, "");
+  static_assert(std::is_same<outcome::detail::asio_result_signature<void(int)>::type, void(int)>::value, "");
+
+  asio::io_context ctx;
+  const asio_error_code failure = make_error_code(asio::error::connection_reset);
+  int completions = 0;
+  {
+    // Zero, one and many arguments after the error code
+    async_complete<void(asio_error_code)>(ctx, {}, outcome::as_result([&](outcome::asio_result<void> r) {
+                                            BOOST_CHECK(r.has_value());
+                                            ++completions;
+                                          }));
+    async_complete<void(asio_error_code)>(ctx, failure, outcome::as_result([&](outcome::asio_result<void> r) {
+                                            BOOST_CHECK(r.error() == failure);
+                                            ++completions;
+                                          }));
+    async_complete<void(asio_error_code, int)>(ctx, {}, outcome::as_result([&](outcome::asio_result<int> r) {
+                                                 BOOST_CHECK(r.value() == 5);
+                                                 ++completions;
+                                               }),
+                                               5);
+    async_complete<void(asio_error_code, int)>(ctx, failure, outcome::as_result([&](outcome::asio_result<int> r) {
+                                                 BOOST_CHECK(r.error() == failure);
+                                                 ++completions;
+                                               }),
+                                               5);
+    async_complete<void(asio_error_code, int, std::string)>(ctx, {}, outcome::as_result([&](outcome::asio_result<std::tuple<int, std::string>> r) {
+                                                              BOOST_CHECK(std::get<0>(r.value()) == 6);
+                                                              BOOST_CHECK(std::get<1>(r.value()) == "niall");
+                                                              ++completions;
+                                                            }),
+                                                            6, std::string("niall"));
+    ctx.run();
+    ctx.restart();
+    BOOST_CHECK(completions == 5);
+  }
+  {
+    // A cancelled timer completes with operation_aborted
+    asio::steady_timer timer(ctx, std::chrono::seconds(60));
+    timer.async_wait(outcome::as_result([&](outcome::asio_result<void> r) {
+      BOOST_CHECK(r.has_error());
+      BOOST_CHECK(r.error() == asio::error::operation_aborted);
+      ++completions;
+    }));
+    timer.cancel();
+    ctx.run();
+    ctx.restart();
+    BOOST_CHECK(completions == 6);
+  }
+  {
+    // The associated allocator and executor of the wrapped handler are those of the adapted handler
+    int allocations = 0;
+    auto strand = asio::make_strand(ctx);
+    auto f = [&](outcome::asio_result<void> r) {
+      BOOST_CHECK(strand.running_in_this_thread());
+      BOOST_CHECK(r.has_value());
+      ++completions;
+    };
+    using handler_type = associated_handler<decltype(strand), decltype(f)>;
+    using adapted_type = outcome::detail::asio_result_handler<handler_type, outcome::asio_result<void>>;
+    static_assert(std::is_same<asio::associated_allocator_t<adapted_type>, counting_allocator<void>>::value, "");
+    static_assert(std::is_same<asio::associated_executor_t<adapted_type>, decltype(strand)>::value, "");
+    adapted_type adapted{handler_type{counting_allocator<void>(&allocations), strand, f}};
+    BOOST_CHECK(asio::get_associated_allocator(adapted).count == &allocations);
+    BOOST_CHECK(asio::get_associated_executor(adapted) == strand);
+    // The timer allocates its operation from the handler's allocator, and completes on the strand
+    asio::steady_timer timer(ctx, std::chrono::milliseconds(1));
+    timer.async_wait(outcome::as_result(handler_type{counting_allocator<void>(&allocations), strand, f}));
+    ctx.run();
+    BOOST_CHECK(completions == 7);
+    BOOST_CHECK(allocations > 0);
+  }
+  {
+    // Move only handlers are moved through, never copied
+    ctx.restart();
+    auto p = std::make_unique<int>(8);
+    asio::steady_timer timer(ctx, std::chrono::milliseconds(1));
+    timer.async_wait(outcome::as_result([&, p = std::move(p)](outcome::asio_result<void> r) {
+      BOOST_CHECK(r.has_value());
+      BOOST_CHECK(*p == 8);
+      ++completions;
+    }));
+    ctx.run();
+    BOOST_CHECK(completions == 8);
+  }
+  {
+    // Lvalue tokens are copied from, never moved from
+    ctx.restart();
+    auto p = std::make_shared<int>(9);
+    auto token = outcome::as_result([&, p](outcome::asio_result<void> r) {
+      BOOST_CHECK(r.has_value());
+      BOOST_CHECK(*p == 9);
+      ++completions;
+    });
+    asio::steady_timer timer(ctx, std::chrono::milliseconds(1));
+    timer.async_wait(token);
+    ctx.run();
+    BOOST_CHECK(completions == 9);
+    BOOST_CHECK(p.use_count() == 2);
+  }
+#endif
+}
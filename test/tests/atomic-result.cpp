@@ -0,0 +1,223 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#define OUTCOME_ENABLE_TELEMETRY 1
+
+#include "../../include/outcome/atomic_result.hpp"
+#include "../../include/outcome/result.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace atomic_result_test
+{
+  // Both halves are always equal, so a torn read shows as unequal halves
+  struct pair32
+  {
+    uint32_t a, b;
+  };
+  struct pair64
+  {
+    uint64_t a, b;
+  };
+
+  // Readers check every result they see is whole while writers publish values and errors
+  template <class T, class E, class Make, class Check> void hammer(Make make, Check check)
+  {
+    OUTCOME_V2_NAMESPACE::atomic_result<T, E> r(make(0));
+    std::atomic<bool> done{false};
+    std::atomic<unsigned> torn{0};
+    std::vector<std::thread> threads;
+    for(unsigned n = 0; n < 2; n++)
+    {
+      threads.emplace_back([&] {
+        while(!done.load(std::memory_order_relaxed))
+        {
+          if(!check(r.load()))
+          {
+            ++torn;
+          }
+        }
+      });
+    }
+    for(unsigned n = 0; n < 2; n++)
+    {
+      threads.emplace_back([&, n] {
+        for(uint32_t i = 1; i < 20000; i++)
+        {
+          r.store(make(i * 2 + n));
+        }
+      });
+    }
+    for(size_t n = 2; n < threads.size(); n++)
+    {
+      threads[n].join();
+    }
+    done = true;
+    threads[0].join();
+    threads[1].join();
+    BOOST_CHECK(torn == 0);
+  }
+}  // namespace atomic_result_test
+
+// Loads copy results back together rather than constructing them, so compile even where the value
+// and error types are the same and in place construction is disabled
+template class OUTCOME_V2_NAMESPACE::atomic_result<int, int>;
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / atomic_result / operations, "Tests that atomic_result loads, stores, exchanges and compares and exchanges results")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  using namespace atomic_result_test;
+  // The value or the error, and the status, fit eight or sixteen bytes
+  static_assert(atomic_result<int, std::errc>::is_always_lock_free, "");
+  static_assert(atomic_result<void, std::errc>::is_always_lock_free, "");
+  static_assert(atomic_result<pair32, std::errc>::is_always_lock_free == (OUTCOME_ATOMIC_RESULT_USE_CAS16 != 0), "");
+  static_assert(!atomic_result<int, std::error_code>::is_always_lock_free, "");
+  static_assert(!std::is_copy_constructible<atomic_result<int, std::errc>>::value, "");
+  {
+    using result_type = result<int, std::errc>;
+    atomic_result<int, std::errc> a(result_type(5));
+    BOOST_CHECK(a.load().value() == 5);
+    a.store(std::errc::invalid_argument);
+    BOOST_CHECK(a.load().error() == std::errc::invalid_argument);
+    BOOST_CHECK(a.exchange(6).error() == std::errc::invalid_argument);
+    result_type expected(7);
+    BOOST_CHECK(!a.compare_exchange_strong(expected, 8));
+    BOOST_CHECK(expected.value() == 6);
+    BOOST_CHECK(a.compare_exchange_strong(expected, std::errc::timed_out));
+    BOOST_CHECK(a.load().error() == std::errc::timed_out);
+    // Spare storage survives the round trip, and an equal value with other spare storage is unequal
+    result_type r(9);
+    hooks::set_spare_storage(&r, 0x1234);
+    a.store(r);
+    r = a.load();
+    BOOST_CHECK(hooks::spare_storage(&r) == 0x1234);
+    expected = result_type(9);
+    BOOST_CHECK(!a.compare_exchange_weak(expected, 10));
+    BOOST_CHECK(hooks::spare_storage(&expected) == 0x1234);
+    BOOST_CHECK(a.compare_exchange_weak(expected, 10));
+  }
+  {
+    atomic_result<void, std::errc> a(success());
+    BOOST_CHECK(a.is_lock_free());
+    BOOST_CHECK(a.load().has_value());
+    a.store(std::errc::io_error);
+    BOOST_CHECK(a.load().error() == std::errc::io_error);
+  }
+  {
+    // Larger results fall back to a sequence lock
+    atomic_result<int> a(5);
+    BOOST_CHECK(!a.is_lock_free());
+    result<int> expected(5);
+    BOOST_CHECK(a.compare_exchange_strong(expected, std::make_error_code(std::errc::io_error)));
+    BOOST_CHECK(a.load().error() == std::errc::io_error);
+    BOOST_CHECK(a.exchange(6).error() == std::errc::io_error);
+    BOOST_CHECK(a.load().value() == 6);
+  }
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / atomic_result / threaded, "Tests that atomic_result is never torn, and that wait() is woken")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  using namespace atomic_result_test;
+  // Lock free
+  hammer<pair32, std::errc>(
+  [](uint32_t i) { return (i % 3 == 0) ? result<pair32, std::errc>(static_cast<std::errc>(i)) : result<pair32, std::errc>(pair32{i, i}); },  //
+  [](const result<pair32, std::errc> &r) { return r.has_value() ? r.value().a == r.value().b : static_cast<uint32_t>(r.error()) % 3 == 0; });
+  // Sequence lock
+  hammer<pair64, std::error_code>(
+  [](uint32_t i) { return (i % 3 == 0) ? result<pair64>(std::error_code(static_cast<int>(i), std::generic_category())) : result<pair64>(pair64{i, i}); },  //
+  [](const result<pair64> &r) { return r.has_value() ? r.value().a == r.value().b : r.error().value() % 3 == 0; });
+
+  {
+    // Compare and exchange never loses an increment
+    atomic_result<int, std::errc> a(result<int, std::errc>(0));
+    std::vector<std::thread> threads;
+    for(unsigned n = 0; n < 4; n++)
+    {
+      threads.emplace_back([&] {
+        for(int i = 0; i < 10000; i++)
+        {
+          auto expected = a.load();
+          while(!a.compare_exchange_weak(expected, expected.value() + 1))
+          {
+          }
+        }
+      });
+    }
+    for(auto &t : threads)
+    {
+      t.join();
+    }
+    BOOST_CHECK(a.load().value() == 40000);
+  }
+  {
+    // Waiters are woken by a change and a notify
+    atomic_result<int, std::errc> a(result<int, std::errc>(0));
+    std::atomic<int> woken{0};
+    std::vector<std::thread> threads;
+    for(unsigned n = 0; n < 3; n++)
+    {
+      threads.emplace_back([&] {
+        a.wait(result<int, std::errc>(0));
+        BOOST_CHECK(a.load().error() == std::errc::operation_canceled);
+        ++woken;
+      });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK(woken == 0);
+    a.store(std::errc::operation_canceled);
+    a.notify_all();
+    for(auto &t : threads)
+    {
+      t.join();
+    }
+    BOOST_CHECK(woken == 3);
+    // Waiting on a result other than the current one returns at once
+    a.wait(result<int, std::errc>(0));
+  }
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / atomic_result / telemetry, "Tests that results loaded from an atomic_result are not counted as constructed again")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  result<int> a(5), b(std::error_code(ETIMEDOUT, std::generic_category()));
+  hooks::set_spare_storage(&b, 0x55);
+  atomic_result<int> ar(a);
+  auto before = telemetry::snapshot();
+  for(int n = 0; n < 10; n++)
+  {
+    BOOST_CHECK(ar.load().value() == 5);
+  }
+  ar.store(b);
+  result<int> c = ar.exchange(a);
+  BOOST_CHECK(c.error() == std::errc::timed_out);
+  BOOST_CHECK(hooks::spare_storage(&c) == 0x55);
+  result<int> expected = b;
+  BOOST_CHECK(!ar.compare_exchange_strong(expected, b));
+  BOOST_CHECK(expected.value() == 5);
+  auto after = telemetry::snapshot();
+  BOOST_CHECK(after.constructions() == before.constructions());
+}
@@ -0,0 +1,142 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include "../../include/outcome/boxed_payload.hpp"
+#include "../../include/outcome/try.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <string>
+
+namespace boxed_payload_test
+{
+  namespace outcome = OUTCOME_V2_NAMESPACE;
+
+  // The paths related to a failure, boxed away from the result
+  struct paths
+  {
+    std::string path1, path2;
+  };
+  using failure_info = outcome::boxed_payload<paths>;
+  template <class T> using fs_result = outcome::std_result<T, failure_info>;
+
+  struct filesystem_error : std::system_error
+  {
+    std::string path1, path2;
+    filesystem_error(std::error_code ec, std::string p1, std::string p2)
+        : std::system_error(ec)
+        , path1(std::move(p1))
+        , path2(std::move(p2))
+    {
+    }
+  };
+
+  // Customise what the default policy throws, as for any payload
+  inline void outcome_throw_as_system_error_with_payload(const failure_info &fi)
+  {
+    if(fi.has_payload())
+    {
+      throw filesystem_error(fi.code(), fi.payload().path1, fi.payload().path2);
+    }
+    throw std::system_error(fi.code());
+  }
+
+  inline fs_result<void> copy_file(const std::string &from, const std::string &to) noexcept
+  {
+    if(from.empty())
+    {
+      return std::errc::invalid_argument;
+    }
+    return failure_info{make_error_code(std::errc::no_such_file_or_directory), from, to};
+  }
+  inline fs_result<int> copy_files(const std::string &from, const std::string &to) noexcept
+  {
+    OUTCOME_TRYV(copy_file(from, to));
+    return 1;
+  }
+}  // namespace boxed_payload_test
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / boxed_payload, "Tests that boxed_payload keeps results small and shares its payload")
+{
+  using namespace boxed_payload_test;
+  static_assert(sizeof(fs_result<int>) <= sizeof(outcome::std_result<int>) + sizeof(void *), "");
+  static_assert(outcome::trait::is_error_type<failure_info>::value, "");
+  static_assert(outcome::trait::is_error_code_available<failure_info>::value, "");
+  {
+    auto r = copy_files("dontexist", "alsodontexist");
+    BOOST_REQUIRE(r.has_error());
+    // Comparisons are of the inline error code only
+    BOOST_CHECK(r.error() == std::errc::no_such_file_or_directory);
+    BOOST_CHECK(r.error() != std::errc::invalid_argument);
+    BOOST_CHECK(r.error() == make_error_code(std::errc::no_such_file_or_directory));
+    BOOST_CHECK(make_error_code(r.error()) == std::errc::no_such_file_or_directory);
+    BOOST_REQUIRE(r.error().has_payload());
+    BOOST_CHECK(r.error().payload().path1 == "dontexist");
+    BOOST_CHECK(r.error().payload().path2 == "alsodontexist");
+    // Copies share the payload rather than copying the paths
+    failure_info copy = r.error();
+    BOOST_CHECK(&copy.payload() == &r.error().payload());
+    failure_info moved = std::move(copy);
+    BOOST_CHECK(!copy.has_payload());
+    BOOST_CHECK(&moved.payload() == &r.error().payload());
+  }
+  {
+    // Error enums construct an error code without a payload
+    auto r = copy_file("", "x");
+    BOOST_CHECK(r.error() == std::errc::invalid_argument);
+    BOOST_CHECK(!r.error().has_payload());
+    fs_result<int> r2(std::errc::permission_denied);
+    BOOST_CHECK(r2.error() == std::errc::permission_denied);
+  }
+  {
+    // Freed side blocks are reused by the next failure on this thread
+    const paths *first = &copy_file("a", "b").error().payload();
+    auto r = copy_file("c", "d");
+    BOOST_CHECK(&r.error().payload() == first);
+    BOOST_CHECK(r.error().payload().path1 == "c");
+  }
+#ifdef __cpp_exceptions
+  {
+    try
+    {
+      copy_files("dontexist", "alsodontexist").value();
+      BOOST_CHECK(false);
+    }
+    catch(const filesystem_error &e)
+    {
+      BOOST_CHECK(e.code() == std::errc::no_such_file_or_directory);
+      BOOST_CHECK(e.path2 == "alsodontexist");
+    }
+    // Without a customisation, the error code is thrown
+    try
+    {
+      outcome::std_result<int, outcome::boxed_payload<int>> r(outcome::boxed_payload<int>(make_error_code(std::errc::io_error), 5));
+      r.value();
+      BOOST_CHECK(false);
+    }
+    catch(const std::system_error &e)
+    {
+      BOOST_CHECK(e.code() == std::errc::io_error);
+    }
+  }
+#endif
+}
@@ -0,0 +1,152 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#define OUTCOME_ENABLE_TRY_BREADCRUMBS 1
+
+#include "../../include/outcome/outcome.hpp"
+#include "../../include/outcome/std_expected.hpp"
+#include "../../include/outcome/try.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <cstring>
+
+namespace breadcrumbs_test
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+
+  static uint32_t line2, line3, line4;  // NOLINT
+
+  QUICKCPPLIB_NOINLINE inline result<int> func1(bool fail)
+  {
+    if(fail)
+    {
+      return std::errc::timed_out;
+    }
+    return 5;
+  }
+  QUICKCPPLIB_NOINLINE inline result<int> func2(bool fail)
+  {
+    // clang-format off
+    line2 = __LINE__; OUTCOME_TRY(v, func1(fail));
+    // clang-format on
+    return v + 1;
+  }
+  QUICKCPPLIB_NOINLINE inline result<long> func3(bool fail)
+  {
+    // clang-format off
+    line3 = __LINE__; OUTCOME_TRYV(func2(fail));
+    // clang-format on
+    return 0;
+  }
+  QUICKCPPLIB_NOINLINE inline outcome<void> func4(bool fail)
+  {
+    // clang-format off
+    line4 = __LINE__; OUTCOME_TRYV(func3(fail));
+    // clang-format on
+    return success();
+  }
+
+  // Not a result or outcome, so a trail propagated into it has nowhere to go
+  struct not_a_result
+  {
+    bool failed{false};
+    not_a_result() = default;
+    not_a_result(failure_type<std::error_code> /*unused*/)  // NOLINT
+        : failed(true)
+    {
+    }
+  };
+  QUICKCPPLIB_NOINLINE inline not_a_result func5(bool fail)
+  {
+    OUTCOME_TRYV(func2(fail));
+    return {};
+  }
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+  QUICKCPPLIB_NOINLINE inline std::expected<int, std::errc> func6(bool fail)
+  {
+    OUTCOME_TRY(v, fail ? std::expected<int, std::errc>(std::unexpect, std::errc::timed_out) : std::expected<int, std::errc>(5));
+    return v + 1;
+  }
+#endif
+}  // namespace breadcrumbs_test
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / breadcrumbs, "Tests that OUTCOME_TRY leaves a trail of breadcrumbs in spare storage")
+{
+  using namespace breadcrumbs_test;
+  // Successful propagation leaves nothing behind
+  {
+    auto r = func4(false);
+    BOOST_CHECK(r.has_value());
+    BOOST_CHECK(hooks::spare_storage(&r) == 0);
+    BOOST_CHECK(breadcrumbs::trail(r).empty());
+  }
+  // The error returned by func1() has no trail, as it has not propagated yet
+  {
+    auto r = func1(true);
+    BOOST_CHECK(breadcrumbs::trail(r).empty());
+  }
+  {
+    auto r = func4(true);
+    BOOST_REQUIRE(r.has_error());
+    BOOST_CHECK(r.error() == std::errc::timed_out);
+    auto trail = breadcrumbs::trail(r);
+    BOOST_REQUIRE(trail.size() == 3);
+    // Newest first
+    BOOST_CHECK(trail[0].line == line4);
+    BOOST_CHECK(trail[1].line == line3);
+    BOOST_CHECK(trail[2].line == line2);
+    for(auto &c : trail)
+    {
+      BOOST_CHECK(strstr(c.file, "breadcrumbs.cpp") != nullptr);
+    }
+    BOOST_CHECK(trail[2].previous == 0);
+  }
+  // A trail which propagates into something other than a result or outcome is not stitched into
+  // the next unrelated failure constructed on this thread
+  {
+    BOOST_CHECK(func5(true).failed);
+    result<int> r(failure(make_error_code(std::errc::io_error)));
+    BOOST_CHECK(hooks::spare_storage(&r) == 0);
+    BOOST_CHECK(breadcrumbs::trail(r).empty());
+  }
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+  {
+    BOOST_CHECK(!func6(true).has_value());
+    outcome<int> r(failure(make_error_code(std::errc::io_error)));
+    BOOST_CHECK(hooks::spare_storage(&r) == 0);
+    BOOST_CHECK(breadcrumbs::trail(r).empty());
+  }
+#endif
+  // Enough propagations to wrap the per-thread buffer and the id sequence render old trails stale
+  {
+    auto old = func3(true);
+    BOOST_CHECK(breadcrumbs::trail(old).size() == 2);
+    for(size_t n = 0; n < 70000; n++)
+    {
+      (void) func2(true);
+    }
+    BOOST_CHECK(breadcrumbs::trail(old).size() < 2);
+    auto r = func4(true);
+    BOOST_CHECK(breadcrumbs::trail(r).size() == 3);
+  }
+}
@@ -0,0 +1,90 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+// result.h is pure C, and so can be included with C linkage
+extern "C" {
+#include "../../include/outcome/experimental/result.h"
+}
+#include "../../include/outcome/experimental/c_result.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <vector>
+
+// As if from a C header shared between both languages
+extern "C" {
+struct c_result_error
+{
+  int code;
+  const char *message;
+};
+CXX_DECLARE_RESULT(int_error, int, struct c_result_error);
+CXX_DECLARE_RESULT(double_long, double, long);
+}
+// As if from the C++ source implementing the functions declared in that header
+CXX_RESULT_CHECK_LAYOUT(CXX_RESULT(int_error), int, c_result_error);
+CXX_RESULT_CHECK_LAYOUT(CXX_RESULT(double_long), double, long);
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / c_api / layout, "Tests that C result types are layout checked against basic_result, and can be bulk filled")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  using int_result = basic_result<int, c_result_error, policy::all_narrow>;
+  using double_result = basic_result<double, long, policy::all_narrow>;
+  static_assert(experimental::detail::c_result_layout_matches<CXX_RESULT(int_error), int, c_result_error>::value, "");
+  static_assert(experimental::detail::c_result_layout_matches<CXX_RESULT(double_long), double, long>::value, "");
+  static_assert(!experimental::detail::c_result_layout_matches<CXX_RESULT(double_long), float, long>::value, "");
+  {
+    CXX_RESULT(int_error) slot;
+    experimental::to_c_result(slot, int_result(in_place_type<int>, 5));
+    BOOST_CHECK(CXX_RESULT_HAS_VALUE(slot));
+    BOOST_CHECK(!CXX_RESULT_HAS_ERROR(slot));
+    BOOST_CHECK(slot.value == 5);
+    experimental::to_c_result(slot, int_result(in_place_type<c_result_error>, c_result_error{78, "boom"}));
+    BOOST_CHECK(!CXX_RESULT_HAS_VALUE(slot));
+    BOOST_CHECK(CXX_RESULT_HAS_ERROR(slot));
+    BOOST_CHECK(slot.error.code == 78);
+  }
+  {
+    // C hands in a caller owned array which C++ fills in place
+    std::vector<CXX_RESULT(double_long)> slots(100);
+    experimental::fill_c_results(slots.data(), slots.size(), [](size_t n) -> double_result {
+      if(n % 3 == 0)
+      {
+        return double_result(in_place_type<long>, (long) n);
+      }
+      return double_result(in_place_type<double>, n * 0.5);
+    });
+    for(size_t n = 0; n < slots.size(); n++)
+    {
+      if(n % 3 == 0)
+      {
+        BOOST_CHECK(CXX_RESULT_HAS_ERROR(slots[n]));
+        BOOST_CHECK(slots[n].error == (long) n);
+      }
+      else
+      {
+        BOOST_CHECK(CXX_RESULT_HAS_VALUE(slots[n]));
+        BOOST_CHECK(slots[n].value == n * 0.5);
+      }
+    }
+  }
+}
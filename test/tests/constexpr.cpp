@@ -24,6 +24,73 @@ Distributed under the Boost Software License, Version 1.0.
 #include "../../include/outcome/outcome.hpp"
 #include "quickcpplib/include/boost/test/unit_test.hpp"
 
+#if OUTCOME_USE_STD_CONSTRUCT_AT
+#include <string>
+#include <vector>
+
+namespace constexpr_nontrivial
+{
+  namespace outcome = OUTCOME_V2_NAMESPACE;
+  enum class lookup_errc
+  {
+    not_found = 1
+  };
+  // A type whose swap may throw, which selects the exception safe swap implementation
+  struct throwing_swap
+  {
+    std::string s;
+    throwing_swap() = default;
+    constexpr explicit throwing_swap(const char *_s)
+        : s(_s)
+    {
+    }
+    friend constexpr void swap(throwing_swap &a, throwing_swap &b) noexcept(false) { a.s.swap(b.s); }
+  };
+  using lookup_result = outcome::basic_result<std::string, lookup_errc, outcome::policy::all_narrow>;
+
+  constexpr lookup_result lookup(int idx)
+  {
+    if(idx < 0 || idx > 2)
+    {
+      return lookup_errc::not_found;
+    }
+    const char *names[] = {"zero", "one", "two"};
+    return std::string(names[idx]);
+  }
+  // Builds a table of results, exercising every constructor, assignment, swap and destructor
+  constexpr size_t total_length()
+  {
+    std::vector<lookup_result> table;
+    for(int n = -1; n <= 3; n++)
+    {
+      table.push_back(lookup(n));
+    }
+    lookup_result copy(table[1]), moved(std::move(copy));
+    copy = table[0];     // error over error
+    copy = moved;        // value over error
+    moved = table[4];    // error over value
+    table[2] = moved;    // error over value
+    table[0].swap(table[3]);
+    size_t ret = 0;
+    for(auto &i : table)
+    {
+      ret += i.has_value() ? i.value().size() : 100;
+    }
+    return ret + copy.value().size();
+  }
+  static_assert(total_length() == 3 + 100 + 100 + 4 + 100 + 4, "");
+
+  constexpr size_t throwing_swap_length()
+  {
+    using result_type = outcome::basic_result<std::vector<int>, throwing_swap, outcome::policy::all_narrow>;
+    result_type a(std::vector<int>{1, 2, 3}), b(outcome::in_place_type<throwing_swap>, "oops");
+    a.swap(b);
+    return a.error().s.size() + b.value().size();
+  }
+  static_assert(throwing_swap_length() == 4 + 3, "");
+}  // namespace constexpr_nontrivial
+#endif
+
 BOOST_OUTCOME_AUTO_TEST_CASE(works / outcome / constexpr, "Tests that outcome works as intended in a constexpr evaluation context")
 {
   using namespace OUTCOME_V2_NAMESPACE;
@@ -0,0 +1,151 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include "../../include/outcome.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+namespace error_classification_test
+{
+  enum error_class : uint8_t
+  {
+    transient = 1,
+    permanent = 2,
+    timeout = 4,
+    exhausted = 8
+  };
+  static int classifications;
+
+  enum class parse_errc
+  {
+    truncated = 1,
+    malformed = 2
+  };
+
+  // An unclassified error type which converts into a classified one
+  struct raw_errno
+  {
+    int value{0};
+    operator std::error_code() const noexcept { return {value, std::generic_category()}; }  // NOLINT
+  };
+}  // namespace error_classification_test
+
+OUTCOME_V2_NAMESPACE_BEGIN
+namespace trait
+{
+  // Classify std::error_code once per failure, rather than at every retry decision
+  template <> struct error_classifier<std::error_code>
+  {
+    static uint8_t classify(const std::error_code &ec) noexcept
+    {
+      using namespace error_classification_test;
+      ++classifications;
+      if(ec == std::errc::timed_out)
+      {
+        return timeout | transient;
+      }
+      if(ec == std::errc::resource_unavailable_try_again || ec == std::errc::interrupted)
+      {
+        return transient;
+      }
+      if(ec == std::errc::not_enough_memory || ec == std::errc::too_many_files_open)
+      {
+        return exhausted | transient;
+      }
+      return permanent;
+    }
+  };
+  // Classifiers can be constexpr
+  template <> struct error_classifier<error_classification_test::parse_errc>
+  {
+    static constexpr uint8_t classify(error_classification_test::parse_errc e) noexcept { return (e == error_classification_test::parse_errc::truncated) ? error_classification_test::transient : error_classification_test::permanent; }
+  };
+}  // namespace trait
+OUTCOME_V2_NAMESPACE_END
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / result / error_classification, "Tests that error classes are computed once at construction and cached in the status")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  using namespace error_classification_test;
+  {
+    classifications = 0;
+    result<int> r(std::errc::timed_out);
+    BOOST_CHECK(classifications == 1);
+    BOOST_CHECK(r.error_class() == (timeout | transient));
+    BOOST_CHECK(r.has_error_class(transient));
+    BOOST_CHECK(r.has_error_class(timeout | exhausted));
+    BOOST_CHECK(!r.has_error_class(permanent));
+    // Copies and moves carry the class bits without reclassifying
+    result<int> r2(r), r3(std::move(r2));
+    r2 = r3;
+    BOOST_CHECK(classifications == 1);
+    BOOST_CHECK(r2.error_class() == (timeout | transient));
+    BOOST_CHECK(r3.error_class() == (timeout | transient));
+    // Swapping swaps the class bits
+    result<int> r4(5);
+    BOOST_CHECK(r4.error_class() == 0);
+    swap(r3, r4);
+    BOOST_CHECK(r3.error_class() == 0);
+    BOOST_CHECK(r4.has_error_class(timeout));
+    r4 = 6;
+    BOOST_CHECK(r4.error_class() == 0);
+    // Classes are per failure
+    BOOST_CHECK(result<int>(std::errc::not_enough_memory).error_class() == (exhausted | transient));
+    BOOST_CHECK(result<int>(std::errc::invalid_argument).error_class() == permanent);
+    BOOST_CHECK(result<int>(in_place_type<std::error_code>, ENOENT, std::generic_category()).error_class() == permanent);
+  }
+  {
+    // Successes are never classified
+    classifications = 0;
+    result<int> r(5);
+    BOOST_CHECK(classifications == 0);
+    BOOST_CHECK(r.error_class() == 0);
+    BOOST_CHECK(!r.has_error_class(0xff));
+  }
+  {
+    // Outcomes are classified too, and conversions keep the classification
+    outcome<int> o(std::errc::interrupted);
+    BOOST_CHECK(o.error_class() == transient);
+    result<int> r(std::errc::resource_unavailable_try_again);
+    outcome<long> o2(r);
+    BOOST_CHECK(o2.error_class() == transient);
+    outcome<int> o3(std::make_exception_ptr(5));
+    BOOST_CHECK(o3.error_class() == 0);
+  }
+  {
+    // Error types without a classifier have no class bits
+    basic_result<int, raw_errno, policy::all_narrow> r(raw_errno{ETIMEDOUT});
+    BOOST_CHECK(r.error_class() == 0);
+    // Converting to an error type with a classifier classifies
+    classifications = 0;
+    basic_result<int, std::error_code, policy::all_narrow> r2(r);
+    BOOST_CHECK(classifications == 1);
+    BOOST_CHECK(r2.error_class() == (timeout | transient));
+    result<int, parse_errc> p(parse_errc::truncated);
+    BOOST_CHECK(p.error_class() == transient);
+  }
+  {
+    constexpr result<int, parse_errc> p(parse_errc::malformed);
+    static_assert(p.error_class() == permanent, "");
+    static_assert(p.has_error_class(permanent), "");
+  }
+}
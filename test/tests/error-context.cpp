@@ -0,0 +1,185 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include "../../include/outcome/error_context.hpp"
+#include "../../include/outcome/try.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace error_context_test
+{
+  namespace outcome = OUTCOME_V2_NAMESPACE;
+
+  inline outcome::std_result<int> open_file(const char *path)
+  {
+    if(0 == strcmp(path, "missing"))
+    {
+      return std::errc::no_such_file_or_directory;
+    }
+    return 5;
+  }
+  inline outcome::context_result<int> read_config(const char *path)
+  {
+    OUTCOME_TRY(fd, outcome::add_context(open_file(path), "opening config"));
+    return fd + 1;
+  }
+  inline outcome::context_result<int> load_profile(int profile, const char *path)
+  {
+    OUTCOME_TRY(v, outcome::add_context_format(read_config(path), "loading profile %d", profile));
+    return v + profile;
+  }
+}  // namespace error_context_test
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / error_context / chaining, "Tests that context frames chain through the arena and render lazily")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  using namespace error_context_test;
+  static_assert(std::is_trivially_copyable<error_with_context<>>::value, "");
+  static_assert(sizeof(error_with_context<>) <= sizeof(std::error_code) + sizeof(void *) + sizeof(uint32_t) + 4, "");
+
+  BOOST_CHECK(load_profile(3, "present").value() == 9);
+  auto r = load_profile(3, "missing");
+  BOOST_REQUIRE(r.has_error());
+  BOOST_CHECK(r.error() == std::errc::no_such_file_or_directory);
+  BOOST_CHECK(r.error().has_context());
+  const std::string expected = "loading profile 3: opening config: " + std::make_error_code(std::errc::no_such_file_or_directory).message();
+  BOOST_CHECK(r.error().render() == expected);
+  std::vector<std::string> frames;
+  BOOST_CHECK(r.error().visit_context([&](const char *text) { frames.emplace_back(text); }));
+  BOOST_CHECK((frames == std::vector<std::string>{"loading profile 3", "opening config"}));
+#ifdef __cpp_exceptions
+  try
+  {
+    r.value();
+    BOOST_CHECK(false);
+  }
+  catch(const std::system_error &e)
+  {
+    BOOST_CHECK(e.code() == std::errc::no_such_file_or_directory);
+  }
+#endif
+
+  // Copies share the chain so far, and each can be extended independently
+  auto e1 = r.error(), e2 = r.error();
+  e1.add("left");
+  e2.add("right");
+  BOOST_CHECK(e1.render() == "left: " + expected);
+  BOOST_CHECK(e2.render() == "right: " + expected);
+  BOOST_CHECK(r.error().render() == expected);
+
+  // Formatted frames are truncated rather than allocating
+  error_with_context<> e3(std::make_error_code(std::errc::io_error));
+  BOOST_CHECK(!e3.has_context());
+  e3.add_format("%s", std::string(100, 'x').c_str());
+  e3.visit_context([](const char *text) { BOOST_CHECK(strlen(text) == context_arena::max_formatted_length); });
+  // Successes never touch the arena
+  auto ok = add_context(open_file("present"), "never recorded");
+  BOOST_CHECK(ok.value() == 5);
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / error_context / arenas, "Tests that caller supplied arenas wrap and chain across threads")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+#ifdef __cpp_exceptions
+  BOOST_CHECK_THROW(context_arena(3), std::invalid_argument);
+#endif
+  context_arena small(4);
+  BOOST_CHECK(small.capacity() == 4);
+  error_with_context<> e(std::make_error_code(std::errc::timed_out), "frame 0", small);
+  for(int n = 1; n < 6; n++)
+  {
+    e.add((n % 2) ? "odd frame" : "even frame", small);
+  }
+  // The two oldest frames were overwritten
+  int count = 0;
+  BOOST_CHECK(!e.visit_context([&](const char * /*unused*/) { ++count; }));
+  BOOST_CHECK(count == 4);
+  BOOST_CHECK(e.render().compare(0, 10, "odd frame:") == 0);
+  BOOST_CHECK(e.render().find("...: ") != std::string::npos);
+
+  // A chain may span the arenas of several threads
+  context_arena worker_arena;
+  error_with_context<> e2;
+  std::thread([&] { e2 = error_with_context<>(std::make_error_code(std::errc::broken_pipe), "in worker", worker_arena); }).join();
+  e2.add("in main");
+  BOOST_CHECK(e2.render() == "in main: in worker: " + std::make_error_code(std::errc::broken_pipe).message());
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / error_context / thread_arenas, "Tests that context outlives the thread which added it, and can be read while being overwritten")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  const std::string message = std::make_error_code(std::errc::broken_pipe).message();
+  // Context added on a thread which has since exited is still there
+  error_with_context<> e;
+  const context_arena *worker_arena = nullptr;
+  std::thread([&] {
+    e = error_with_context<>(std::make_error_code(std::errc::broken_pipe), "in worker");
+    e.add_format("item %d", 5);
+    worker_arena = &context_arena::this_thread();
+  }).join();
+  BOOST_CHECK(e.render() == "item 5: in worker: " + message);
+
+  // A later thread reuses the arena without its frames ever being mistaken for the old ones
+  const context_arena *reused = nullptr;
+  std::thread([&] {
+    context_arena &arena = context_arena::this_thread();
+    reused = &arena;
+    error_with_context<> other(std::make_error_code(std::errc::io_error), "other");
+    BOOST_CHECK(e.render() == "item 5: in worker: " + message);
+    for(uint32_t n = 0; n < arena.capacity(); n++)
+    {
+      other.add("other");
+    }
+  }).join();
+  BOOST_CHECK(reused == worker_arena);
+  BOOST_CHECK(e.render() == "...: " + message);
+
+  // Caller supplied arenas work the same way, and frames may be read while another thread overwrites them
+  context_arena arena(16);
+  error_with_context<> base(std::make_error_code(std::errc::broken_pipe));
+  base.add_format(arena, "frame %d", 1);
+  base = add_context_format(context_result<int>(base), arena, "frame %d", 2).error();
+  BOOST_CHECK(base.render() == "frame 2: frame 1: " + message);
+  std::atomic<bool> done{false};
+  std::atomic<int> bad{0};
+  std::thread reader([&] {
+    while(!done.load(std::memory_order_relaxed))
+    {
+      const std::string r = base.render();
+      if(r != "frame 2: frame 1: " + message && r != "...: " + message && r != "frame 2: ...: " + message)
+      {
+        ++bad;
+      }
+    }
+  });
+  for(int n = 0; n < 100000; n++)
+  {
+    arena.append_format(nullptr, 0, "overwrite %d", n);
+  }
+  done = true;
+  reader.join();
+  BOOST_CHECK(bad == 0);
+}
@@ -0,0 +1,125 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#define OUTCOME_ENABLE_ERROR_INJECTION 1
+#define OUTCOME_ENABLE_TELEMETRY 1
+
+#include "../../include/outcome/outcome.hpp"
+#include "../../include/outcome/try.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <string>
+#include <thread>
+
+namespace error_injection_test
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+
+  inline std::error_code injected_error() noexcept { return std::make_error_code(std::errc::resource_unavailable_try_again); }
+#if !defined(__cpp_noexcept_function_type) && defined(__cpp_exceptions)
+  // Only possible before C++ 17, when a function pointer cannot say it is noexcept
+  inline std::error_code throwing_error() { throw std::bad_alloc(); }
+#endif
+
+  QUICKCPPLIB_NOINLINE inline result<unsigned> leaf(unsigned v) { return v; }
+  QUICKCPPLIB_NOINLINE inline result<int> caller(unsigned v)
+  {
+    OUTCOME_TRY(x, leaf(v));
+    return static_cast<int>(x);
+  }
+}  // namespace error_injection_test
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / error_injection, "Tests that error injection converts successes into failures at the configured rate")
+{
+  using namespace error_injection_test;
+  // Nothing is injected until configured
+  for(unsigned n = 0; n < 1000; n++)
+  {
+    BOOST_CHECK(caller(n).value() == static_cast<int>(n));
+  }
+  // Always inject into result<unsigned>, which propagates to result<int>
+  error_injection::inject<result<unsigned>>(1.0, injected_error);
+  for(unsigned n = 0; n < 1000; n++)
+  {
+    auto r = caller(n);
+    BOOST_REQUIRE(r.has_error());
+    BOOST_CHECK(r.error() == std::errc::resource_unavailable_try_again);
+  }
+  // Only the configured type is affected
+  {
+    result<int> r(5);
+    BOOST_CHECK(r.value() == 5);
+    outcome<unsigned> o(5U);
+    BOOST_CHECK(o.value() == 5U);
+  }
+  // Roughly the configured rate, on every thread
+  error_injection::inject<result<unsigned>>(0.25, injected_error);
+  auto count_failures = [] {
+    unsigned failures = 0;
+    for(unsigned n = 0; n < 100000; n++)
+    {
+      failures += caller(n).has_error() ? 1 : 0;
+    }
+    return failures;
+  };
+  unsigned here = count_failures(), there = 0;
+  std::thread([&] { there = count_failures(); }).join();
+  BOOST_CHECK(here > 23000 && here < 27000);
+  BOOST_CHECK(there > 23000 && there < 27000);
+  // outcome can be injected into too
+  error_injection::inject<outcome<int>>(1.0, injected_error);
+  {
+    outcome<int> o(5);
+    BOOST_CHECK(o.has_error());
+    BOOST_CHECK(o.error() == std::errc::resource_unavailable_try_again);
+  }
+  error_injection::stop<outcome<int>>();
+#if !defined(__cpp_noexcept_function_type) && defined(__cpp_exceptions)
+  // A throwing factory skips the injection rather than terminating
+  error_injection::inject<result<unsigned>>(1.0, throwing_error);
+  BOOST_CHECK(caller(5).value() == 5);
+#endif
+  error_injection::stop<result<unsigned>>();
+  for(unsigned n = 0; n < 1000; n++)
+  {
+    BOOST_CHECK(caller(n).value() == static_cast<int>(n));
+  }
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / error_injection / telemetry, "Tests that an injected failure is counted as one construction")
+{
+  using namespace error_injection_test;
+  error_injection::inject<result<std::string>>(1.0, injected_error);
+  auto before = telemetry::snapshot();
+  for(unsigned n = 0; n < 10; n++)
+  {
+    // The value is destroyed in place, so must not leak
+    result<std::string> r(std::string(64, 'x'));
+    BOOST_CHECK(r.error() == std::errc::resource_unavailable_try_again);
+  }
+  auto after = telemetry::snapshot();
+  BOOST_CHECK(after.constructions() - before.constructions() == 10);
+  BOOST_CHECK(after.failures - before.failures == 10);
+  BOOST_CHECK(after.successes == before.successes);
+  error_injection::stop<result<std::string>>();
+}
@@ -0,0 +1,262 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include "../../include/outcome/error_list.hpp"
+#include "../../include/outcome/try.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// Count every allocation so the tests can check that up to N errors never touch the heap
+static size_t allocations, deallocations;
+void *operator new(size_t bytes)
+{
+  ++allocations;
+  if(void *p = malloc(bytes))
+  {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept
+{
+  deallocations += (p != nullptr) ? 1 : 0;
+  free(p);
+}
+void operator delete(void *p, size_t /*unused*/) noexcept
+{
+  deallocations += (p != nullptr) ? 1 : 0;
+  free(p);
+}
+
+namespace error_list_test
+{
+  namespace outcome = OUTCOME_V2_NAMESPACE;
+  using errors = outcome::error_list<std::error_code, 3>;
+
+  inline outcome::std_result<int> parse(int x)
+  {
+    if(x < 0)
+    {
+      return std::errc::invalid_argument;
+    }
+    return x;
+  }
+  // OUTCOME_TRY works with the first error only results of the individual operations
+  inline outcome::error_list_result<int, std::error_code> add(int a, int b)
+  {
+    OUTCOME_TRY(x, parse(a));
+    OUTCOME_TRY(y, parse(b));
+    return x + y;
+  }
+  // OUTCOME_TRY propagates every error of a list
+  inline outcome::error_list_result<int, std::error_code> add_twice(int a, int b)
+  {
+    OUTCOME_TRY(x, add(a, b));
+    return x * 2;
+  }
+  // Validates every field, reporting every invalid one
+  inline outcome::error_list_result<void, std::error_code> validate(int a, int b, int c)
+  {
+    errors e;
+    outcome::accumulate_errors(e, parse(a));
+    outcome::accumulate_errors(e, parse(b));
+    outcome::accumulate_errors(e, parse(c));
+    if(!e.empty())
+    {
+      return e;
+    }
+    return outcome::success();
+  }
+
+#ifdef __cpp_exceptions
+  // Counts its live instances, and throws from its copy constructor when a countdown reaches zero
+  struct throwing_error
+  {
+    static int live, copies_until_throw;
+    int v{0};
+    explicit throwing_error(int _v)
+        : v(_v)
+    {
+      ++live;
+    }
+    throwing_error(const throwing_error &o)
+        : v(o.v)
+    {
+      if(--copies_until_throw == 0)
+      {
+        throw std::runtime_error("copy");
+      }
+      ++live;
+    }
+    throwing_error(throwing_error &&o) noexcept : v(o.v) { ++live; }
+    throwing_error &operator=(const throwing_error &) = default;
+    ~throwing_error() { --live; }
+  };
+  int throwing_error::live, throwing_error::copies_until_throw;
+#endif
+}  // namespace error_list_test
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / error_list, "Tests that error_list accumulates errors without allocating in the common case")
+{
+  using namespace error_list_test;
+  const std::error_code einval = make_error_code(std::errc::invalid_argument), enoent = make_error_code(std::errc::no_such_file_or_directory);
+  static_assert(outcome::trait::is_error_type<errors>::value, "");
+  static_assert(outcome::trait::is_error_type_enum<errors, std::errc>::value, "");
+  static_assert(outcome::trait::is_error_code_available<errors>::value, "");
+  static_assert(sizeof(errors) == 3 * sizeof(std::error_code) + 2 * sizeof(unsigned), "");
+  static_assert(std::is_nothrow_move_constructible<errors>::value, "");
+  {
+    // Up to N errors live inline
+    allocations = 0;
+    errors e;
+    BOOST_CHECK(e.empty());
+    e.push_back(einval);
+    e.push_back(enoent);
+    e.emplace_back(EIO, std::generic_category());
+    BOOST_CHECK(e.size() == 3);
+    BOOST_CHECK(e.capacity() == 3);
+    errors f(std::move(e));
+    errors g(f);
+    g.swap(f);
+    BOOST_CHECK(allocations == 0);
+    BOOST_CHECK(g == f);
+    BOOST_CHECK(f[1] == enoent);
+    // The fourth spills all of them onto the heap
+    f.push_back(einval);
+    BOOST_CHECK(allocations == 1);
+    BOOST_CHECK(f.size() == 4);
+    BOOST_CHECK(f.front() == einval);
+    BOOST_CHECK(f[2] == std::errc::io_error);
+    BOOST_CHECK(f.back() == einval);
+    // Moving a spilled list steals its allocation
+    errors h(std::move(f));
+    BOOST_CHECK(allocations == 1);
+    BOOST_CHECK(h.size() == 4);
+    BOOST_CHECK(f.empty());
+    BOOST_CHECK(h != g);
+    // Lists of different inline capacity convert explicitly
+    outcome::error_list<std::error_code, 8> big(h);
+    BOOST_CHECK(big.size() == 4);
+    BOOST_CHECK(big.capacity() == 8);
+    BOOST_CHECK(big == h);
+  }
+  {
+    // Appending an error of the list itself copies it before growing moves and frees the errors
+    using strings = outcome::error_list<std::string, 2>;
+    const std::string a(64, 'a'), b(64, 'b');
+    strings l{a, b};
+    l.push_back(l[0]);  // inline to heap
+    BOOST_CHECK(l.capacity() == 4);
+    l.emplace_back(l[1]);
+    BOOST_CHECK(l.size() == 4);
+    l.push_back(l[3]);  // heap to heap
+    BOOST_CHECK(l.capacity() == 8);
+    BOOST_CHECK(l == (strings{a, b, a, b, b}));
+    strings m{a, b};
+    m.append(m);
+    BOOST_CHECK(m == (strings{a, b, a, b}));
+  }
+  {
+    // Implicit construction from a single error, or an error enum
+    allocations = 0;
+    outcome::error_list_result<int, std::error_code> r(einval), r2(std::errc::invalid_argument), r3(5);
+    BOOST_CHECK(r.error().size() == 1);
+    BOOST_CHECK(r.error() == r2.error());
+    BOOST_CHECK(r3.value() == 5);
+    BOOST_CHECK(allocations == 0);
+  }
+  {
+    BOOST_CHECK(add(1, 2).value() == 3);
+    BOOST_CHECK(add(-1, 2).error().front() == einval);
+    BOOST_CHECK(add_twice(1, 2).value() == 6);
+    BOOST_CHECK(add_twice(1, -2).error().size() == 1);
+    // Every invalid field is reported, without allocating
+    allocations = 0;
+    auto v = validate(-1, 2, -3);
+    BOOST_CHECK(allocations == 0);
+    BOOST_CHECK(v.error().size() == 2);
+    BOOST_CHECK(validate(1, 2, 3).has_value());
+  }
+  {
+    // Errors accumulate across batches of results, flattening lists of errors
+    std::vector<outcome::std_result<int>> batch1{parse(1), parse(-1), parse(2)}, batch2{parse(-2), parse(3), parse(-3)};
+    std::vector<int> values;
+    errors e;
+    auto r1 = outcome::collect(batch1.begin(), batch1.end(), std::back_inserter(values));
+    BOOST_CHECK(!outcome::accumulate_errors(e, std::move(r1)));
+    auto r2 = outcome::collect(batch2.begin(), batch2.end(), std::back_inserter(values));
+    BOOST_CHECK(!outcome::accumulate_errors(e, r2));
+    BOOST_CHECK(e.size() == 3);
+    BOOST_CHECK(values == (std::vector<int>{1, 2, 3}));
+    std::vector<outcome::error_list_result<void, std::error_code>> batch3{validate(-1, -2, -3), validate(1, 2, 3)};
+    auto r3 = outcome::collect(batch3.begin(), batch3.end(), values.end());
+    BOOST_REQUIRE(r3.has_error());
+    BOOST_CHECK(r3.error().size() == 3);
+    e.append(std::move(r3).error());
+    BOOST_CHECK(e.size() == 6);
+    std::vector<outcome::std_result<int>> batch4{parse(4), parse(5)};
+    auto r4 = outcome::collect(batch4.begin(), batch4.end(), std::back_inserter(values));
+    BOOST_CHECK(r4.has_value());
+    BOOST_CHECK(values.size() == 5);
+  }
+#ifdef __cpp_exceptions
+  {
+    // The default policy throws the first error
+    auto r = validate(1, -2, -3);
+    try
+    {
+      r.value();
+      BOOST_CHECK(false);
+    }
+    catch(const std::system_error &e)
+    {
+      BOOST_CHECK(e.code() == einval);
+    }
+  }
+  {
+    // A copy which throws partway through construction destroys the errors already copied, and frees their memory
+    using list = outcome::error_list<throwing_error, 3>;
+    list src;
+    for(int n = 0; n < 5; n++)
+    {
+      src.emplace_back(n);
+    }
+    BOOST_CHECK(throwing_error::live == 5);
+    const size_t unfreed = allocations - deallocations;
+    throwing_error::copies_until_throw = 4;
+    BOOST_CHECK_THROW(list{src}, std::runtime_error);
+    BOOST_CHECK(throwing_error::live == 5);
+    BOOST_CHECK(allocations - deallocations == unfreed);
+    throwing_error::copies_until_throw = 5;
+    BOOST_CHECK_THROW(list(outcome::error_list<throwing_error, 2>(src)), std::runtime_error);
+    BOOST_CHECK(throwing_error::live == 5);
+    BOOST_CHECK(allocations - deallocations == unfreed);
+    throwing_error::copies_until_throw = 0;
+  }
+  BOOST_CHECK(throwing_error::live == 0);
+#endif
+}
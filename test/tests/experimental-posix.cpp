@@ -0,0 +1,178 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef _WIN32
+#include "../../include/outcome/experimental/posix.hpp"
+#endif
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#ifndef _WIN32
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace experimental_posix_test
+{
+  // Exposes whether the error was marked as errno compatible
+  struct errno_policy : OUTCOME_V2_NAMESPACE::experimental::policy::status_code_throw<size_t, OUTCOME_V2_NAMESPACE::experimental::posix_code, void>
+  {
+    template <class Impl> static bool is_errno(Impl &&self) noexcept { return _has_error_is_errno(self); }
+  };
+
+  // Performs a batch of scattered writes then reads with the io_queue, checking every request completes
+  inline void check_io_queue(OUTCOME_V2_NAMESPACE::experimental::posix::io_queue &queue, int fd)
+  {
+    using namespace OUTCOME_V2_NAMESPACE::experimental;
+    static constexpr size_t count = 200;  // more than the queue depth, so several batches are submitted
+    std::vector<std::string> blocks(count), readback(count, std::string(16, ' '));
+    std::vector<struct iovec> iovs(count * 2);
+    std::vector<posix::io_request> requests(count);
+    for(size_t n = 0; n < count; n++)
+    {
+      blocks[n] = std::to_string(1000000000000000ULL + n);
+      iovs[n] = {&blocks[n][0], blocks[n].size()};
+      requests[n] = {posix::io_operation::write, fd, &iovs[n], 1, static_cast<off_t>(n * 16)};
+    }
+    std::vector<size_t> transferred(count, 0);
+    auto record = [&](size_t idx, posix_result<size_t> r) {
+      BOOST_REQUIRE(r.has_value());
+      transferred[idx] += r.value();
+    };
+    BOOST_CHECK(queue.submit(requests.data(), count, record));
+    for(size_t n = 0; n < count; n++)
+    {
+      BOOST_CHECK(transferred[n] == 16);
+      iovs[count + n] = {&readback[n][0], readback[n].size()};
+      requests[n] = {posix::io_operation::read, fd, &iovs[count + n], 1, static_cast<off_t>(n * 16)};
+    }
+    BOOST_CHECK(queue.submit(requests.data(), count, record));
+    for(size_t n = 0; n < count; n++)
+    {
+      BOOST_CHECK(transferred[n] == 32);
+      BOOST_CHECK(readback[n] == blocks[n]);
+    }
+    // Each request's failure is reported against that request only
+    char c;
+    struct iovec iov = {&c, 1};
+    posix::io_request bad[2] = {{posix::io_operation::read, -1, &iov, 1, 0}, {posix::io_operation::read, fd, &iov, 1, 0}};
+    int failures = 0, successes = 0;
+    BOOST_CHECK(queue.submit(bad, 2, [&](size_t idx, posix_result<size_t> r) {
+      if(idx == 0)
+      {
+        BOOST_CHECK(r.has_error());
+        BOOST_CHECK(r.error() == errc::bad_file_descriptor);
+        ++failures;
+      }
+      else
+      {
+        BOOST_CHECK(r.value() == 1);
+        ++successes;
+      }
+    }));
+    BOOST_CHECK(failures == 1);
+    BOOST_CHECK(successes == 1);
+  }
+}  // namespace experimental_posix_test
+#endif
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / experimental / posix, "Tests the errno native POSIX i/o wrappers")
+{
+#ifndef _WIN32
+  using namespace OUTCOME_V2_NAMESPACE::experimental;
+  using namespace experimental_posix_test;
+  {
+    // Failures are errno compatible posix_code
+    auto r = posix::open("shouldneverexistnotever", O_RDONLY);
+    BOOST_CHECK(r.has_error());
+    BOOST_CHECK(r.error() == errc::no_such_file_or_directory);
+    OUTCOME_V2_NAMESPACE::basic_result<size_t, posix_code, errno_policy> r2(posix::read(-1, nullptr, 0));
+    BOOST_CHECK(r2.error() == errc::bad_file_descriptor);
+    BOOST_CHECK(errno_policy::is_errno(r2));
+  }
+  char path[] = "/tmp/outcome_posix_XXXXXX";
+  int fd = mkstemp(path);
+  BOOST_REQUIRE(fd != -1);
+  (void) unlink(path);
+  {
+    // Contiguous and vectored i/o
+    BOOST_CHECK(posix::write(fd, "hello", 5).value() == 5);
+    char a[] = " big", b[] = " world";
+    struct iovec iov[2] = {{a, 4}, {b, 6}};
+    BOOST_CHECK(posix::writev(fd, iov, 2).value() == 10);
+    BOOST_CHECK(posix::pwrite(fd, "H", 1, 0).value() == 1);
+    char buffer[32] = "";
+    BOOST_CHECK(posix::pread(fd, buffer, sizeof(buffer), 0).value() == 15);
+    BOOST_CHECK(std::string(buffer, 15) == "Hello big world");
+    char c[5] = "", d[10] = "";
+    struct iovec riov[2] = {{c, 5}, {d, 10}};
+    BOOST_CHECK(posix::preadv(fd, riov, 2, 0).value() == 15);
+    BOOST_CHECK(std::string(d, 10) == " big world");
+#if defined(__linux__) && defined(RWF_NOWAIT)
+    memset(d, 0, sizeof(d));
+    auto r = posix::preadv2(fd, riov, 2, 0, 0);
+    BOOST_CHECK(r.value() == 15);
+    BOOST_CHECK(std::string(d, 10) == " big world");
+#endif
+  }
+  {
+    // Socket i/o, including batched messages where available
+    int sv[2];
+    BOOST_REQUIRE(0 == socketpair(AF_UNIX, SOCK_DGRAM, 0, sv));
+    BOOST_CHECK(posix::send(sv[0], "ping", 4).value() == 4);
+    char buffer[8] = "";
+    BOOST_CHECK(posix::recv(sv[1], buffer, sizeof(buffer)).value() == 4);
+    BOOST_CHECK(std::string(buffer, 4) == "ping");
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+    char m0[] = "one", m1[] = "two", r0[8], r1[8];
+    struct iovec siov[2] = {{m0, 3}, {m1, 3}}, riov[2] = {{r0, 8}, {r1, 8}};
+    struct mmsghdr smsgs[2], rmsgs[2];
+    memset(smsgs, 0, sizeof(smsgs));
+    memset(rmsgs, 0, sizeof(rmsgs));
+    for(int n = 0; n < 2; n++)
+    {
+      smsgs[n].msg_hdr.msg_iov = &siov[n];
+      smsgs[n].msg_hdr.msg_iovlen = 1;
+      rmsgs[n].msg_hdr.msg_iov = &riov[n];
+      rmsgs[n].msg_hdr.msg_iovlen = 1;
+    }
+    BOOST_CHECK(posix::sendmmsg(sv[0], smsgs, 2).value() == 2);
+    BOOST_CHECK(posix::recvmmsg(sv[1], rmsgs, 2).value() == 2);
+    BOOST_CHECK(rmsgs[1].msg_len == 3);
+    BOOST_CHECK(std::string(r1, 3) == "two");
+#endif
+    BOOST_CHECK(posix::close(sv[0]));
+    BOOST_CHECK(posix::close(sv[1]));
+    BOOST_CHECK(posix::close(sv[0]).error() == errc::bad_file_descriptor);
+  }
+  {
+    // Batched submission, synchronously and through io_uring if the kernel permits it
+    posix::io_queue sync(16, false);
+    BOOST_CHECK(!sync.uses_io_uring());
+    check_io_queue(sync, fd);
+    posix::io_queue ring(16);
+    std::cout << "io_queue uses io_uring = " << ring.uses_io_uring() << std::endl;
+    check_io_queue(ring, fd);
+  }
+  BOOST_CHECK(posix::close(fd));
+#endif
+}
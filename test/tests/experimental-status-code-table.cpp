@@ -0,0 +1,169 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include "../../include/outcome/experimental/status_code_table.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <cstring>
+
+namespace status_code_table_test
+{
+  namespace experimental = OUTCOME_V2_NAMESPACE::experimental;
+  using experimental::errc;
+
+  // Deliberately out of order, signed and with holes
+  enum class http_errc : int
+  {
+    continue_ = -1,
+    ok = 0,
+    bad_request = 400,
+    forbidden = 403,
+    not_found = 404,
+    timeout = 408,
+    internal_error = 500,
+  };
+  struct http_errc_traits
+  {
+    using value_type = http_errc;
+    static constexpr unsigned long long id = 0x7f0b3c2e5d4a9811;
+    static constexpr const char *name() noexcept { return "http error domain"; }
+    static constexpr auto table() noexcept
+    {
+      return experimental::make_status_code_table<http_errc>({
+      {http_errc::not_found, "not found", errc::no_such_file_or_directory, true},        //
+      {http_errc::ok, "ok", errc::success, false},                                       //
+      {http_errc::continue_, "continue", errc::success, false},                          //
+      {http_errc::bad_request, "bad request", errc::invalid_argument, true},             //
+      {http_errc::forbidden, "forbidden", errc::permission_denied, true},                //
+      {http_errc::timeout, "timeout", errc::timed_out, true},                            //
+      {http_errc::internal_error, "internal server error", errc::unknown, true},         //
+      });
+    }
+  };
+  using http_code = experimental::table_status_code<http_errc_traits>;
+
+  inline http_code make_status_code(http_errc c) { return http_code(experimental::in_place, c); }
+}  // namespace status_code_table_test
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / experimental / status_code_table, "Tests that a status code domain generated from a table behaves as a hand written one")
+{
+  using namespace status_code_table_test;
+  using OUTCOME_V2_NAMESPACE::experimental::generic_code;
+  using OUTCOME_V2_NAMESPACE::experimental::system_code;
+  // The domain, including its dense table, is built at compile time
+  constexpr const auto &domain = experimental::table_status_code_domain<http_errc_traits>::get();
+  static_assert(sizeof(domain) > 500 * sizeof(const char *), "");
+  BOOST_CHECK(0 == strcmp(domain.name().c_str(), "http error domain"));
+
+  http_code nf(http_errc::not_found), ok(http_errc::ok), cont(http_errc::continue_), ise(http_errc::internal_error);
+  BOOST_CHECK(nf.failure());
+  BOOST_CHECK(!ok.failure());
+  BOOST_CHECK(!cont.failure());
+  BOOST_CHECK(0 == strcmp(nf.message().c_str(), "not found"));
+  BOOST_CHECK(0 == strcmp(cont.message().c_str(), "continue"));
+  BOOST_CHECK(0 == strcmp(ise.message().c_str(), "internal server error"));
+  // Values missing from the table are unknown failures
+  http_code hole(static_cast<http_errc>(401)), outside(static_cast<http_errc>(600));
+  BOOST_CHECK(hole.failure());
+  BOOST_CHECK(0 == strcmp(hole.message().c_str(), "unknown"));
+  BOOST_CHECK(outside.failure());
+  BOOST_CHECK(0 == strcmp(outside.message().c_str(), "unknown"));
+
+  // Equivalence is by value within the domain, and by the table's generic mapping otherwise
+  BOOST_CHECK(nf == http_code(http_errc::not_found));
+  BOOST_CHECK(nf != http_code(http_errc::forbidden));
+  BOOST_CHECK(nf == errc::no_such_file_or_directory);
+  BOOST_CHECK(http_code(http_errc::forbidden) == errc::permission_denied);
+  BOOST_CHECK(nf != errc::permission_denied);
+  BOOST_CHECK(ise != errc::unknown);
+  BOOST_CHECK(hole != errc::unknown);
+  BOOST_CHECK(generic_code(errc::timed_out) == http_code(http_errc::timeout));
+  BOOST_CHECK(nf == experimental::posix_code(ENOENT));
+
+  // Type erasure works as for any other domain
+  system_code sc(nf);
+  BOOST_CHECK(sc.domain() == domain);
+  BOOST_CHECK(sc == errc::no_such_file_or_directory);
+  BOOST_CHECK(0 == strcmp(sc.message().c_str(), "not found"));
+
+  // Usable with status_result
+  experimental::status_result<int, http_code> r(nf);
+  BOOST_CHECK(r.error() == errc::no_such_file_or_directory);
+#ifdef __cpp_exceptions
+  try
+  {
+    r.value();
+    BOOST_CHECK(false);
+  }
+  catch(const experimental::status_error<experimental::table_status_code_domain<http_errc_traits>> &e)
+  {
+    BOOST_CHECK(e.code() == http_errc::not_found);
+    BOOST_CHECK(0 == strcmp(e.what(), "not found"));
+  }
+#endif
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / experimental / status_code_table_static, "Tests that a table generated domain can be used without virtual dispatch")
+{
+  using namespace status_code_table_test;
+  using domain_type = experimental::table_status_code_domain<http_errc_traits>;
+  static_assert(std::is_final<domain_type>::value, "");
+  constexpr const auto &domain = domain_type::get();
+  static_assert(domain.failure(http_errc::not_found), "");
+  static_assert(!domain.failure(http_errc::ok), "");
+  static_assert(domain.failure(static_cast<http_errc>(401)), "");
+  static_assert(domain.generic(http_errc::forbidden) == errc::permission_denied, "");
+  static_assert(domain.generic(static_cast<http_errc>(-5)) == errc::unknown, "");
+  static_assert(domain.equivalent(http_errc::timeout, errc::timed_out), "");
+  static_assert(!domain.equivalent(http_errc::internal_error, errc::unknown), "");
+  static_assert(domain.message(http_errc::bad_request)[0] == 'b', "");
+
+  // The statically dispatched observers agree with the virtual ones
+  const http_errc values[] = {http_errc::continue_, http_errc::ok, http_errc::not_found, http_errc::internal_error, static_cast<http_errc>(401), static_cast<http_errc>(9999)};
+  for(auto v : values)
+  {
+    http_code c(v);
+    BOOST_CHECK(c.domain().failure(c.value()) == c.failure());
+    BOOST_CHECK(0 == strcmp(c.domain().message(c.value()), c.message().c_str()));
+    BOOST_CHECK(c.domain().equivalent(c.value(), errc::no_such_file_or_directory) == (c == errc::no_such_file_or_directory));
+    BOOST_CHECK(experimental::static_dispatch::failure(c) == c.failure());
+    BOOST_CHECK(0 == strcmp(experimental::static_dispatch::message(c), c.message().c_str()));
+  }
+
+  // As do those for the POSIX and generic domains
+  const int errnos[] = {0, ENOENT, EINVAL, ETIMEDOUT, EAGAIN};
+  for(int v : errnos)
+  {
+    experimental::posix_code p(v);
+    experimental::generic_code g(static_cast<errc>(v));
+    BOOST_CHECK(experimental::static_dispatch::failure(p) == p.failure());
+    BOOST_CHECK(experimental::static_dispatch::failure(g) == g.failure());
+    BOOST_CHECK(experimental::static_dispatch::generic(p) == static_cast<errc>(v));
+    BOOST_CHECK(experimental::static_dispatch::generic(g) == static_cast<errc>(v));
+    BOOST_CHECK(experimental::static_dispatch::equivalent(p, errc::timed_out) == (p == errc::timed_out));
+    BOOST_CHECK(experimental::static_dispatch::equivalent(g, errc::timed_out) == (g == errc::timed_out));
+    BOOST_CHECK(0 == strcmp(experimental::static_dispatch::message(g), g.message().c_str()));
+  }
+  static_assert(!experimental::static_dispatch::failure(experimental::generic_code(errc::success)), "");
+  static_assert(experimental::static_dispatch::equivalent(experimental::generic_code(errc::timed_out), errc::timed_out), "");
+}
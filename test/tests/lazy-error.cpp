@@ -0,0 +1,115 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include "../../include/outcome.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <cerrno>
+
+namespace lazy_error_test
+{
+  // Trivially copyable and destructible, with a default constructor which counts its calls
+  struct counted_error
+  {
+    static int defaults;
+    int code;
+    counted_error() noexcept
+        : code(0)
+    {
+      ++defaults;
+    }
+    explicit counted_error(int c) noexcept
+        : code(c)
+    {
+    }
+    bool operator==(const counted_error &o) const noexcept { return code == o.code; }
+    bool operator!=(const counted_error &o) const noexcept { return code != o.code; }
+  };
+  int counted_error::defaults;
+
+  // Exposes whether the error was classified as errno compatible
+  struct errno_policy : OUTCOME_V2_NAMESPACE::policy::all_narrow
+  {
+    template <class Impl> static bool is_errno(Impl &&self) noexcept { return _has_error_is_errno(self); }
+  };
+}  // namespace lazy_error_test
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / result / lazy_error, "Tests that errors with non-trivial default constructors are constructed only when there is one")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  using namespace lazy_error_test;
+  static_assert(detail::error_is_lazily_constructed<counted_error>::value, "");
+  static_assert(detail::error_is_lazily_constructed<std::error_code>::value, "");
+  static_assert(!detail::error_is_lazily_constructed<int>::value, "");
+  static_assert(!detail::error_is_lazily_constructed<std::exception_ptr>::value, "");
+  using result_type = basic_result<int, counted_error, policy::all_narrow>;
+  using outcome_type = basic_outcome<int, counted_error, std::exception_ptr, policy::all_narrow>;
+  counted_error::defaults = 0;
+  {
+    result_type a(5), b(counted_error(3));
+    result_type c(a), d(std::move(b));
+    BOOST_CHECK(c == a);
+    BOOST_CHECK(d.error().code == 3);
+    BOOST_CHECK(a != d);
+    c = d;
+    BOOST_CHECK(c == d);
+    // Swapping moves the error into the storage which had the value
+    a.swap(d);
+    BOOST_CHECK(a.error().code == 3);
+    BOOST_CHECK(d.value() == 5);
+    a.swap(d);
+    BOOST_CHECK(a.value() == 5);
+    BOOST_CHECK(d.error().code == 3);
+    // Conversions only construct an error if there is one
+    basic_result<long, counted_error, policy::all_narrow> e(a), f(d);
+    BOOST_CHECK(e.value() == 5);
+    BOOST_CHECK(f.error().code == 3);
+  }
+  {
+    outcome_type a(5), b(counted_error(3)), c(std::make_exception_ptr(5)), d(counted_error(4), std::make_exception_ptr(6));
+    a.swap(b);
+    BOOST_CHECK(a.error().code == 3);
+    BOOST_CHECK(b.value() == 5);
+    a.swap(c);
+    BOOST_CHECK(a.has_exception() && !a.has_error());
+    BOOST_CHECK(c.error().code == 3);
+    c.swap(d);
+    BOOST_CHECK(c.error().code == 4);
+    BOOST_CHECK(c.has_exception());
+    BOOST_CHECK(d.error().code == 3);
+    outcome_type e(result_type(7));
+    BOOST_CHECK(e.value() == 7);
+  }
+  BOOST_CHECK(counted_error::defaults == 0);
+  {
+    // std::error_code errors in the generic and system categories are classified as errno compatible
+    using errno_result = basic_result<int, std::error_code, errno_policy>;
+    errno_result a(5), b(make_error_code(std::errc::invalid_argument)), c(std::error_code(EINVAL, std::system_category())), d(std::error_code(1, std::iostream_category()));
+    BOOST_CHECK(!errno_policy::is_errno(a));
+    BOOST_CHECK(errno_policy::is_errno(b));
+#ifndef _WIN32
+    BOOST_CHECK(errno_policy::is_errno(c));
+#endif
+    BOOST_CHECK(!errno_policy::is_errno(d));
+  }
+}
@@ -0,0 +1,170 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include "../../include/outcome.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <string>
+
+namespace monadic_test
+{
+  // Counts copies and moves of the payload
+  struct counted
+  {
+    static int copies, moves;
+    int v{0};
+    counted() = default;
+    explicit counted(int _v)
+        : v(_v)
+    {
+    }
+    counted(const counted &o)
+        : v(o.v)
+    {
+      ++copies;
+    }
+    counted(counted &&o) noexcept : v(o.v) { ++moves; }
+    counted &operator=(const counted &) = default;
+    counted &operator=(counted &&) = default;
+  };
+  int counted::copies, counted::moves;
+
+  template <class T> using result = OUTCOME_V2_NAMESPACE::result<T>;
+  template <class T> using outcome = OUTCOME_V2_NAMESPACE::outcome<T>;
+
+  inline result<counted> step(counted v)
+  {
+    if(v.v < 0)
+    {
+      return std::errc::result_out_of_range;
+    }
+    return v;
+  }
+  inline counted increment(counted v) { return counted(v.v + 1); }
+
+  inline outcome<int> parse(const std::string &s)
+  {
+    if(s.empty())
+    {
+      return std::errc::invalid_argument;
+    }
+    if(s == "!")
+    {
+      return std::make_exception_ptr(std::runtime_error("bang"));
+    }
+    return static_cast<int>(s.size());
+  }
+  inline outcome<std::string> twice(int n)
+  {
+    if(n > 3)
+    {
+      return std::errc::result_out_of_range;
+    }
+    return std::string(2 * n, 'x');
+  }
+}  // namespace monadic_test
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / result / monadic, "Tests that the monadic operations of result work as intended")
+{
+  using namespace monadic_test;
+  using OUTCOME_V2_NAMESPACE::failure;
+  {
+    // Result types are rebound to what the callable returns
+    result<int> a(5);
+    auto b = a.map([](int x) { return x * 2.0; });
+    static_assert(std::is_same<decltype(b), result<double>>::value, "");
+    BOOST_CHECK(b.value() == 10.0);
+    auto c = a.and_then([](int x) -> result<std::string> { return std::string(static_cast<size_t>(x), 'x'); });
+    BOOST_CHECK(c.value() == "xxxxx");
+    auto d = a.map([](int) {});
+    static_assert(std::is_same<decltype(d), result<void>>::value, "");
+    BOOST_CHECK(d.has_value());
+    auto e = d.map([] { return 3; });
+    BOOST_CHECK(e.value() == 3);
+    BOOST_CHECK(a.or_else([](std::error_code) -> result<int> { return 7; }).value() == 5);
+  }
+  {
+    // Errors propagate past map and and_then, and are handled by or_else and map_error
+    result<int> a(std::errc::invalid_argument);
+    bool called = false;
+    auto b = a.map([&](int x) {
+      called = true;
+      return x;
+    });
+    auto c = std::move(b).and_then([&](int x) -> result<int> {
+      called = true;
+      return x;
+    });
+    BOOST_CHECK(!called);
+    BOOST_CHECK(c.error() == std::errc::invalid_argument);
+    auto d = c.map_error([](std::error_code ec) { return static_cast<long>(ec.value()); });
+    BOOST_CHECK(d.error() == static_cast<long>(std::errc::invalid_argument));
+    BOOST_CHECK(c.or_else([](std::error_code) -> result<int> { return 7; }).value() == 7);
+    BOOST_CHECK(c.or_else([](std::error_code ec) -> result<int> { return failure(ec); }).error() == std::errc::invalid_argument);
+    BOOST_CHECK(c.value_or(9) == 9);
+    BOOST_CHECK(result<int>(4).value_or(9) == 4);
+  }
+  {
+    // A pipeline of rvalues moves the payload no more than equivalent hand written code
+    counted::copies = counted::moves = 0;
+    auto r = step(counted(1)).and_then(step).map(increment).and_then(step).map(increment).and_then(step);
+    BOOST_CHECK(r.value().v == 3);
+    BOOST_CHECK(counted::copies == 0);
+    // One move out of step(), two per and_then(), one per map()
+    BOOST_CHECK(counted::moves == 1 + 3 * 2 + 2 * 1);
+    counted::copies = counted::moves = 0;
+    auto r2 = std::move(r).value_or(counted(0));
+    BOOST_CHECK(r2.v == 3);
+    BOOST_CHECK(counted::copies == 0);
+    BOOST_CHECK(counted::moves == 1);
+    // Lvalues are copied, never moved from
+    counted::copies = counted::moves = 0;
+    auto r3 = r.map([](const counted &v) { return v.v; });
+    BOOST_CHECK(r3.value() == 3);
+    BOOST_CHECK(r.value().v == 3);
+    BOOST_CHECK(counted::copies == 0);
+    BOOST_CHECK(counted::moves == 0);
+  }
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / outcome / monadic, "Tests that the monadic operations of outcome work as intended")
+{
+  using namespace monadic_test;
+  auto a = parse("ab").map([](int x) { return x * 10; });
+  static_assert(std::is_same<decltype(a), outcome<int>>::value, "");
+  BOOST_CHECK(a.value() == 20);
+  auto b = parse("abc").and_then(twice).map([](const std::string &s) { return s.size(); });
+  static_assert(std::is_same<decltype(b), outcome<size_t>>::value, "");
+  BOOST_CHECK(b.value() == 6);
+  BOOST_CHECK(parse("abcd").and_then(twice).error() == std::errc::result_out_of_range);
+  // Exceptions propagate through every operation, as the callables only ever see the error
+  auto recover = [](std::error_code) -> outcome<int> { return 7; };
+  BOOST_CHECK(parse("").or_else(recover).value() == 7);
+  BOOST_CHECK(parse("!").or_else(recover).has_exception());
+  BOOST_CHECK(parse("!").and_then(twice).has_exception());
+  auto d = parse("").map_error([](std::error_code ec) { return static_cast<long>(ec.value()); });
+  BOOST_CHECK(d.error() == static_cast<long>(std::errc::invalid_argument));
+  BOOST_CHECK(parse("!").map_error([](std::error_code ec) { return static_cast<long>(ec.value()); }).has_exception());
+  BOOST_CHECK(parse("").value_or(-1) == -1);
+  BOOST_CHECK(parse("!").value_or(-1) == -1);
+}
@@ -0,0 +1,258 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include "../../include/outcome/result.hpp"
+#include "../../include/outcome/result_channel.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace result_channel_test
+{
+  struct counted
+  {
+    static int live;
+    std::string v;
+    explicit counted(std::string _v)
+        : v(std::move(_v))
+    {
+      ++live;
+    }
+    counted(counted &&o) noexcept : v(std::move(o.v)) { ++live; }
+    counted(const counted &) = delete;
+    counted &operator=(const counted &) = delete;
+    counted &operator=(counted &&) = delete;
+    ~counted() { --live; }
+  };
+  int counted::live;
+}  // namespace result_channel_test
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / result_channel / single_threaded, "Tests that result_channel queues values and that an error closes it")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  result_channel<int> ch(5, result_channel_wait::spin);
+  BOOST_CHECK(ch.capacity() == 8);
+  BOOST_CHECK(!ch.closed());
+  for(int n = 0; n < 8; n++)
+  {
+    BOOST_CHECK(ch.try_push(n));
+  }
+  BOOST_CHECK(!ch.try_push(8));
+  std::vector<int> got;
+  auto collect = [&](result<int> &&r) { got.push_back(r.value()); };
+  BOOST_CHECK(ch.try_pop(collect));
+  BOOST_CHECK(ch.try_pop_batch(3, collect) == 3);
+  BOOST_CHECK((got == std::vector<int>{0, 1, 2, 3}));
+  // Batches wrap around the ring
+  int more[] = {8, 9, 10, 11, 12};
+  BOOST_CHECK(ch.try_push_batch(more, 5) == 4);
+  BOOST_CHECK(ch.try_pop_batch(100, collect) == 8);
+  BOOST_CHECK((got == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+  BOOST_CHECK(!ch.try_pop(collect));
+
+  // An error closes the channel, and is seen exactly once after the remaining values
+  BOOST_CHECK(ch.push(20));
+  BOOST_CHECK(ch.push(21));
+  BOOST_CHECK(ch.push(std::errc::broken_pipe));
+  BOOST_CHECK(ch.closed());
+  BOOST_CHECK(!ch.push(22));
+  BOOST_CHECK(!ch.try_push(22));
+  BOOST_CHECK(!ch.close(std::make_error_code(std::errc::io_error)));
+  std::vector<result<int>> results;
+  auto keep = [&](result<int> &&r) { results.push_back(std::move(r)); };
+  BOOST_CHECK(ch.pop_batch(10, keep) == 2);
+  BOOST_CHECK(ch.pop(keep));
+  BOOST_CHECK(!ch.pop(keep));
+  BOOST_CHECK(!ch.try_pop(keep));
+  BOOST_CHECK(ch.pop_batch(10, keep) == 0);
+  BOOST_CHECK(results.size() == 3);
+  BOOST_CHECK(results[0].value() == 20);
+  BOOST_CHECK(results[1].value() == 21);
+  BOOST_CHECK(results[2].error() == std::errc::broken_pipe);
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / result_channel / nontrivial, "Tests that result_channel constructs and destroys nontrivial values correctly")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  using namespace result_channel_test;
+  counted::live = 0;
+  {
+    result_channel<counted> ch(4);
+    BOOST_CHECK(ch.push(counted("a")));
+    BOOST_CHECK(ch.push(counted("b")));
+    BOOST_CHECK(ch.push(counted("c")));
+    BOOST_CHECK(counted::live == 3);
+    std::string s;
+    BOOST_CHECK(ch.pop([&](result<counted> &&r) { s = r.value().v; }));
+    BOOST_CHECK(s == "a");
+    BOOST_CHECK(counted::live == 2);
+    // Closing without an error ends the channel once drained
+    BOOST_CHECK(ch.close());
+    BOOST_CHECK(ch.pop([&](result<counted> &&r) { s = r.value().v; }));
+    BOOST_CHECK(s == "b");
+  }
+  // The value left in the channel was destroyed with it
+  BOOST_CHECK(counted::live == 0);
+  {
+    // As is an error which nobody consumed
+    result_channel<int, std::string, policy::all_narrow> ch(4);
+    BOOST_CHECK(ch.close(std::string(100, 'x')));
+  }
+#ifdef __cpp_exceptions
+  {
+    // A consumer which throws part way through a batch loses the rest of the batch, but the slots
+    // are released for producers and no value leaks
+    result_channel<counted> ch(4, result_channel_wait::spin);
+    for(const char *v : {"a", "b", "c", "d"})
+    {
+      BOOST_CHECK(ch.try_push(counted(v)));
+    }
+    int calls = 0;
+    try
+    {
+      ch.try_pop_batch(4, [&](result<counted> &&r) {
+        if(++calls == 2)
+        {
+          throw std::runtime_error(r.value().v);
+        }
+      });
+      BOOST_CHECK(false);
+    }
+    catch(const std::runtime_error &e)
+    {
+      BOOST_CHECK(std::string(e.what()) == "b");
+    }
+    BOOST_CHECK(calls == 2);
+    BOOST_CHECK(counted::live == 0);
+    for(const char *v : {"e", "f", "g", "h"})
+    {
+      BOOST_CHECK(ch.try_push(counted(v)));
+    }
+    std::string s;
+    BOOST_CHECK(ch.try_pop_batch(4, [&](result<counted> &&r) { s += r.value().v; }) == 4);
+    BOOST_CHECK(s == "efgh");
+  }
+  BOOST_CHECK(counted::live == 0);
+#endif
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / result_channel / unchanged, "Tests that result_channel delivers the results pushed, not new ones constructed from them")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  using result_type = basic_result<int, long, policy::all_narrow>;
+  result_channel<int, long, policy::all_narrow> ch(4, result_channel_wait::spin);
+  // Spare storage would be lost by constructing a new result
+  result_type v(in_place_type<int>, 5), e(in_place_type<long>, 6);
+  hooks::set_spare_storage(&v, 0x55);
+  hooks::set_spare_storage(&e, 0x66);
+  BOOST_CHECK(ch.push(std::move(v)));
+  int more[] = {7};
+  BOOST_CHECK(ch.try_push_batch(more, 1) == 1);
+  BOOST_CHECK(ch.push(std::move(e)));
+  std::vector<result_type> got;
+  while(ch.pop([&](result_type &&r) { got.push_back(std::move(r)); }))
+  {
+  }
+  BOOST_REQUIRE(got.size() == 3);
+  BOOST_CHECK(got[0].value() == 5);
+  BOOST_CHECK(hooks::spare_storage(&got[0]) == 0x55);
+  BOOST_CHECK(got[1].value() == 7);
+  BOOST_CHECK(got[2].error() == 6);
+  BOOST_CHECK(hooks::spare_storage(&got[2]) == 0x66);
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / result_channel / threaded, "Tests that result_channel is a correct MPMC queue with each wait strategy")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  const result_channel_wait strategies[] = {result_channel_wait::spin, result_channel_wait::yield, result_channel_wait::block};
+  const unsigned threads = (std::thread::hardware_concurrency() >= 4) ? 4 : 2;
+  for(auto strategy : strategies)
+  {
+    if(strategy == result_channel_wait::spin && std::thread::hardware_concurrency() < 2 * threads)
+    {
+      // Spinning only makes progress when every thread has a core of its own
+      continue;
+    }
+    static constexpr int per_producer = 100000;
+    result_channel<int> ch(64, strategy);
+    std::vector<std::thread> producers, consumers;
+    std::atomic<long long> sum{0};
+    std::atomic<int> values{0}, errors{0};
+    for(unsigned t = 0; t < threads; t++)
+    {
+      producers.emplace_back([&, t] {
+        int batch[8];
+        for(int n = 0; n < per_producer; n += 8)
+        {
+          for(int i = 0; i < 8; i++)
+          {
+            batch[i] = n + i + 1;
+          }
+          // Alternate single and batch pushes
+          if((n / 8 + t) % 2 == 0)
+          {
+            BOOST_CHECK(ch.push_batch(batch, 8) == 8);
+          }
+          else
+          {
+            for(int i = 0; i < 8; i++)
+            {
+              BOOST_CHECK(ch.push(batch[i]));
+            }
+          }
+        }
+      });
+      consumers.emplace_back([&, t] {
+        auto f = [&](result<int> &&r) {
+          if(r)
+          {
+            sum += r.value();
+            ++values;
+          }
+          else
+          {
+            ++errors;
+          }
+        };
+        while((t % 2 == 0) ? ch.pop(f) : (ch.pop_batch(16, f) > 0))
+        {
+        }
+      });
+    }
+    for(auto &t : producers)
+    {
+      t.join();
+    }
+    BOOST_CHECK(ch.push(std::errc::operation_canceled));
+    for(auto &t : consumers)
+    {
+      t.join();
+    }
+    BOOST_CHECK(values == per_producer * static_cast<int>(threads));
+    BOOST_CHECK(sum == static_cast<long long>(threads) * per_producer * (per_producer + 1) / 2);
+    BOOST_CHECK(errors == 1);
+  }
+}
@@ -0,0 +1,92 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include "../../include/outcome/result.hpp"
+#include "../../include/outcome/policy/sampled_narrow.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <cstring>
+#include <thread>
+
+#ifdef __cpp_exceptions
+namespace sampled_narrow_test
+{
+  struct violation
+  {
+    const char *what;
+  };
+  inline void throwing_handler(const char *what) { throw violation{what}; }
+}  // namespace sampled_narrow_test
+#endif
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / policy / sampled_narrow, "Tests that the sampled_narrow policy checks one in every N wide observations")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  using checked = result<int, std::error_code, policy::sampled_narrow<4>>;
+  // Correct use behaves the same as all_narrow
+  {
+    checked a(5), b(std::make_error_code(std::errc::timed_out));
+    int total = 0;
+    for(int n = 0; n < 100; n++)
+    {
+      total += a.value();
+      BOOST_CHECK(b.error() == std::errc::timed_out);
+    }
+    BOOST_CHECK(total == 500);
+  }
+#ifdef __cpp_exceptions
+  using namespace sampled_narrow_test;
+  auto *old = policy::set_sampled_check_violation_handler(throwing_handler);
+  // A new thread's first wide observation is always checked, and then every fourth thereafter
+  std::thread([] {
+    checked a(5), b(std::make_error_code(std::errc::timed_out));
+    const char *what = nullptr;
+    try
+    {
+      (void) b.value();
+    }
+    catch(const violation &e)
+    {
+      what = e.what;
+    }
+    BOOST_REQUIRE(what != nullptr);
+    BOOST_CHECK(strcmp(what, "no value") == 0);
+    // Three unchecked observations
+    BOOST_CHECK(a.value() == 5);
+    BOOST_CHECK(a.value() == 5);
+    BOOST_CHECK(a.value() == 5);
+    what = nullptr;
+    try
+    {
+      (void) a.error();
+    }
+    catch(const violation &e)
+    {
+      what = e.what;
+    }
+    BOOST_REQUIRE(what != nullptr);
+    BOOST_CHECK(strcmp(what, "no error") == 0);
+  }).join();
+  BOOST_CHECK(policy::set_sampled_check_violation_handler(old) == &throwing_handler);
+#endif
+}
@@ -0,0 +1,116 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include "../../include/outcome/std_expected.hpp"
+#include "../../include/outcome/std_result.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+#include <string>
+
+namespace std_expected_test
+{
+  // Counts copies and moves of the payload
+  struct counted
+  {
+    static int copies, moves;
+    int v{0};
+    counted() = default;
+    explicit counted(int _v)
+        : v(_v)
+    {
+    }
+    counted(const counted &o)
+        : v(o.v)
+    {
+      ++copies;
+    }
+    counted(counted &&o) noexcept : v(o.v) { ++moves; }
+    counted &operator=(const counted &) = default;
+    counted &operator=(counted &&) = default;
+  };
+  int counted::copies, counted::moves;
+
+  inline std::expected<counted, std::string> parse(int x)
+  {
+    if(x < 0)
+    {
+      return std::unexpected<std::string>("negative");
+    }
+    return counted(x);
+  }
+  inline std::expected<int, std::string> parse_and_add(int x)
+  {
+    OUTCOME_TRY(v, parse(x));
+    return v.v + 1;
+  }
+}  // namespace std_expected_test
+#endif
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / result / std_expected, "Tests that result converts to and from std::expected by moving")
+{
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+  using namespace OUTCOME_V2_NAMESPACE;
+  using namespace std_expected_test;
+  using result_type = basic_result<counted, std::string, policy::all_narrow>;
+  static_assert(std::is_constructible<result_type, std::expected<counted, std::string> &&>::value, "");
+  static_assert(!std::is_constructible<result_type, std::expected<counted, std::string> &>::value, "");
+  static_assert(!std::is_constructible<result_type, const std::expected<counted, std::string> &>::value, "");
+  {
+    // Each direction moves the payload exactly once
+    auto e = parse(5);
+    counted::copies = counted::moves = 0;
+    result_type r(std::move(e));
+    BOOST_CHECK(r.has_value());
+    BOOST_CHECK(r.value().v == 5);
+    BOOST_CHECK(counted::copies == 0);
+    BOOST_CHECK(counted::moves == 1);
+    std::expected<counted, std::string> e2 = to_expected(std::move(r));
+    BOOST_CHECK(e2.has_value());
+    BOOST_CHECK(e2->v == 5);
+    BOOST_CHECK(counted::copies == 0);
+    BOOST_CHECK(counted::moves == 2);
+  }
+  {
+    result_type r(parse(-1));
+    BOOST_CHECK(r.has_error());
+    BOOST_CHECK(r.error() == "negative");
+    auto e = to_expected(std::move(r));
+    BOOST_CHECK(!e.has_value());
+    BOOST_CHECK(e.error() == "negative");
+  }
+  {
+    // void values and compatible types
+    basic_result<void, std::string, policy::all_narrow> r(std::expected<void, std::string>{});
+    BOOST_CHECK(r.has_value());
+    BOOST_CHECK(to_expected(std::move(r)).has_value());
+    std_result<long> r2(std::expected<int, std::error_code>{std::unexpect, std::make_error_code(std::errc::invalid_argument)});
+    BOOST_CHECK(r2.error() == std::errc::invalid_argument);
+  }
+  {
+    // OUTCOME_TRY propagates the unexpected
+    BOOST_CHECK(parse_and_add(3).value() == 4);
+    BOOST_CHECK(parse_and_add(-3).error() == "negative");
+  }
+#endif
+}
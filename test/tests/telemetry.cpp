@@ -0,0 +1,134 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#define OUTCOME_ENABLE_TELEMETRY 1
+
+#include "../../include/outcome/outcome.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <cstring>
+#include <thread>
+
+namespace telemetry_test
+{
+  enum class c_errc
+  {
+    success,
+    failure1,
+    failure2
+  };
+
+  inline uint64_t count_of(const OUTCOME_V2_NAMESPACE::telemetry::counts &c, const void *category, intptr_t value)
+  {
+    for(auto &i : c.by_error)
+    {
+      if(i.key.category == category && i.key.value == value)
+      {
+        return i.count;
+      }
+    }
+    return 0;
+  }
+}  // namespace telemetry_test
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / telemetry / counts, "Tests that telemetry counts constructions, failures by category and conversions")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  using namespace telemetry_test;
+  const void *generic = &std::generic_category();
+  auto before = telemetry::snapshot();
+  {
+    result<int> a(5);
+    result<int> b(std::error_code(ENOENT, std::generic_category()));
+    result<int> c(failure(std::error_code(ENOENT, std::generic_category())));
+    result<int> d(in_place_type<std::error_code>, EACCES, std::generic_category());
+    result<void, c_errc> e(c_errc::failure2);
+    (void) a;
+    (void) b;
+    (void) c;
+    (void) d;
+    (void) e;
+  }
+  auto after = telemetry::snapshot();
+  BOOST_CHECK(after.successes - before.successes == 1);
+  BOOST_CHECK(after.failures - before.failures == 4);
+  BOOST_CHECK(after.constructions() - before.constructions() == 5);
+  BOOST_CHECK(count_of(after, generic, ENOENT) - count_of(before, generic, ENOENT) == 2);
+  BOOST_CHECK(count_of(after, generic, EACCES) - count_of(before, generic, EACCES) == 1);
+  BOOST_CHECK(count_of(after, &telemetry::detail::type_identity<c_errc>::id, static_cast<intptr_t>(c_errc::failure2)) - count_of(before, &telemetry::detail::type_identity<c_errc>::id, static_cast<intptr_t>(c_errc::failure2)) == 1);
+  for(auto &i : after.by_error)
+  {
+    if(i.key.category == generic)
+    {
+      BOOST_CHECK(0 == strcmp(i.category_name(), std::generic_category().name()));
+    }
+  }
+
+  // Conversions from result to outcome are counted as conversions, not as new failures
+  before = after;
+  {
+    result<int> a(std::error_code(EINVAL, std::generic_category()));
+    outcome<int> b(a);
+    outcome<long> c(outcome<int>(5));
+    (void) b;
+    (void) c;
+  }
+  after = telemetry::snapshot();
+  BOOST_CHECK(after.conversions - before.conversions == 2);
+  BOOST_CHECK(after.failures - before.failures == 1);
+  BOOST_CHECK(after.successes - before.successes == 1);
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / telemetry / threads, "Tests that telemetry aggregates per-thread counts")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  auto before = telemetry::snapshot();
+  std::vector<std::thread> threads;
+  for(int n = 0; n < 4; n++)
+  {
+    threads.emplace_back([] {
+      for(int i = 0; i < 1000; i++)
+      {
+        result<int> r = (i % 10 == 0) ? result<int>(std::error_code(ETIMEDOUT, std::generic_category())) : result<int>(i);
+        (void) r;
+      }
+    });
+  }
+  for(auto &t : threads)
+  {
+    t.join();
+  }
+  auto after = telemetry::snapshot();
+  BOOST_CHECK(after.constructions() - before.constructions() == 4000);
+  BOOST_CHECK(after.failures - before.failures == 400);
+  BOOST_CHECK(after.successes - before.successes == 3600);
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / telemetry / constexpr, "Tests that telemetry does not prevent constant evaluation")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+#if defined(__GNUC__) && __GNUC__ >= 9 || defined(__clang__) && __clang_major__ >= 9
+  constexpr result<int, long, policy::all_narrow> a(in_place_type<int>, 5);
+  static_assert(a.value() == 5, "");
+#endif
+}
@@ -0,0 +1,127 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#define OUTCOME_ENABLE_USDT 1
+
+#include "../../include/outcome/outcome.hpp"
+#include "../../include/outcome/try.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+#if defined(__linux__) && defined(__ELF__)
+#include <elf.h>
+#endif
+
+namespace usdt_test
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+
+  QUICKCPPLIB_NOINLINE inline result<int> fails() { return std::errc::timed_out; }
+  QUICKCPPLIB_NOINLINE inline result<int> propagates()
+  {
+    OUTCOME_TRY(v, fails());
+    return v + 1;
+  }
+  QUICKCPPLIB_NOINLINE inline outcome<int> outcome_fails() { return std::errc::timed_out; }
+
+#if defined(__linux__) && defined(__ELF__)
+  // Returns "provider:name" of every SystemTap SDT note in our own executable
+  inline std::set<std::string> probes_in_this_executable()
+  {
+    std::set<std::string> ret;
+    FILE *f = fopen("/proc/self/exe", "rb");  // NOLINT
+    if(f == nullptr)
+    {
+      return ret;
+    }
+    std::vector<char> image;
+    char buffer[65536];
+    for(size_t n; (n = fread(buffer, 1, sizeof(buffer), f)) > 0;)
+    {
+      image.insert(image.end(), buffer, buffer + n);
+    }
+    fclose(f);  // NOLINT
+    if(image.size() < sizeof(Elf64_Ehdr) || image[EI_CLASS] != ELFCLASS64)
+    {
+      return ret;
+    }
+    Elf64_Ehdr eh;
+    memcpy(&eh, image.data(), sizeof(eh));
+    auto section = [&](size_t idx) {
+      Elf64_Shdr sh;
+      memcpy(&sh, image.data() + eh.e_shoff + idx * eh.e_shentsize, sizeof(sh));
+      return sh;
+    };
+    const Elf64_Shdr strtab = section(eh.e_shstrndx);
+    for(size_t i = 0; i < eh.e_shnum; i++)
+    {
+      const Elf64_Shdr sh = section(i);
+      if(sh.sh_type != SHT_NOTE || strcmp(image.data() + strtab.sh_offset + sh.sh_name, ".note.stapsdt") != 0)
+      {
+        continue;
+      }
+      for(size_t offset = sh.sh_offset; offset + sizeof(Elf64_Nhdr) <= sh.sh_offset + sh.sh_size;)
+      {
+        Elf64_Nhdr nh;
+        memcpy(&nh, image.data() + offset, sizeof(nh));
+        const char *name = image.data() + offset + sizeof(nh);
+        const char *desc = name + ((nh.n_namesz + 3) & ~3U);
+        if(strcmp(name, "stapsdt") == 0)
+        {
+          // Descriptor is three addresses, then provider, probe name and argument format
+          const char *provider = desc + 3 * sizeof(Elf64_Addr);
+          const char *probe = provider + strlen(provider) + 1;
+          ret.insert(std::string(provider) + ":" + probe);
+        }
+        offset = static_cast<size_t>(desc - image.data()) + ((nh.n_descsz + 3) & ~3U);
+      }
+    }
+    return ret;
+  }
+#endif
+}  // namespace usdt_test
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / usdt, "Tests that USDT probes are emitted into the executable and do not change behaviour")
+{
+  using namespace usdt_test;
+  // Probes must not change semantics whether attached or not
+  BOOST_CHECK(fails().error() == std::errc::timed_out);
+  BOOST_CHECK(propagates().error() == std::errc::timed_out);
+  BOOST_CHECK(outcome_fails().error() == std::errc::timed_out);
+  result<int> r(5);
+  BOOST_CHECK(r.value() == 5);
+
+#if OUTCOME_USDT_AVAILABLE && defined(__linux__) && defined(__ELF__)
+  auto probes = probes_in_this_executable();
+  BOOST_CHECK(probes.count("outcome:result_failure") == 1);
+  BOOST_CHECK(probes.count("outcome:outcome_failure") == 1);
+  BOOST_CHECK(probes.count("outcome:try_propagate") == 1);
+#else
+  std::cout << "NOTE: <sys/sdt.h> is not available on this platform, so the presence of probes cannot be tested." << std::endl;
+#endif
+}
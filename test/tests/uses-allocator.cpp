@@ -0,0 +1,224 @@
+/* Unit testing for outcomes
+(C) 2019 Niall Douglas <http://www.nedproductions.biz/> (1 commit)
+
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License in the accompanying file
+Licence.txt or at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+
+Distributed under the Boost Software License, Version 1.0.
+    (See accompanying file Licence.txt or copy at
+          http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#include "../../include/outcome/outcome.hpp"
+#include "../../include/outcome/pmr.hpp"
+#include "quickcpplib/include/boost/test/unit_test.hpp"
+
+#include <string>
+#include <vector>
+
+namespace uses_allocator_test
+{
+  // Only remembers which arena it came from
+  struct arena_allocator
+  {
+    int arena;
+  };
+
+  // Takes its allocator first, after std::allocator_arg, and records the arena it was given
+  struct leading
+  {
+    using allocator_type = arena_allocator;
+    int v{0}, arena{0};
+    explicit leading(int _v)
+        : v(_v)
+    {
+    }
+    leading(std::allocator_arg_t /*unused*/, const arena_allocator &a, int _v)
+        : v(_v)
+        , arena(a.arena)
+    {
+    }
+    leading(const leading &o)
+        : v(o.v)
+    {
+    }
+    leading(std::allocator_arg_t /*unused*/, const arena_allocator &a, const leading &o)
+        : v(o.v)
+        , arena(a.arena)
+    {
+    }
+    leading(leading &&o) noexcept : v(o.v), arena(o.arena) {}
+    leading(std::allocator_arg_t /*unused*/, const arena_allocator &a, leading &&o)
+        : v(o.v)
+        , arena(a.arena)
+    {
+    }
+    leading &operator=(const leading &) = default;
+    leading &operator=(leading &&) = default;
+  };
+
+  // Takes its allocator last
+  struct trailing
+  {
+    using allocator_type = arena_allocator;
+    int v{0}, arena{0};
+    trailing() = default;
+    explicit trailing(int _v, const arena_allocator &a = arena_allocator{0})
+        : v(_v)
+        , arena(a.arena)
+    {
+    }
+    trailing(const trailing &o, const arena_allocator &a = arena_allocator{0})
+        : v(o.v)
+        , arena(a.arena)
+    {
+    }
+    trailing(trailing &&o) noexcept : v(o.v), arena(o.arena) {}
+    trailing(trailing &&o, const arena_allocator &a)
+        : v(o.v)
+        , arena(a.arena)
+    {
+    }
+    trailing &operator=(const trailing &) = default;
+    trailing &operator=(trailing &&) = default;
+  };
+}  // namespace uses_allocator_test
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / result / uses_allocator, "Tests that the allocator extended constructors of result and outcome pass the allocator to the value or error")
+{
+  using namespace OUTCOME_V2_NAMESPACE;
+  using namespace uses_allocator_test;
+  using result_type = basic_result<leading, trailing, policy::all_narrow>;
+  using outcome_type = basic_outcome<leading, trailing, std::exception_ptr, policy::all_narrow>;
+  static_assert(std::uses_allocator<result_type, arena_allocator>::value, "");
+  static_assert(std::uses_allocator<basic_result<int, trailing, policy::all_narrow>, arena_allocator>::value, "");
+  static_assert(!std::uses_allocator<result<int>, arena_allocator>::value, "");
+  static_assert(std::uses_allocator<outcome_type, arena_allocator>::value, "");
+  static_assert(!std::uses_allocator<outcome<int>, arena_allocator>::value, "");
+  const arena_allocator a{1};
+  {
+    // In place, with the allocator leading and trailing
+    result_type r(std::allocator_arg, a, in_place_type<leading>, 5);
+    BOOST_CHECK(r.value().v == 5);
+    BOOST_CHECK(r.value().arena == 1);
+    result_type e(std::allocator_arg, a, in_place_type<trailing>, 6);
+    BOOST_CHECK(e.error().v == 6);
+    BOOST_CHECK(e.error().arena == 1);
+  }
+  {
+    // Copies and moves are given the allocator, and keep the spare storage
+    result_type r(leading(5));
+    hooks::set_spare_storage(&r, 0x55);
+    result_type c(std::allocator_arg, arena_allocator{2}, r);
+    BOOST_CHECK(c.value().v == 5);
+    BOOST_CHECK(c.value().arena == 2);
+    BOOST_CHECK(hooks::spare_storage(&c) == 0x55);
+    result_type m(std::allocator_arg, arena_allocator{3}, std::move(c));
+    BOOST_CHECK(m.value().arena == 3);
+    result_type e(trailing(7));
+    result_type ec(std::allocator_arg, a, e);
+    BOOST_CHECK(ec.error().v == 7);
+    BOOST_CHECK(ec.error().arena == 1);
+    basic_result<void, trailing, policy::all_narrow> ve(trailing(8));
+    basic_result<void, trailing, policy::all_narrow> vc(std::allocator_arg, a, ve);
+    BOOST_CHECK(vc.error().arena == 1);
+  }
+  {
+    // Converting construction, directly and through a temporary
+    result_type r(std::allocator_arg, a, leading(8));
+    BOOST_CHECK(r.value().arena == 1);
+    result_type s(std::allocator_arg, a, success(leading(9)));
+    BOOST_CHECK(s.value().v == 9);
+    BOOST_CHECK(s.value().arena == 1);
+    result_type f(std::allocator_arg, a, failure(trailing(10)));
+    BOOST_CHECK(f.error().v == 10);
+    BOOST_CHECK(f.error().arena == 1);
+  }
+  {
+    // Types which do not use the allocator ignore it
+    result<int> r(std::allocator_arg, a, 5);
+    BOOST_CHECK(r.value() == 5);
+    result<void> v(std::allocator_arg, a, in_place_type<void>);
+    BOOST_CHECK(v.has_value());
+    result<int> c(std::allocator_arg, a, r);
+    BOOST_CHECK(c.value() == 5);
+  }
+  {
+    outcome_type o(std::allocator_arg, a, in_place_type<leading>, 5);
+    BOOST_CHECK(o.value().arena == 1);
+    // An error with an exception keeps both, and only the error is given the allocator
+    outcome_type e(failure_type<trailing, std::exception_ptr>(trailing(6), std::make_exception_ptr(6)));
+    outcome_type ec(std::allocator_arg, arena_allocator{2}, e);
+    BOOST_CHECK(ec.has_error());
+    BOOST_CHECK(ec.has_exception());
+    BOOST_CHECK(ec.error().arena == 2);
+    BOOST_CHECK(ec.exception() == e.exception());
+    outcome_type x(std::make_exception_ptr(7));
+    outcome_type xc(std::allocator_arg, a, std::move(x));
+    BOOST_CHECK(!xc.has_error());
+    BOOST_CHECK(xc.has_exception());
+  }
+}
+
+BOOST_OUTCOME_AUTO_TEST_CASE(works / result / pmr, "Tests that results in a pmr container stay in its memory resource")
+{
+#if defined(__cpp_lib_memory_resource) && __cpp_lib_memory_resource >= 201603L
+  using namespace OUTCOME_V2_NAMESPACE;
+  // Any allocation outside the buffer throws
+  char buffer[4096];
+  std::pmr::monotonic_buffer_resource mr(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+  // Nor may anything be constructed without the allocator first, and then copied into the buffer
+  struct default_resource_guard
+  {
+    std::pmr::memory_resource *old{std::pmr::set_default_resource(std::pmr::null_memory_resource())};
+    ~default_resource_guard() { std::pmr::set_default_resource(old); }
+  } guard;
+  const char *text = "a string too long to fit in the small string optimisation buffer";
+  std::pmr::vector<pmr::result<std::pmr::string>> v(&mr);
+  v.reserve(8);
+  v.emplace_back(text);
+  v.emplace_back(std::errc::invalid_argument);
+  v.emplace_back(in_place_type<std::pmr::string>, 80, 'x');
+  v.push_back(v[0]);
+  v.push_back(pmr::make_in<pmr::result<std::pmr::string>>(&mr, text));
+  v.emplace_back(success(std::string_view(text)));
+  v.emplace_back(failure(make_error_code(std::errc::invalid_argument)));
+  for(auto &r : v)
+  {
+    if(r)
+    {
+      BOOST_CHECK(r.value().get_allocator().resource() == &mr);
+    }
+  }
+  BOOST_CHECK(v[1].error() == std::errc::invalid_argument);
+  BOOST_CHECK(v[3].value() == text);
+  BOOST_CHECK(v[5].value() == text);
+  BOOST_CHECK(v[6].error() == std::errc::invalid_argument);
+
+  std::pmr::vector<pmr::outcome<std::pmr::vector<int>, std::pmr::string>> o(&mr);
+  o.reserve(8);
+  o.emplace_back(in_place_type<std::pmr::vector<int>>, 100, 5);
+  o.emplace_back(failure(std::pmr::string(text, &mr), std::make_exception_ptr(1)));
+  o.push_back(o[1]);
+  o.emplace_back(std::pmr::string(text, &mr), std::make_exception_ptr(2));
+  o.emplace_back(failure(std::string_view(text)));
+  BOOST_CHECK(o[0].value().get_allocator().resource() == &mr);
+  BOOST_CHECK(o[2].error().get_allocator().resource() == &mr);
+  BOOST_CHECK(o[2].has_exception());
+  BOOST_CHECK(o[3].error() == text);
+  BOOST_CHECK(o[3].has_exception());
+  BOOST_CHECK(o[4].error().get_allocator().resource() == &mr);
+#endif
+}